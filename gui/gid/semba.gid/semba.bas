@@ -315,77 +315,249 @@
 *# ----------------------------------------------------------
 *# ----------------- COORDINATES ----------------------------
 *# ----------------------------------------------------------
-    "coordinates": [
+    "coordinates": {
 *set elems(all)
+        "ids": [
 *loop nodes
-*format "%7i %+14.8e %+14.8e %+14.8e"
+*format "%7i"
 *if(npoin != loopVar)
-        "*NodesNum *NodesCoord(1,real) *NodesCoord(2,real) *NodesCoord(3,real)",
+            *NodesNum,
 *else
-        "*NodesNum *NodesCoord(1,real) *NodesCoord(2,real) *NodesCoord(3,real)"
+            *NodesNum
 *endif
 *end nodes
-    ],
+        ],
+        "positions": [
+*loop nodes
+*format "%14.8e %14.8e %14.8e"
+*if(npoin != loopVar)
+            *NodesCoord(1,real), *NodesCoord(2,real), *NodesCoord(3,real),
+*else
+            *NodesCoord(1,real), *NodesCoord(2,real), *NodesCoord(3,real)
+*endif
+*end nodes
+        ]
+    },
 
 *# ----------------------------------------------------------
 *# ------------------- ELEMENTS -----------------------------
 *# ----------------------------------------------------------
     "elements": {
 *set elems(Hexahedra)
-        "hexahedra": [
+        "hexahedra": {
+            "ids": [
 *loop elems
-*format "%8i %3i %3i %7i %7i %7i %7i %7i %7i %7i %7i"
-*if(nelem != loopvar)
-        "*ElemsNum *ElemsMat *ElemsLayerNum *ElemsConec",
+*format "%8i"
+*if(nelem != loopVar)
+                *ElemsNum,
 *else
-        "*ElemsNum *ElemsMat *ElemsLayerNum *ElemsConec"
-*endif        
+                *ElemsNum
+*endif
 *end elems
-        ],
+            ],
+            "materials": [
+*loop elems
+*format "%3i"
+*if(nelem != loopVar)
+                *ElemsMat,
+*else
+                *ElemsMat
+*endif
+*end elems
+            ],
+            "layers": [
+*loop elems
+*format "%3i"
+*if(nelem != loopVar)
+                *ElemsLayerNum,
+*else
+                *ElemsLayerNum
+*endif
+*end elems
+            ],
+            "vertices": [
+*loop elems
+*format "%7i %7i %7i %7i %7i %7i %7i %7i"
+*if(nelem != loopVar)
+                *ElemsConec(1), *ElemsConec(2), *ElemsConec(3), *ElemsConec(4), *ElemsConec(5), *ElemsConec(6), *ElemsConec(7), *ElemsConec(8),
+*else
+                *ElemsConec(1), *ElemsConec(2), *ElemsConec(3), *ElemsConec(4), *ElemsConec(5), *ElemsConec(6), *ElemsConec(7), *ElemsConec(8)
+*endif
+*end elems
+            ]
+        },
 *set elems(Tetrahedra)
-        "tetrahedra": [
+        "tetrahedra": {
+            "ids": [
 *loop elems
-*format "%8i %3i %3i %7i %7i %7i %7i"
-*if(nelem != loopvar)
-        "*ElemsNum *ElemsMat *ElemsLayerNum *ElemsConec(1) *elemsconec(3) *elemsconec(2) *elemsconec(4)",
+*format "%8i"
+*if(nelem != loopVar)
+                *ElemsNum,
 *else
-        "*ElemsNum *ElemsMat *ElemsLayerNum *ElemsConec(1) *elemsconec(3) *elemsconec(2) *elemsconec(4)"
-*endif        
+                *ElemsNum
+*endif
 *end elems
-        ],
+            ],
+            "materials": [
+*loop elems
+*format "%3i"
+*if(nelem != loopVar)
+                *ElemsMat,
+*else
+                *ElemsMat
+*endif
+*end elems
+            ],
+            "layers": [
+*loop elems
+*format "%3i"
+*if(nelem != loopVar)
+                *ElemsLayerNum,
+*else
+                *ElemsLayerNum
+*endif
+*end elems
+            ],
+            "vertices": [
+*loop elems
+*format "%7i %7i %7i %7i"
+*if(nelem != loopVar)
+                *ElemsConec(1), *ElemsConec(3), *ElemsConec(2), *ElemsConec(4),
+*else
+                *ElemsConec(1), *ElemsConec(3), *ElemsConec(2), *ElemsConec(4)
+*endif
+*end elems
+            ]
+        },
 *set elems(Quadrilateral)
-        "quadrilateral": [
+        "quadrilateral": {
+            "ids": [
 *loop elems
-*format "%8i %3i %3i %7i %7i %7i %7i"
-*if(nelem != loopvar)
-        "*ElemsNum *ElemsMat *ElemsLayerNum *ElemsConec(1) *elemsconec(2) *elemsconec(3) *elemsconec(4)",
+*format "%8i"
+*if(nelem != loopVar)
+                *ElemsNum,
 *else
-        "*ElemsNum *ElemsMat *ElemsLayerNum *ElemsConec(1) *elemsconec(2) *elemsconec(3) *elemsconec(4)"
+                *ElemsNum
 *endif
 *end elems
-        ],
+            ],
+            "materials": [
+*loop elems
+*format "%3i"
+*if(nelem != loopVar)
+                *ElemsMat,
+*else
+                *ElemsMat
+*endif
+*end elems
+            ],
+            "layers": [
+*loop elems
+*format "%3i"
+*if(nelem != loopVar)
+                *ElemsLayerNum,
+*else
+                *ElemsLayerNum
+*endif
+*end elems
+            ],
+            "vertices": [
+*loop elems
+*format "%7i %7i %7i %7i"
+*if(nelem != loopVar)
+                *ElemsConec(1), *ElemsConec(2), *ElemsConec(3), *ElemsConec(4),
+*else
+                *ElemsConec(1), *ElemsConec(2), *ElemsConec(3), *ElemsConec(4)
+*endif
+*end elems
+            ]
+        },
 *set elems(Triangle)
-        "triangle": [
+        "triangle": {
+            "ids": [
 *loop elems
-*format "%8i %3i %3i %7i %7i %7i"
-*if(nelem != loopvar)
-        "*ElemsNum *ElemsMat *ElemsLayerNum *ElemsConec(1) *elemsconec(2) *elemsconec(3)",
+*format "%8i"
+*if(nelem != loopVar)
+                *ElemsNum,
 *else
-        "*ElemsNum *ElemsMat *ElemsLayerNum *ElemsConec(1) *elemsconec(2) *elemsconec(3)"
+                *ElemsNum
 *endif
 *end elems
-        ],
+            ],
+            "materials": [
+*loop elems
+*format "%3i"
+*if(nelem != loopVar)
+                *ElemsMat,
+*else
+                *ElemsMat
+*endif
+*end elems
+            ],
+            "layers": [
+*loop elems
+*format "%3i"
+*if(nelem != loopVar)
+                *ElemsLayerNum,
+*else
+                *ElemsLayerNum
+*endif
+*end elems
+            ],
+            "vertices": [
+*loop elems
+*format "%7i %7i %7i"
+*if(nelem != loopVar)
+                *ElemsConec(1), *ElemsConec(2), *ElemsConec(3),
+*else
+                *ElemsConec(1), *ElemsConec(2), *ElemsConec(3)
+*endif
+*end elems
+            ]
+        },
 *set elems(Linear)
-        "line": [
+        "line": {
+            "ids": [
 *loop elems
-*format "%8i %3i %3i %7i %7i"
-*if(nelem != loopvar)
-        "*ElemsNum *ElemsMat *ElemsLayerNum *ElemsConec(1) *ElemsConec(2)",
+*format "%8i"
+*if(nelem != loopVar)
+                *ElemsNum,
 *else
-        "*ElemsNum *ElemsMat *ElemsLayerNum *ElemsConec(1) *ElemsConec(2)"
-*endif        
-*End elems
-        ]
+                *ElemsNum
+*endif
+*end elems
+            ],
+            "materials": [
+*loop elems
+*format "%3i"
+*if(nelem != loopVar)
+                *ElemsMat,
+*else
+                *ElemsMat
+*endif
+*end elems
+            ],
+            "layers": [
+*loop elems
+*format "%3i"
+*if(nelem != loopVar)
+                *ElemsLayerNum,
+*else
+                *ElemsLayerNum
+*endif
+*end elems
+            ],
+            "vertices": [
+*loop elems
+*format "%7i %7i"
+*if(nelem != loopVar)
+                *ElemsConec(1), *ElemsConec(2),
+*else
+                *ElemsConec(1), *ElemsConec(2)
+*endif
+*end elems
+            ]
+        }
     },
 
 *# ----------------------------------------------------------
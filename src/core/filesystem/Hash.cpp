@@ -0,0 +1,95 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#include "Hash.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "MappedFile.h"
+
+namespace SEMBA {
+namespace FileSystem {
+
+namespace {
+
+const std::size_t BlockSize = 1 << 20;
+const std::uint64_t Prime = 0x100000001b3ULL;
+const std::uint64_t Seed  = 0xcbf29ce484222325ULL;
+
+inline std::uint64_t mix(std::uint64_t h, const std::uint64_t word) {
+    h ^= word;
+    h *= Prime;
+    h ^= h >> 29;
+    return h;
+}
+
+// Eight bytes are consumed per step, the tail is padded with zeros and
+// the size is mixed in last so that padding does not collide.
+std::uint64_t hashBlock(const char* data, const std::size_t size) {
+    std::uint64_t h = Seed;
+    std::size_t i = 0;
+    for (; i + sizeof(std::uint64_t) <= size; i += sizeof(std::uint64_t)) {
+        std::uint64_t word;
+        std::memcpy(&word, data + i, sizeof(std::uint64_t));
+        h = mix(h, word);
+    }
+    std::uint64_t word = 0;
+    std::memcpy(&word, data + i, size - i);
+    h = mix(h, word);
+    return mix(h, size);
+}
+
+}
+
+std::uint64_t hash(const char* data, const std::size_t size) {
+    const long long numBlocks = (size + BlockSize - 1) / BlockSize;
+    std::vector<std::uint64_t> blocks(numBlocks);
+#pragma omp parallel for
+    for (long long b = 0; b < numBlocks; b++) {
+        const std::size_t begin = b*BlockSize;
+        const std::size_t end = std::min(size, begin + BlockSize);
+        blocks[b] = hashBlock(data + begin, end - begin);
+    }
+    std::uint64_t h = Seed;
+    for (std::size_t b = 0; b < blocks.size(); b++) {
+        h = mix(h, blocks[b]);
+    }
+    return mix(h, size);
+}
+
+std::uint64_t hashFile(const std::string& filename) {
+    const MappedFile file(filename);
+    return hash(file.data(), file.size());
+}
+
+std::string hashToStr(const std::uint64_t value) {
+    static const char digits[] = "0123456789abcdef";
+    std::string res(2*sizeof(std::uint64_t), '0');
+    for (std::size_t i = 0; i < res.size(); i++) {
+        res[res.size()-1-i] = digits[(value >> (4*i)) & 0xf];
+    }
+    return res;
+}
+
+} /* namespace FileSystem */
+} /* namespace SEMBA */
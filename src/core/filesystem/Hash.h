@@ -0,0 +1,47 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SEMBA_FILESYSTEM_HASH_H_
+#define SEMBA_FILESYSTEM_HASH_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace SEMBA {
+namespace FileSystem {
+
+// Non cryptographic 64 bit hash of the contents of a buffer, used to notice
+// changed inputs. Blocks of the buffer are hashed concurrently, the result
+// does not depend on the number of threads.
+std::uint64_t hash(const char* data, const std::size_t size);
+
+// Hash of the contents of a file. Throws std::logic_error if the file can
+// not be read.
+std::uint64_t hashFile(const std::string& filename);
+
+// Sixteen hexadecimal digits of a hash, usable as a file name.
+std::string hashToStr(const std::uint64_t value);
+
+} /* namespace FileSystem */
+} /* namespace SEMBA */
+
+#endif /* SEMBA_FILESYSTEM_HASH_H_ */
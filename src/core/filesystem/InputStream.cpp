@@ -0,0 +1,355 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#include "InputStream.h"
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#ifdef OPENSEMBA_USE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef OPENSEMBA_USE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace SEMBA {
+namespace FileSystem {
+
+namespace {
+
+// Stream buffer filled by a thread which decompresses the file into a queue
+// of blocks. The thread waits while the queue is full, so memory use does
+// not depend on the size of the file.
+class DecompressingBuffer : public std::streambuf {
+public:
+    DecompressingBuffer(const std::string& filename,
+                        const InputStream::Compression compression)
+    :   filename_(filename),
+        compression_(compression) {
+        start_();
+    }
+
+    virtual ~DecompressingBuffer() {
+        stop_();
+    }
+
+protected:
+    int_type underflow() {
+        if (gptr() < egptr()) {
+            return traits_type::to_int_type(*gptr());
+        }
+        consumed_ += current_.size();
+        current_.clear();
+        std::unique_lock<std::mutex> lock(mutex_);
+        ready_.wait(lock, [this] { return !blocks_.empty() || finished_; });
+        if (blocks_.empty()) {
+            setg(nullptr, nullptr, nullptr);
+            if (error_) {
+                std::rethrow_exception(error_);
+            }
+            return traits_type::eof();
+        }
+        current_.swap(blocks_.front());
+        blocks_.pop_front();
+        lock.unlock();
+        ready_.notify_all();
+        setg(current_.data(), current_.data(),
+             current_.data() + current_.size());
+        return traits_type::to_int_type(*gptr());
+    }
+
+    pos_type seekoff(off_type off, std::ios_base::seekdir dir,
+                     std::ios_base::openmode) {
+        if (dir == std::ios_base::cur && off == 0) {
+            return pos_type(consumed_ + (gptr() - eback()));
+        }
+        if (dir == std::ios_base::beg && off == 0) {
+            stop_();
+            start_();
+            return pos_type(0);
+        }
+        return pos_type(off_type(-1));
+    }
+
+    pos_type seekpos(pos_type pos, std::ios_base::openmode which) {
+        return seekoff(off_type(pos), std::ios_base::beg, which);
+    }
+
+private:
+    static const std::size_t blockSize = 1 << 18;
+    static const std::size_t maxBlocks = 4;
+
+    std::string filename_;
+    InputStream::Compression compression_;
+
+    std::thread producer_;
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    std::deque<std::vector<char>> blocks_;
+    bool finished_;
+    bool stopped_;
+    std::exception_ptr error_;
+
+    std::vector<char> current_;
+    off_type consumed_;
+
+    void start_() {
+        blocks_.clear();
+        finished_ = false;
+        stopped_ = false;
+        error_ = nullptr;
+        current_.clear();
+        consumed_ = 0;
+        setg(nullptr, nullptr, nullptr);
+        producer_ = std::thread(&DecompressingBuffer::produce_, this);
+    }
+
+    void stop_() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopped_ = true;
+        }
+        ready_.notify_all();
+        if (producer_.joinable()) {
+            producer_.join();
+        }
+    }
+
+    void produce_() {
+        try {
+            std::ifstream file(filename_.c_str(),
+                               std::ios::in | std::ios::binary);
+            if (!file.is_open()) {
+                throw std::logic_error("Can not open file: " + filename_);
+            }
+            if (compression_ == InputStream::Compression::gzip) {
+                inflateGzip_(file);
+            } else {
+                inflateZstd_(file);
+            }
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            error_ = std::current_exception();
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            finished_ = true;
+        }
+        ready_.notify_all();
+    }
+
+    // Queues a block for the reader. Returns false if the reader has
+    // stopped and no more blocks are needed.
+    bool push_(std::vector<char>& block) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        ready_.wait(lock, [this] {
+            return stopped_ || blocks_.size() < maxBlocks;
+        });
+        if (stopped_) {
+            return false;
+        }
+        blocks_.push_back(std::vector<char>());
+        blocks_.back().swap(block);
+        lock.unlock();
+        ready_.notify_all();
+        return true;
+    }
+
+    void inflateGzip_(std::istream& file) {
+#ifdef OPENSEMBA_USE_ZLIB
+        z_stream zs = z_stream();
+        // Accepts both gzip and zlib headers.
+        if (inflateInit2(&zs, 15 + 32) != Z_OK) {
+            throw std::logic_error("Can not initialize decompression of: " +
+                                   filename_);
+        }
+        struct Guard {
+            z_stream& zs;
+            ~Guard() { inflateEnd(&zs); }
+        } guard = { zs };
+
+        std::vector<char> in(blockSize);
+        bool ended = false;
+        bool pending = false;
+        while (true) {
+            if (zs.avail_in == 0 && !pending) {
+                file.read(in.data(), in.size());
+                zs.next_in = reinterpret_cast<Bytef*>(in.data());
+                zs.avail_in = static_cast<uInt>(file.gcount());
+                if (zs.avail_in == 0) {
+                    break;
+                }
+            }
+            if (ended) {
+                // Concatenated gzip members form a single stream.
+                inflateReset(&zs);
+                ended = false;
+            }
+            std::vector<char> out(blockSize);
+            zs.next_out = reinterpret_cast<Bytef*>(out.data());
+            zs.avail_out = static_cast<uInt>(out.size());
+            const int ret = inflate(&zs, Z_NO_FLUSH);
+            if (ret == Z_STREAM_END) {
+                ended = true;
+            } else if (ret != Z_OK && ret != Z_BUF_ERROR) {
+                throw std::logic_error("Corrupt compressed file: " +
+                                       filename_);
+            }
+            pending = !ended && zs.avail_out == 0;
+            out.resize(out.size() - zs.avail_out);
+            if (!out.empty() && !push_(out)) {
+                return;
+            }
+        }
+        if (!ended) {
+            throw std::logic_error("Truncated compressed file: " +
+                                   filename_);
+        }
+#else
+        (void) file;
+        throw std::logic_error(
+                "gzip input is not supported in this build: " + filename_);
+#endif
+    }
+
+    void inflateZstd_(std::istream& file) {
+#ifdef OPENSEMBA_USE_ZSTD
+        ZSTD_DStream* zs = ZSTD_createDStream();
+        if (zs == nullptr || ZSTD_isError(ZSTD_initDStream(zs))) {
+            ZSTD_freeDStream(zs);
+            throw std::logic_error("Can not initialize decompression of: " +
+                                   filename_);
+        }
+        struct Guard {
+            ZSTD_DStream* zs;
+            ~Guard() { ZSTD_freeDStream(zs); }
+        } guard = { zs };
+
+        std::vector<char> in(blockSize);
+        ZSTD_inBuffer input = { in.data(), 0, 0 };
+        std::size_t hint = 1;
+        bool pending = false;
+        while (true) {
+            if (input.pos == input.size && !pending) {
+                file.read(in.data(), in.size());
+                input.size = static_cast<std::size_t>(file.gcount());
+                input.pos = 0;
+                if (input.size == 0) {
+                    break;
+                }
+            }
+            std::vector<char> out(blockSize);
+            ZSTD_outBuffer output = { out.data(), out.size(), 0 };
+            hint = ZSTD_decompressStream(zs, &output, &input);
+            if (ZSTD_isError(hint)) {
+                throw std::logic_error("Corrupt compressed file: " +
+                                       filename_ + ": " +
+                                       ZSTD_getErrorName(hint));
+            }
+            pending = output.pos == output.size;
+            out.resize(output.pos);
+            if (!out.empty() && !push_(out)) {
+                return;
+            }
+        }
+        if (hint != 0) {
+            throw std::logic_error("Truncated compressed file: " +
+                                   filename_);
+        }
+#else
+        (void) file;
+        throw std::logic_error(
+                "zstd input is not supported in this build: " + filename_);
+#endif
+    }
+};
+
+} /* namespace */
+
+InputStream::InputStream(const std::string& filename)
+:   std::istream(nullptr),
+    compression_(Compression::none) {
+    char magic[4];
+    std::size_t size = 0;
+    {
+        std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+        file.read(magic, sizeof(magic));
+        size = static_cast<std::size_t>(file.gcount());
+    }
+    compression_ = getCompression(magic, size);
+    if (compression_ == Compression::none) {
+        std::filebuf* file = new std::filebuf();
+        buffer_.reset(file);
+        file->open(filename.c_str(), std::ios::in);
+    } else {
+        buffer_.reset(new DecompressingBuffer(filename, compression_));
+    }
+    rdbuf(buffer_.get());
+    if (!is_open()) {
+        setstate(std::ios::failbit);
+    }
+    if (compression_ != Compression::none) {
+        // Errors found while decompressing are reported to the reader.
+        exceptions(std::ios::badbit);
+    }
+}
+
+InputStream::~InputStream() {
+}
+
+bool InputStream::is_open() const {
+    if (compression_ != Compression::none) {
+        return true;
+    }
+    return static_cast<const std::filebuf*>(buffer_.get())->is_open();
+}
+
+InputStream::Compression InputStream::getCompression(const char* data,
+                                                     const std::size_t size) {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+    if (size >= 2 && bytes[0] == 0x1f && bytes[1] == 0x8b) {
+        return Compression::gzip;
+    }
+    if (size >= 4 && bytes[0] == 0x28 && bytes[1] == 0xb5 &&
+                     bytes[2] == 0x2f && bytes[3] == 0xfd) {
+        return Compression::zstd;
+    }
+    return Compression::none;
+}
+
+bool InputStream::isCompressed(const std::string& filename) {
+    char magic[4];
+    std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+    file.read(magic, sizeof(magic));
+    return getCompression(magic, static_cast<std::size_t>(file.gcount())) !=
+           Compression::none;
+}
+
+} /* namespace FileSystem */
+} /* namespace SEMBA */
@@ -0,0 +1,68 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SEMBA_FILESYSTEM_INPUTSTREAM_H_
+#define SEMBA_FILESYSTEM_INPUTSTREAM_H_
+
+#include <cstddef>
+#include <istream>
+#include <memory>
+#include <streambuf>
+#include <string>
+
+namespace SEMBA {
+namespace FileSystem {
+
+// Input file stream which transparently decompresses gzip and zstd files.
+// The compression is detected from the leading bytes of the file, other
+// files are read as with std::ifstream. Compressed files are decompressed
+// in a separate thread which keeps a bounded number of blocks ahead of the
+// reader. Only rewinding to the beginning is supported when seeking.
+class InputStream : public std::istream {
+public:
+    enum class Compression {
+        none,
+        gzip,
+        zstd
+    };
+
+    InputStream(const std::string& filename);
+    virtual ~InputStream();
+
+    bool is_open() const;
+    Compression getCompression() const { return compression_; }
+
+    static Compression getCompression(const char* data,
+                                      const std::size_t size);
+    static bool isCompressed(const std::string& filename);
+
+private:
+    Compression compression_;
+    std::unique_ptr<std::streambuf> buffer_;
+
+    InputStream(const InputStream&);
+    InputStream& operator=(const InputStream&);
+};
+
+} /* namespace FileSystem */
+} /* namespace SEMBA */
+
+#endif /* SEMBA_FILESYSTEM_INPUTSTREAM_H_ */
@@ -0,0 +1,84 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#include "MappedFile.h"
+
+#include <fstream>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace SEMBA {
+namespace FileSystem {
+
+MappedFile::MappedFile(const std::string& filename)
+:   data_(nullptr),
+    size_(0),
+    mapped_(false) {
+#ifndef _WIN32
+    const int fd = open(filename.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            void* map = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE,
+                             fd, 0);
+            if (map != MAP_FAILED) {
+                data_ = static_cast<const char*>(map);
+                size_ = st.st_size;
+                mapped_ = true;
+            }
+        }
+        close(fd);
+        if (mapped_) {
+            return;
+        }
+    }
+#endif
+    std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+    if (!file.is_open()) {
+        throw std::logic_error("Can not open file: " + filename);
+    }
+    file.seekg(0, std::ios::end);
+    buffer_.resize(static_cast<std::size_t>(file.tellg()));
+    file.seekg(0, std::ios::beg);
+    file.read(buffer_.data(), buffer_.size());
+    if (!file) {
+        throw std::logic_error("Error reading file: " + filename);
+    }
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+}
+
+MappedFile::~MappedFile() {
+#ifndef _WIN32
+    if (mapped_) {
+        munmap(const_cast<char*>(data_), size_);
+    }
+#endif
+}
+
+} /* namespace FileSystem */
+} /* namespace SEMBA */
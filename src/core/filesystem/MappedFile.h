@@ -0,0 +1,54 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SEMBA_FILESYSTEM_MAPPEDFILE_H_
+#define SEMBA_FILESYSTEM_MAPPEDFILE_H_
+
+#include <string>
+#include <vector>
+
+namespace SEMBA {
+namespace FileSystem {
+
+// Read only view of the whole contents of a file. The file is memory mapped
+// where the platform allows it and read into memory otherwise.
+class MappedFile {
+public:
+    MappedFile(const std::string& filename);
+    virtual ~MappedFile();
+
+    const char* data() const { return data_; }
+    std::size_t size() const { return size_; }
+
+private:
+    const char* data_;
+    std::size_t size_;
+    bool mapped_;
+    std::vector<char> buffer_;
+
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+};
+
+} /* namespace FileSystem */
+} /* namespace SEMBA */
+
+#endif /* SEMBA_FILESYSTEM_MAPPEDFILE_H_ */
@@ -0,0 +1,79 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#include "Grid.h"
+
+// Batched grid operations which run concurrently. They are compiled here,
+// with the OpenMP flags of the geometry library, instead of in every user
+// of Grid.h.
+
+namespace SEMBA {
+namespace Geometry {
+
+template<std::size_t D>
+std::vector< Math::Vector::Cartesian<Math::Real,D> > Grid<D>::getPos(
+        const std::vector<CVecID>& ijk) const {
+    std::vector<CVecRD> res(ijk.size());
+    const long int n = ijk.size();
+#pragma omp parallel for schedule(static)
+    for (long int i = 0; i < n; i++) {
+        for (std::size_t d = 0; d < D; d++) {
+            res[i](d) = pos_[d][ijk[i](d)];
+        }
+    }
+    return res;
+}
+
+template<std::size_t D>
+std::vector<std::pair<Math::Vector::Cartesian<Math::Int,D>,
+                      Math::Vector::Cartesian<Math::Real,D>>>
+        Grid<D>::getCellPairs(const std::vector<CVecRD>& pos,
+                              const bool approx,
+                              const Math::Real tol,
+                              std::vector<bool>* err) const {
+    std::vector<std::pair<CVecID, CVecRD>> res(pos.size());
+    std::vector<char> errAux(err != nullptr? pos.size() : 0, false);
+    const long int n = pos.size();
+#pragma omp parallel for schedule(static)
+    for (long int i = 0; i < n; i++) {
+        bool pointErr = false;
+        res[i] = getCellPair(pos[i], approx, tol, &pointErr);
+        if (err != nullptr) {
+            errAux[i] = pointErr;
+        }
+    }
+    if (err != nullptr) {
+        err->assign(errAux.begin(), errAux.end());
+    }
+    return res;
+}
+
+
+template std::vector<Math::CVecR3> Grid<3>::getPos(
+        const std::vector<Math::CVecI3>&) const;
+template std::vector<std::pair<Math::CVecI3, Math::CVecR3>>
+        Grid<3>::getCellPairs(const std::vector<Math::CVecR3>&,
+                              const bool,
+                              const Math::Real,
+                              std::vector<bool>*) const;
+
+} /* namespace Geometry */
+} /* namespace SEMBA */
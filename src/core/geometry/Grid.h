@@ -81,9 +81,9 @@ public:
             long int& i,
             Math::Real& relativeLen) const;
 
-    std::vector<Math::Real> getStep(const std::size_t dir) const;
-    Math::Real              getStep(const std::size_t dir,
-                                    const Math::Int& n) const;
+    const std::vector<Math::Real>& getStep(const std::size_t dir) const;
+    Math::Real                     getStep(const std::size_t dir,
+                                           const Math::Int& n) const;
 
     Math::Real getMinimumSpaceStep() const;
 
@@ -98,12 +98,16 @@ public:
                                           const Math::Real min,
                                           const Math::Real max) const;
 
-    std::vector<CVecRD>     getPos() const;
-    std::vector<Math::Real> getPos(const std::size_t dir) const;
-    Math::Real              getPos(const std::size_t dir,
-                                   const Math::Int i) const;
-    CVecRD                  getPos(const CVecID& ijk) const;
-    CVecRD                  getPos(const CVecRD& ijk) const { return ijk; }
+    std::vector<CVecRD>            getPos() const;
+    const std::vector<Math::Real>& getPos(const std::size_t dir) const;
+    Math::Real                     getPos(const std::size_t dir,
+                                          const Math::Int i) const;
+    CVecRD                         getPos(const CVecID& ijk) const;
+    CVecRD getPos(const CVecRD& ijk) const { return ijk; }
+    // Batched version of getPos(ijk), positions are read concurrently.
+    // Defined in Grid.cpp, which is built with OpenMP.
+    std::vector<CVecRD>            getPos(
+            const std::vector<CVecID>& ijk) const;
 
     std::pair<Math::Int, Math::Real> getCellPair(
             const std::size_t       dir,
@@ -116,6 +120,14 @@ public:
             const bool approx = true,
             const Math::Real tol = tolerance,
             bool* err = nullptr) const;
+    // Batched version of getCellPair. Points are located concurrently,
+    // err (if given) is resized and filled with the per point error flag.
+    // Defined in Grid.cpp, which is built with OpenMP.
+    std::vector<std::pair<CVecID, CVecRD>> getCellPairs(
+            const std::vector<CVecRD>& pos,
+            const bool approx = true,
+            const Math::Real tol = tolerance,
+            std::vector<bool>* err = nullptr) const;
 
     Math::CVecI3Fractional getCVecI3Fractional (const CVecRD& xyz,
                                                 bool& err) const;
@@ -145,6 +157,17 @@ public:
 
 private:
     std::vector<Math::Real> pos_[D];
+
+    // Cached from pos_ by updateSteps_ every time positions change.
+    std::vector<Math::Real> step_[D];
+    bool                    regular_[D];
+    Math::Real              maxStep_[D];
+
+    void updateSteps_();
+    std::size_t getLowerBound_(const std::size_t dir,
+                               const Math::Real x) const;
+    std::size_t getUpperBound_(const std::size_t dir,
+                               const Math::Real x) const;
 };
 
 typedef Grid<3> Grid3;
@@ -31,7 +31,7 @@ const Math::Real Grid<D>::tolerance = 1e-2;
 
 template<std::size_t D>
 Grid<D>::Grid() {
-
+    updateSteps_();
 }
 
 template<std::size_t D>
@@ -55,6 +55,7 @@ Grid<D>::Grid(const BoxRD& box,
             pos_[i][j] = origin(i) + j * dxyz(i);
         }
     }
+    updateSteps_();
 }
 
 template<std::size_t D>
@@ -70,6 +71,7 @@ Grid<D>::Grid(const BoxRD &boundingBox,
             pos_[i][j] = origin(i) + j * step;
         }
     }
+    updateSteps_();
 }
 
 template<std::size_t D>
@@ -77,6 +79,7 @@ Grid<D>::Grid(const std::vector<Math::Real> pos[D]) {
     for(std::size_t d = 0; d < D; d++) {
         pos_[d] = pos[d];
     }
+    updateSteps_();
 }
 
 
@@ -84,6 +87,9 @@ template<std::size_t D>
 Grid<D>::Grid(const Grid<D>& grid) {
     for (std::size_t i = 0; i < D; i++) {
         pos_[i] = grid.pos_[i];
+        step_[i] = grid.step_[i];
+        regular_[i] = grid.regular_[i];
+        maxStep_[i] = grid.maxStep_[i];
     }
 }
 
@@ -99,6 +105,9 @@ Grid<D>& Grid<D>::operator=(const Grid<D>& rhs) {
     }
     for (std::size_t i = 0; i < D; i++) {
         pos_[i] = rhs.pos_[i];
+        step_[i] = rhs.step_[i];
+        regular_[i] = rhs.regular_[i];
+        maxStep_[i] = rhs.maxStep_[i];
     }
     return *this;
 }
@@ -115,6 +124,7 @@ void Grid<D>::setPos(const std::vector<Math::Real> pos[D]) {
             pos_[d].push_back(pos_[d][0]);
         }
     }
+    updateSteps_();
 }
 
 template<std::size_t D>
@@ -139,6 +149,7 @@ void Grid<D>::setAdditionalSteps(
         newPos.insert(newPos.end(), pos_[d].begin(), pos_[d].end());
         pos_[d] = newPos;
     }
+    updateSteps_();
 }
 
 template<std::size_t D>
@@ -152,7 +163,7 @@ bool Grid<D>::hasZeroSize() const {
 
 template<std::size_t D>
 bool Grid<D>::isInto(const std::size_t dir, const Math::Real pos) const {
-    if (pos >= getPos(dir)[0] && pos <= getPos(dir).back()) {
+    if (pos >= pos_[dir].front() && pos <= pos_[dir].back()) {
         return true;
     }
     return false;
@@ -173,11 +184,9 @@ bool Grid<D>::getNaturalCell(
         i = getNumCells()(dir);
         return false;
     }
-    while (getPos(dir)[n] <=x ){
-        n++;
-    }  /*mod this: use sort*/
+    n = getUpperBound_(dir, x);
     i = n-1;
-    relativeLen = (x - getPos(dir)[i])/
+    relativeLen = (x - pos_[dir][i])/
                   getStep(dir,i);
     return true;
 }
@@ -204,20 +213,14 @@ bool Grid<D>::isRegular() const {
 
 template<std::size_t D>
 bool Grid<D>::isRegular(const std::size_t d) const {
-    std::vector<Math::Real> step = getStep(d);
-    for (std::size_t n = 1; n < step.size(); n++) {
-        if (Math::Util::notEqual(step[n], step[0], step[0], tolerance)) {
-            return false;
-        }
-    }
-    return true;
+    return regular_[d];
 }
 
 template<std::size_t D>
 bool Grid<D>::isCartesian() const {
-    Math::Real canon = getStep(Math::Constants::x)[0];
+    Math::Real canon = step_[Math::Constants::x][0];
     for (std::size_t i = 0; i < D; i++) {
-        std::vector<Math::Real> step = getStep(i);
+        const std::vector<Math::Real>& step = step_[i];
         for (std::size_t n = 1; n < step.size(); n++) {
             if (Math::Util::notEqual(step[n], canon, canon, tolerance)) {
                 return false;
@@ -248,7 +251,7 @@ template<std::size_t D>
 Math::Vector::Cartesian<Math::Int,D> Grid<D>::getNumCells() const {
     CVecID res;
     for (std::size_t d = 0; d < D; d++) {
-        res(d) = getPos(d).size() - 1; // Minimum size of pos is 2.
+        res(d) = pos_[d].size() - 1; // Minimum size of pos is 2.
     }
     return res;
 }
@@ -271,16 +274,9 @@ Math::Vector::Cartesian<Math::Real,D> Grid<D>::getOrigin() const {
 }
 
 template<std::size_t D>
-std::vector<Math::Real> Grid<D>::getStep(const std::size_t dir) const {
+const std::vector<Math::Real>& Grid<D>::getStep(const std::size_t dir) const {
     assert(dir >= 0 && dir < D);
-    if (pos_[dir].size() == 0) {
-        return std::vector<Math::Real>();
-    }
-    std::vector<Math::Real> res(pos_[dir].size()-1);
-    for (std::size_t i = 0; i < pos_[dir].size()-1; i++) {
-        res[i] = pos_[dir][i+1] - pos_[dir][i];
-    }
-    return res;
+    return step_[dir];
 }
 
 
@@ -301,7 +297,7 @@ template<std::size_t D>
 Math::Real Grid<D>::getMinimumSpaceStep() const {
     Math::Real minStep = std::numeric_limits<Math::Real>::infinity();
     for (std::size_t i = 0; i < D; i++) {
-        std::vector<Math::Real> step = getStep(i);
+        const std::vector<Math::Real>& step = step_[i];
         for (std::size_t n = 0; n < step.size(); n++) {
             if (step[n] < minStep) {
                 minStep = step[n];
@@ -386,8 +382,8 @@ template<std::size_t D>
 std::vector<Math::Real> Grid<D>::getPosInRange(const std::size_t dir,
         const Math::Real min,
         const Math::Real max) const {
-    std::vector<Math::Real> pos   = getPos (dir);
-    std::vector<Math::Real> steps = getStep(dir);
+    const std::vector<Math::Real>& pos   = pos_ [dir];
+    const std::vector<Math::Real>& steps = step_[dir];
     std::vector<Math::Real> res;
     res.reserve(pos.size());
     for (std::size_t i = 0; i < pos.size(); i++) {
@@ -427,7 +423,8 @@ std::vector< Math::Vector::Cartesian<Math::Real,D> > Grid<D>::getPos() const {
 }
 
 template<std::size_t D>
-std::vector<Math::Real> Grid<D>::getPos(const std::size_t direction) const {
+const std::vector<Math::Real>& Grid<D>::getPos(
+        const std::size_t direction) const {
     assert(direction >= 0 && direction < D);
     return pos_[direction];
 };
@@ -459,8 +456,8 @@ std::pair<Math::Int, Math::Real> Grid<D>::getCellPair(const std::size_t dir,
 
     Math::Int  cell;
     Math::Real dist;
-    std::vector<Math::Real> pos   = getPos (dir);
-    std::vector<Math::Real> steps = getStep(dir);
+    const std::vector<Math::Real>& pos   = pos_ [dir];
+    const std::vector<Math::Real>& steps = step_[dir];
     assert(pos_[dir].size() >= 1);
     // Checks if it is below the grid.
     if (Math::Util::lower(x, pos[0], steps[0], tol)) {
@@ -471,34 +468,37 @@ std::pair<Math::Int, Math::Real> Grid<D>::getCellPair(const std::size_t dir,
         }
         return std::make_pair(cell, dist);
     }
-    for(std::size_t i = 0; i < pos.size(); i++) {
+    // Looks for the first position which is equal or greater than x, this
+    // is the same position a linear sweep of the positions would stop at.
+    // Positions before it may still be equal to x within their own step
+    // tolerance, the lowest one of them is the one the sweep would find.
+    std::size_t i = getLowerBound_(dir, x);
+    const Math::Real reach = tol*maxStep_[dir] + 2.0*Math::Util::epsilon;
+    for (std::size_t j = i; (j > 0) && (x - pos[j-1] <= reach); j--) {
+        if (Math::Util::equal(x, pos[j-1],
+                              steps[std::max<std::size_t>(j,2)-2], tol)) {
+            i = j-1;
+        }
+    }
+    if (i < pos.size()) {
         Math::Real step;
         if (i == 0) {
             step = steps.front();
-        } else if (i <= steps.size()) {
-            step = steps[i-1];
         } else {
-            step = steps.back();
+            step = steps[i-1];
         }
         if (Math::Util::equal(x, pos[i], step, tol)) {
             cell = i;
             dist = 0.0;
-            if (err != nullptr) {
-                *err = false;
-            }
-            return std::make_pair(cell, dist);
-        } else if (Math::Util::lower(x, pos[i], step, tol)) {
-            cell = i - 1;
-            dist = (x - pos[i-1])/step;
-            if(Math::Util::equal(Math::Util::round(dist),1.0) && approx) {
-                cell++;
-                dist -= 1.0;
-            }
-            if (err != nullptr) {
-                *err = false;
-            }
             return std::make_pair(cell, dist);
         }
+        cell = i - 1;
+        dist = (x - pos[i-1])/step;
+        if(Math::Util::equal(Math::Util::round(dist),1.0) && approx) {
+            cell++;
+            dist -= 1.0;
+        }
+        return std::make_pair(cell, dist);
     }
     cell = getNumCells()(dir);
     dist = (x - pos.back())/steps.back();
@@ -559,10 +559,7 @@ Math::CVecI3Fractional Grid<D>::getCVecI3Fractional (const CVecRD& xyz,
                     break;
                 }
             }else{
-                long int n = 0;
-                while(pos_[dir][n] <= xyz(dir)){
-                    ++n;
-                }
+                long int n = getUpperBound_(dir, xyz(dir));
                 ijk(dir) = n-1;
                 length(dir) = (xyz(dir)-pos_[dir][ijk(dir)])
                                /getStep(dir,ijk(dir));
@@ -596,6 +593,7 @@ void Grid<D>::applyScalingFactor(const Math::Real factor) {
             pos_[d][i] *= factor;
         }
     }
+    updateSteps_();
 }
 
 template<std::size_t D>
@@ -689,5 +687,69 @@ void Grid<D>::printInfo() const {
     std::cout << "Max val: " << bound.getMax().toStr() << std::endl;
 }
 
+template<std::size_t D>
+void Grid<D>::updateSteps_() {
+    for (std::size_t d = 0; d < D; d++) {
+        step_[d].clear();
+        regular_[d] = true;
+        maxStep_[d] = 0.0;
+        if (pos_[d].size() < 2) {
+            continue;
+        }
+        step_[d].resize(pos_[d].size()-1);
+        for (std::size_t i = 0; i < step_[d].size(); i++) {
+            step_[d][i] = pos_[d][i+1] - pos_[d][i];
+            maxStep_[d] = std::max(maxStep_[d], std::abs(step_[d][i]));
+        }
+        for (std::size_t n = 1; n < step_[d].size(); n++) {
+            if (Math::Util::notEqual(step_[d][n], step_[d][0],
+                                     step_[d][0], tolerance)) {
+                regular_[d] = false;
+                break;
+            }
+        }
+    }
+}
+
+template<std::size_t D>
+std::size_t Grid<D>::getLowerBound_(const std::size_t dir,
+                                    const Math::Real x) const {
+    // Returns index of the first position which is not lower than x.
+    const std::vector<Math::Real>& pos = pos_[dir];
+    const std::size_t n = pos.size();
+    if (!regular_[dir] || (n < 2) || (step_[dir][0] <= 0.0)) {
+        return std::lower_bound(pos.begin(), pos.end(), x) - pos.begin();
+    }
+    // Regular grids only need an initial guess and a few corrections to
+    // absorb round-off and the tolerance allowed in the step sizes.
+    Math::Real guess = std::ceil((x - pos.front()) / step_[dir][0]);
+    std::size_t i;
+    if (!(guess > 0.0)) {
+        i = 0;
+    } else if (guess >= (Math::Real) n) {
+        i = n;
+    } else {
+        i = (std::size_t) guess;
+    }
+    while ((i > 0) && (pos[i-1] >= x)) {
+        i--;
+    }
+    while ((i < n) && (pos[i] < x)) {
+        i++;
+    }
+    return i;
+}
+
+template<std::size_t D>
+std::size_t Grid<D>::getUpperBound_(const std::size_t dir,
+                                    const Math::Real x) const {
+    // Returns index of the first position which is greater than x.
+    std::size_t i = getLowerBound_(dir, x);
+    while ((i < pos_[dir].size()) && (pos_[dir][i] <= x)) {
+        i++;
+    }
+    return i;
+}
+
 } /* namespace Geometry */
 } /* namespace SEMBA */
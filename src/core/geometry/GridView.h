@@ -0,0 +1,142 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SEMBA_GEOMETRY_GRIDVIEW_H_
+#define SEMBA_GEOMETRY_GRIDVIEW_H_
+
+#include <cstddef>
+#include <iterator>
+#include <utility>
+
+#include "Grid.h"
+
+namespace SEMBA {
+namespace Geometry {
+
+// Lazy view over a range of nodes or cells of a grid. Only the (i,j,k)
+// range is stored, positions, centers and boxes are computed on access so
+// memory use does not depend on the number of visited nodes or cells.
+// Indices run with the last direction fastest, as in Grid::getPos().
+template<std::size_t D>
+class GridView {
+    typedef Box<Math::Real,D> BoxRD;
+    typedef Math::Vector::Cartesian<Math::Real,D> CVecRD;
+    typedef Math::Vector::Cartesian<Math::Int, D> CVecID;
+public:
+    class Iterator {
+    public:
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef CVecID                          value_type;
+        typedef std::ptrdiff_t                  difference_type;
+        typedef const CVecID*                   pointer;
+        typedef CVecID                          reference;
+
+        Iterator() : view_(nullptr), n_(0) {}
+        Iterator(const GridView* view, const std::size_t n)
+        :   view_(view), n_(n) {}
+
+        CVecID operator* () const { return view_->getIJK(n_); }
+        CVecID operator[](const difference_type i) const {
+            return view_->getIJK(n_ + i);
+        }
+
+        Iterator& operator++() { ++n_; return *this; }
+        Iterator& operator--() { --n_; return *this; }
+        Iterator  operator++(int) { Iterator r(*this); ++n_; return r; }
+        Iterator  operator--(int) { Iterator r(*this); --n_; return r; }
+        Iterator& operator+=(const difference_type i) { n_ += i; return *this; }
+        Iterator& operator-=(const difference_type i) { n_ -= i; return *this; }
+        Iterator  operator+ (const difference_type i) const {
+            return Iterator(view_, n_ + i);
+        }
+        Iterator  operator- (const difference_type i) const {
+            return Iterator(view_, n_ - i);
+        }
+        difference_type operator-(const Iterator& rhs) const {
+            return difference_type(n_) - difference_type(rhs.n_);
+        }
+
+        bool operator==(const Iterator& rhs) const { return n_ == rhs.n_; }
+        bool operator!=(const Iterator& rhs) const { return n_ != rhs.n_; }
+        bool operator< (const Iterator& rhs) const { return n_ <  rhs.n_; }
+        bool operator> (const Iterator& rhs) const { return n_ >  rhs.n_; }
+        bool operator<=(const Iterator& rhs) const { return n_ <= rhs.n_; }
+        bool operator>=(const Iterator& rhs) const { return n_ >= rhs.n_; }
+
+        std::size_t getIndex() const { return n_; }
+
+    private:
+        const GridView* view_;
+        std::size_t     n_;
+    };
+
+    GridView(const Grid<D>& grid, const CVecID& min, const CVecID& max);
+
+    static GridView nodes(const Grid<D>& grid);
+    static GridView cells(const Grid<D>& grid);
+    // Cells with all their nodes in the bound, the same cells
+    // Grid::getCenterOfCellsInside returns.
+    static GridView cellsInside(const Grid<D>& grid, const BoxRD& bound);
+    // Cells intersecting the bound, getBox clips them to it as Box::chop.
+    static GridView cellsOverlapping(const Grid<D>& grid, const BoxRD& bound);
+
+    const Grid<D>& getGrid() const { return *grid_; }
+    CVecID getMin() const { return min_; }
+    CVecID getMax() const { return max_; }
+
+    std::size_t size() const;
+    bool empty() const { return size() == 0; }
+
+    CVecID      getIJK  (const std::size_t n) const;
+    std::size_t getIndex(const CVecID& ijk) const;
+    bool        isInto  (const CVecID& ijk) const;
+
+    CVecRD getPos   (const CVecID& ijk) const;
+    CVecRD getCenter(const CVecID& ijk) const;
+    BoxRD  getBox   (const CVecID& ijk) const;
+
+    Iterator begin() const { return Iterator(this, 0); }
+    Iterator end  () const { return Iterator(this, size()); }
+    // Returns the c-th of nChunks contiguous, balanced index ranges.
+    std::pair<Iterator, Iterator> getChunk(const std::size_t c,
+                                           const std::size_t nChunks) const;
+
+    // Calls f(ijk) for every index of the view, in order. It runs serially,
+    // as whether a header loop is parallel would depend on the flags of the
+    // includer; parallel loops split the view with getChunk instead.
+    template<typename F>
+    void forEach(F f) const;
+
+private:
+    const Grid<D>* grid_;
+    CVecID min_, max_;
+    bool   clipped_;
+    BoxRD  clip_;
+};
+
+typedef GridView<3> GridView3;
+
+} /* namespace Geometry */
+} /* namespace SEMBA */
+
+#include "GridView.hpp"
+
+#endif /* SEMBA_GEOMETRY_GRIDVIEW_H_ */
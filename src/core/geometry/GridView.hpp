@@ -0,0 +1,175 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#include "GridView.h"
+
+namespace SEMBA {
+namespace Geometry {
+
+template<std::size_t D>
+GridView<D>::GridView(const Grid<D>& grid,
+                      const CVecID& min,
+                      const CVecID& max)
+:   grid_(&grid),
+    min_(min),
+    max_(max),
+    clipped_(false) {
+
+}
+
+template<std::size_t D>
+GridView<D> GridView<D>::nodes(const Grid<D>& grid) {
+    return GridView(grid, CVecID(0), grid.getNumCells() + 1);
+}
+
+template<std::size_t D>
+GridView<D> GridView<D>::cells(const Grid<D>& grid) {
+    return GridView(grid, CVecID(0), grid.getNumCells());
+}
+
+template<std::size_t D>
+GridView<D> GridView<D>::cellsInside(const Grid<D>& grid,
+                                     const BoxRD& bound) {
+    CVecID min, max;
+    for (std::size_t d = 0; d < D; d++) {
+        const std::vector<Math::Real> pos =
+            grid.getPosInRange(d, bound.getMin()(d), bound.getMax()(d));
+        if (pos.size() < 2) {
+            min(d) = max(d) = 0;
+            continue;
+        }
+        const std::vector<Math::Real>& all = grid.getPos(d);
+        min(d) = std::lower_bound(all.begin(), all.end(), pos.front()) -
+                 all.begin();
+        max(d) = min(d) + pos.size() - 1;
+    }
+    return GridView(grid, min, max);
+}
+
+template<std::size_t D>
+GridView<D> GridView<D>::cellsOverlapping(const Grid<D>& grid,
+                                          const BoxRD& bound) {
+    CVecID min, max;
+    const CVecID numCells = grid.getNumCells();
+    for (std::size_t d = 0; d < D; d++) {
+        const std::vector<Math::Real>& pos = grid.getPos(d);
+        Math::Int lo = std::upper_bound(pos.begin(), pos.end(),
+                                        bound.getMin()(d)) - pos.begin() - 1;
+        Math::Int hi = std::lower_bound(pos.begin(), pos.end(),
+                                        bound.getMax()(d)) - pos.begin();
+        min(d) = std::min(std::max(lo, Math::Int(0)), numCells(d));
+        max(d) = std::max(std::min(hi, numCells(d)), min(d));
+    }
+    GridView res(grid, min, max);
+    res.clipped_ = true;
+    res.clip_ = bound;
+    return res;
+}
+
+template<std::size_t D>
+std::size_t GridView<D>::size() const {
+    std::size_t res = 1;
+    for (std::size_t d = 0; d < D; d++) {
+        if (max_(d) <= min_(d)) {
+            return 0;
+        }
+        res *= max_(d) - min_(d);
+    }
+    return res;
+}
+
+template<std::size_t D>
+Math::Vector::Cartesian<Math::Int,D> GridView<D>::getIJK(
+        const std::size_t n) const {
+    CVecID res;
+    std::size_t rem = n;
+    for (std::size_t d = D; d-- > 0;) {
+        const std::size_t len = max_(d) - min_(d);
+        res(d) = min_(d) + rem % len;
+        rem /= len;
+    }
+    return res;
+}
+
+template<std::size_t D>
+std::size_t GridView<D>::getIndex(const CVecID& ijk) const {
+    std::size_t res = 0;
+    for (std::size_t d = 0; d < D; d++) {
+        res = res * (max_(d) - min_(d)) + (ijk(d) - min_(d));
+    }
+    return res;
+}
+
+template<std::size_t D>
+bool GridView<D>::isInto(const CVecID& ijk) const {
+    for (std::size_t d = 0; d < D; d++) {
+        if (ijk(d) < min_(d) || ijk(d) >= max_(d)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<std::size_t D>
+Math::Vector::Cartesian<Math::Real,D> GridView<D>::getPos(
+        const CVecID& ijk) const {
+    return grid_->getPos(ijk);
+}
+
+template<std::size_t D>
+Math::Vector::Cartesian<Math::Real,D> GridView<D>::getCenter(
+        const CVecID& ijk) const {
+    CVecRD res;
+    for (std::size_t d = 0; d < D; d++) {
+        const std::vector<Math::Real>& pos = grid_->getPos(d);
+        res(d) = (pos[ijk(d)] + pos[ijk(d)+1]) / 2.0;
+    }
+    return res;
+}
+
+template<std::size_t D>
+Box<Math::Real,D> GridView<D>::getBox(const CVecID& ijk) const {
+    BoxRD res(grid_->getPos(ijk), grid_->getPos(ijk + 1));
+    if (clipped_) {
+        return res.intersect(clip_);
+    }
+    return res;
+}
+
+template<std::size_t D>
+std::pair<typename GridView<D>::Iterator, typename GridView<D>::Iterator>
+        GridView<D>::getChunk(const std::size_t c,
+                              const std::size_t nChunks) const {
+    const std::size_t n = size();
+    return std::make_pair(Iterator(this, n *  c    / nChunks),
+                          Iterator(this, n * (c+1) / nChunks));
+}
+
+template<std::size_t D> template<typename F>
+void GridView<D>::forEach(F f) const {
+    const std::size_t n = size();
+    for (std::size_t i = 0; i < n; i++) {
+        f(getIJK(i));
+    }
+}
+
+} /* namespace Geometry */
+} /* namespace SEMBA */
@@ -96,6 +96,9 @@ public:
     void remove(const std::size_t&);
     void remove(const std::vector<std::size_t>&);
 
+    // Moves the i-th coordinate keeping the position index updated.
+    void setPos(const std::size_t i, const Math::CVecR3& newPosition);
+
     void applyScalingFactor(const Math::Real factor);
     
     void printInfo() const;
@@ -257,6 +257,22 @@ void Group<C>::remove(const std::vector<std::size_t>& pos) {
     SEMBA::Group::Identifiable<C,Id>::remove(pos);
 }
 
+template<typename C>
+void Group<C>::setPos(const std::size_t i, const Math::CVecR3& newPosition) {
+    typedef std::multiset<const CoordR3*, CoordComparator>::iterator Iter;
+    CoordR3* coord = this->get(i)->template castTo<CoordR3>();
+    std::pair<Iter, Iter> range = indexUnstr_.equal_range(coord);
+    for (Iter it = range.first; it != range.second; ++it) {
+        if (*it == coord) {
+            indexUnstr_.erase(it);
+            break;
+        }
+    }
+    coord->pos() = newPosition;
+    indexUnstr_.insert(coord);
+    this->touchId(coord->getId());
+}
+
 template<typename C>
 void Group<C>::applyScalingFactor(const Math::Real factor) {
     for(std::size_t i = 0; i < this->size(); i++) {
@@ -265,6 +281,9 @@ void Group<C>::applyScalingFactor(const Math::Real factor) {
             *ptr *= factor;
         }
     }
+    if (this->tracker().isTracking()) {
+        this->touchId(this->getIds());
+    }
 }
 
 template<typename C>
@@ -235,6 +235,9 @@ void Group<E>::setModel(const Model* newMat) {
     for (std::size_t i = 0; i < this->size(); i++) {
         this->get(i)->setModel(newMat);
     }
+    if (this->tracker().isTracking()) {
+        this->touchId(this->getIds());
+    }
 }
 
 template<typename E>
@@ -242,18 +245,23 @@ void Group<E>::setLayer(const Layer* newLay) {
     for (std::size_t i = 0; i < this->size(); i++) {
         this->get(i)->setLayer(newLay);
     }
+    if (this->tracker().isTracking()) {
+        this->touchId(this->getIds());
+    }
 }
 
 template<typename E>
 void Group<E>::setModel(const Id id,
                         const Model* newMat) {
     this->getId(id)->setModel(newMat);
+    this->touchId(id);
 }
 
 template<typename E>
 void Group<E>::setLayer(const Id id,
                         const Layer* newLay) {
     this->getId(id)->setLayer(newLay);
+    this->touchId(id);
 }
 
 template<typename E>
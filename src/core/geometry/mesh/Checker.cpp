@@ -0,0 +1,435 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#include "Checker.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <typeinfo>
+#include <unordered_map>
+#include <utility>
+
+namespace SEMBA {
+namespace Geometry {
+namespace Mesh {
+
+namespace {
+
+// Sorts chunks concurrently and merges them by pairs.
+template<class T>
+void parallelSort(std::vector<T>& v) {
+    const std::size_t nChunks = 64;
+    if (v.size() < 16*nChunks) {
+        std::sort(v.begin(), v.end());
+        return;
+    }
+    std::vector<std::size_t> bound(nChunks+1);
+    for (std::size_t c = 0; c <= nChunks; c++) {
+        bound[c] = v.size() * c / nChunks;
+    }
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (long long c = 0; c < (long long) nChunks; c++) {
+        std::sort(v.begin() + bound[c], v.begin() + bound[c+1]);
+    }
+    for (std::size_t width = 1; width < nChunks; width *= 2) {
+        #pragma omp parallel for schedule(dynamic, 1)
+        for (long long c = 0; c < (long long) nChunks; c += 2*width) {
+            const std::size_t mid = std::min<std::size_t>(c + width, nChunks);
+            const std::size_t end = std::min<std::size_t>(c + 2*width,
+                                                          nChunks);
+            std::inplace_merge(v.begin() + bound[c],
+                               v.begin() + bound[mid],
+                               v.begin() + bound[end]);
+        }
+    }
+}
+
+template<class T>
+Math::CVecR3 getPos(const Coordinate::Coordinate<T,3>* coord) {
+    Math::CVecR3 res;
+    for (std::size_t d = 0; d < 3; d++) {
+        res(d) = (Math::Real) coord->pos()(d);
+    }
+    return res;
+}
+
+// Same orientation as Tetrahedron4::getVolume, positive when d lies below
+// the right handed normal of abc, as tetrahedra are written by GiD.
+Math::Real getSignedVolume(const Math::CVecR3& a, const Math::CVecR3& b,
+                           const Math::CVecR3& c, const Math::CVecR3& d) {
+    return ((a-b) ^ (a-c)).dot(a-d) / 6.0;
+}
+
+// 1 for lines, 2 for surfaces, 3 for volumes and 0 otherwise.
+std::size_t getDimension(const Element::Base* elem) {
+    if (elem->is<Element::LineBase>()) {
+        return 1;
+    } else if (elem->is<Element::SurfaceBase>()) {
+        return 2;
+    } else if (elem->is<Element::VolumeBase>()) {
+        return 3;
+    }
+    return 0;
+}
+
+// Length, area or signed volume of an element of the given dimension,
+// false if it can not be computed. Volumes are positive for the vertex
+// orderings of Tetrahedron4 and of Hexahedron8 built from a box.
+bool getMeasure(Math::Real& res,
+                const std::vector<Math::CVecR3>& v,
+                const std::size_t dimension) {
+    if (dimension == 1 && v.size() >= 2) {
+        Math::Real length = 0.0;
+        for (std::size_t i = 1; i < v.size(); i++) {
+            length += (v[i] - v[i-1]).norm();
+        }
+        res = length;
+        return true;
+    }
+    if (dimension == 2 && v.size() >= 3) {
+        Math::CVecR3 normal;
+        for (std::size_t i = 0; i < v.size(); i++) {
+            normal += v[i] ^ v[(i+1) % v.size()];
+        }
+        res = normal.norm() / 2.0;
+        return true;
+    }
+    if (dimension == 3 && v.size() == 4) {
+        res = getSignedVolume(v[0], v[1], v[2], v[3]);
+        return true;
+    }
+    if (dimension == 3 && v.size() == 8) {
+        static const std::size_t tet[6][2] = {
+            {1,2}, {2,3}, {3,7}, {7,4}, {4,5}, {5,1}
+        };
+        Math::Real volume = 0.0;
+        for (std::size_t t = 0; t < 6; t++) {
+            volume += getSignedVolume(v[0], v[tet[t][1]], v[tet[t][0]], v[6]);
+        }
+        res = volume;
+        return true;
+    }
+    return false;
+}
+
+template<class T>
+std::vector<std::size_t> getSortedIds(const Element::Element<T>* elem) {
+    std::vector<std::size_t> res(elem->numberOfCoordinates());
+    for (std::size_t j = 0; j < res.size(); j++) {
+        res[j] = elem->getV(j)->getId().toInt();
+    }
+    std::sort(res.begin(), res.end());
+    return res;
+}
+
+std::size_t hashIds(const std::vector<std::size_t>& ids) {
+    std::size_t res = 14695981039346656037ULL;
+    for (std::size_t i = 0; i < ids.size(); i++) {
+        res ^= ids[i];
+        res *= 1099511628211ULL;
+    }
+    return res;
+}
+
+bool lessByProblem(const Checker::Issue& lhs, const Checker::Issue& rhs) {
+    return lhs.problem < rhs.problem;
+}
+
+} /* namespace */
+
+Checker::Report::Report()
+:   numberOfElements_(0),
+    numberOfCoordinates_(0) {
+
+}
+
+std::size_t Checker::Report::count(const Problem problem) const {
+    std::size_t res = 0;
+    for (std::size_t i = 0; i < issues_.size(); i++) {
+        if (issues_[i].problem == problem) {
+            res++;
+        }
+    }
+    return res;
+}
+
+void Checker::Report::writeJSON(std::ostream& out) const {
+    out << "{" << std::endl;
+    out << "  \"elements\": " << numberOfElements_ << "," << std::endl;
+    out << "  \"coordinates\": " << numberOfCoordinates_ << "," << std::endl;
+    out << "  \"valid\": " << (isValid()? "true" : "false") << "," << std::endl;
+    out << "  \"count\": {";
+    for (std::size_t p = 0; p < numberOfProblems; p++) {
+        out << (p == 0? "" : ",") << std::endl
+            << "    \"" << toStr(Problem(p)) << "\": " << count(Problem(p));
+    }
+    out << std::endl << "  }," << std::endl;
+    out << "  \"issues\": [";
+    for (std::size_t i = 0; i < issues_.size(); i++) {
+        out << (i == 0? "" : ",") << std::endl
+            << "    {\"problem\": \"" << toStr(issues_[i].problem) << "\", "
+            << "\"id\": " << issues_[i].id << ", "
+            << "\"related\": " << issues_[i].related << "}";
+    }
+    out << std::endl << "  ]" << std::endl;
+    out << "}" << std::endl;
+}
+
+void Checker::Report::printInfo() const {
+    std::cout << "--- Mesh check report ---" << std::endl;
+    std::cout << "Elements: " << numberOfElements_
+              << " Coordinates: " << numberOfCoordinates_ << std::endl;
+    for (std::size_t p = 0; p < numberOfProblems; p++) {
+        std::cout << toStr(Problem(p)) << ": " << count(Problem(p))
+                  << std::endl;
+    }
+}
+
+std::string Checker::Report::toStr(const Problem problem) {
+    switch (problem) {
+    case danglingCoordinate:
+        return "danglingCoordinate";
+    case duplicatedId:
+        return "duplicatedId";
+    case duplicatedConnectivity:
+        return "duplicatedConnectivity";
+    case degenerate:
+        return "degenerate";
+    case inverted:
+        return "inverted";
+    case unusedCoordinate:
+        return "unusedCoordinate";
+    case missingModel:
+        return "missingModel";
+    case missingLayer:
+        return "missingLayer";
+    default:
+        return "unknown";
+    }
+}
+
+Checker::Checker()
+:   checkModels_(false),
+    tolerance_(1e-10) {
+
+}
+
+Checker::Checker(const Models& models)
+:   checkModels_(true),
+    models_(models),
+    tolerance_(1e-10) {
+
+}
+
+Checker::~Checker() {
+
+}
+
+Checker::Report Checker::check(const Unstructured& mesh) const {
+    return check_(mesh.coords(), mesh.elems(), mesh.layers());
+}
+
+Checker::Report Checker::check(const Structured& mesh) const {
+    return check_(mesh.coords(), mesh.elems(), mesh.layers());
+}
+
+template<class T>
+Checker::Report Checker::check_(
+        const Coordinate::Group<Coordinate::Coordinate<T,3>>& cG,
+        const Element::Group<Element::Element<T>>& elems,
+        const Layer::Group<>& layers) const {
+    Report res;
+    const std::size_t nCoords = cG.size();
+    const std::size_t nElems = elems.size();
+    res.numberOfCoordinates_ = nCoords;
+    res.numberOfElements_ = nElems;
+
+    // Coordinates are located by id. Ids are usually consecutive, a direct
+    // table is used unless they are too sparse.
+    const std::size_t none = nCoords;
+    std::size_t maxId = 0;
+    for (std::size_t i = 0; i < nCoords; i++) {
+        maxId = std::max(maxId, cG(i)->getId().toInt());
+    }
+    std::vector<std::size_t> table;
+    std::unordered_map<std::size_t, std::size_t> map;
+    const bool useTable = (maxId <= 4*nCoords + 1024);
+    if (useTable) {
+        table.assign(maxId+1, none);
+        for (std::size_t i = 0; i < nCoords; i++) {
+            table[cG(i)->getId().toInt()] = i;
+        }
+    } else {
+        map.reserve(nCoords);
+        for (std::size_t i = 0; i < nCoords; i++) {
+            map[cG(i)->getId().toInt()] = i;
+        }
+    }
+
+    // Single pass over the elements. Issues are kept per chunk and
+    // appended in chunk order so the report does not depend on scheduling.
+    const std::size_t chunkSize = 4096;
+    const std::size_t nChunks = (nElems + chunkSize - 1) / chunkSize;
+    std::vector<std::vector<Issue>> found(nChunks);
+    std::vector<char> used(nCoords, false);
+    std::vector<std::pair<std::size_t, std::size_t>> ids(nElems);
+    std::vector<std::pair<std::size_t, std::size_t>> connectivity(nElems);
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (long long c = 0; c < (long long) nChunks; c++) {
+        const std::size_t first = c*chunkSize;
+        const std::size_t last = std::min(first + chunkSize, nElems);
+        std::vector<Issue>& issues = found[c];
+        std::vector<std::size_t> vIds;
+        std::vector<Math::CVecR3> pos;
+        // Elements of a same type are usually together, the dimension is
+        // only looked up again when the type changes.
+        const std::type_info* type = nullptr;
+        std::size_t dimension = 0;
+        for (std::size_t e = first; e < last; e++) {
+            const Element::Element<T>* elem = elems(e);
+            const std::size_t id = elem->getId().toInt();
+            ids[e] = std::make_pair(id, e);
+
+            bool isComplete = true;
+            vIds.clear();
+            pos.clear();
+            for (std::size_t j = 0; j < elem->numberOfCoordinates(); j++) {
+                const Coordinate::Coordinate<T,3>* v = elem->getV(j);
+                std::size_t index = none;
+                if (v != nullptr) {
+                    const std::size_t vId = v->getId().toInt();
+                    if (useTable) {
+                        index = (vId <= maxId)? table[vId] : none;
+                    } else {
+                        std::unordered_map<std::size_t, std::size_t>::
+                            const_iterator it = map.find(vId);
+                        index = (it != map.end())? it->second : none;
+                    }
+                    if (index != none && cG(index) != v) {
+                        index = none;
+                    }
+                }
+                if (index == none) {
+                    Issue issue = {danglingCoordinate, id,
+                                   v? v->getId().toInt() : 0};
+                    issues.push_back(issue);
+                    isComplete = false;
+                    continue;
+                }
+                #pragma omp atomic write
+                used[index] = true;
+                vIds.push_back(v->getId().toInt());
+                if (j < elem->numberOfVertices()) {
+                    pos.push_back(getPos(v));
+                }
+            }
+
+            if (isComplete) {
+                std::sort(vIds.begin(), vIds.end());
+                connectivity[e] = std::make_pair(hashIds(vIds), e);
+
+                if (type == nullptr || typeid(*elem) != *type) {
+                    type = &typeid(*elem);
+                    dimension = getDimension(elem);
+                }
+                Math::Real measure;
+                if (getMeasure(measure, pos, dimension)) {
+                    Math::Real size = 0.0;
+                    for (std::size_t j = 1; j < pos.size(); j++) {
+                        size = std::max(size, (pos[j] - pos[0]).norm());
+                    }
+                    const Math::Real minimum =
+                        tolerance_ * std::pow(size, (int) dimension);
+                    if (std::abs(measure) <= minimum) {
+                        Issue issue = {degenerate, id, 0};
+                        issues.push_back(issue);
+                    } else if (measure < 0.0) {
+                        Issue issue = {inverted, id, 0};
+                        issues.push_back(issue);
+                    }
+                }
+            } else {
+                connectivity[e] = std::make_pair(0, nElems);
+            }
+
+            const MatId matId = elem->getMatId();
+            if (checkModels_ && matId != MatId(0) && !models_.existId(matId)) {
+                Issue issue = {missingModel, id, matId.toInt()};
+                issues.push_back(issue);
+            }
+            const LayerId layId = elem->getLayerId();
+            if (layId != LayerId(0) && !layers.existId(layId)) {
+                Issue issue = {missingLayer, id, layId.toInt()};
+                issues.push_back(issue);
+            }
+        }
+    }
+    for (std::size_t c = 0; c < nChunks; c++) {
+        res.issues_.insert(res.issues_.end(), found[c].begin(), found[c].end());
+    }
+
+    // Duplicates are found by sorting, the first occurrence is related.
+    parallelSort(ids);
+    for (std::size_t i = 1; i < nElems; i++) {
+        if (ids[i].first == ids[i-1].first) {
+            Issue issue = {duplicatedId, ids[i].first, ids[i].first};
+            res.issues_.push_back(issue);
+        }
+    }
+    parallelSort(connectivity);
+    for (std::size_t i = 0; i < nElems; ) {
+        std::size_t j = i + 1;
+        while (j < nElems && connectivity[j].first == connectivity[i].first) {
+            j++;
+        }
+        // Elements with the same hash are compared, each duplicate is
+        // related to the first element with its same vertices.
+        std::vector<std::vector<std::size_t>> vertexIds;
+        for (std::size_t a = i;
+             j - i > 1 && a < j && connectivity[a].second < nElems; a++) {
+            vertexIds.push_back(getSortedIds(elems(connectivity[a].second)));
+            for (std::size_t b = 0; b + 1 < vertexIds.size(); b++) {
+                if (vertexIds[b] == vertexIds.back()) {
+                    Issue issue = {duplicatedConnectivity,
+                        elems(connectivity[a].second)->getId().toInt(),
+                        elems(connectivity[i+b].second)->getId().toInt()};
+                    res.issues_.push_back(issue);
+                    break;
+                }
+            }
+        }
+        i = j;
+    }
+
+    for (std::size_t i = 0; i < nCoords; i++) {
+        if (!used[i]) {
+            Issue issue = {unusedCoordinate, cG(i)->getId().toInt(), 0};
+            res.issues_.push_back(issue);
+        }
+    }
+    std::stable_sort(res.issues_.begin(), res.issues_.end(), lessByProblem);
+    return res;
+}
+
+} /* namespace Mesh */
+} /* namespace Geometry */
+} /* namespace SEMBA */
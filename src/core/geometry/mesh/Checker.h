@@ -0,0 +1,110 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SEMBA_GEOMETRY_MESH_CHECKER_H_
+#define SEMBA_GEOMETRY_MESH_CHECKER_H_
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "Structured.h"
+#include "Unstructured.h"
+
+namespace SEMBA {
+namespace Geometry {
+namespace Mesh {
+
+// Validates the coordinates, elements and references of a mesh in a single
+// concurrent pass over its elements.
+class Checker {
+public:
+    typedef SEMBA::Group::Identifiable<Element::Model, MatId> Models;
+
+    enum Problem {
+        danglingCoordinate,
+        duplicatedId,
+        duplicatedConnectivity,
+        degenerate,
+        inverted,
+        unusedCoordinate,
+        missingModel,
+        missingLayer
+    };
+    static const std::size_t numberOfProblems = 8;
+
+    // id is the element id, or the coordinate id for unused coordinates.
+    // related is the coordinate, element, material or layer id involved,
+    // 0 if there is none.
+    struct Issue {
+        Problem     problem;
+        std::size_t id;
+        std::size_t related;
+    };
+
+    class Report {
+        friend class Checker;
+    public:
+        Report();
+
+        bool isValid() const { return issues_.empty(); }
+        std::size_t count(const Problem) const;
+        const std::vector<Issue>& issues() const { return issues_; }
+
+        void writeJSON(std::ostream&) const;
+        void printInfo() const;
+
+        static std::string toStr(const Problem);
+
+    private:
+        std::size_t numberOfElements_;
+        std::size_t numberOfCoordinates_;
+        std::vector<Issue> issues_;
+    };
+
+    // Material ids are only checked when models are given.
+    Checker();
+    Checker(const Models& models);
+    virtual ~Checker();
+
+    // Measures below tolerance times the element size to the power of its
+    // dimension are reported as degenerate.
+    void setTolerance(const Math::Real tol) { tolerance_ = tol; }
+
+    Report check(const Unstructured& mesh) const;
+    Report check(const Structured&   mesh) const;
+
+private:
+    bool checkModels_;
+    SEMBA::Group::Identifiable<const Element::Model, MatId> models_;
+    Math::Real tolerance_;
+
+    template<class T>
+    Report check_(const Coordinate::Group<Coordinate::Coordinate<T,3>>& cG,
+                  const Element::Group<Element::Element<T>>& elems,
+                  const Layer::Group<>& layers) const;
+};
+
+} /* namespace Mesh */
+} /* namespace Geometry */
+} /* namespace SEMBA */
+
+#endif /* SEMBA_GEOMETRY_MESH_CHECKER_H_ */
@@ -0,0 +1,232 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#include "Dense.h"
+
+#include <stdexcept>
+#include <unordered_map>
+
+#include "geometry/element/Line2.h"
+#include "geometry/element/Quadrilateral4.h"
+
+namespace SEMBA {
+namespace Geometry {
+namespace Mesh {
+
+Dense::Dense(const Grid3& grid)
+:   grid_(grid),
+    numNodes_(grid.getNumCells() + 1) {
+
+    cells_.resize((std::size_t) numNodes_(0)*numNodes_(1)*numNodes_(2), 0);
+}
+
+Dense::Dense(const Structured& mesh)
+:   Dense(mesh.grid()) {
+
+    materials_ = MaterialTable(mesh.layers());
+    for (std::size_t e = 0; e < mesh.elems().size(); e++) {
+        const ElemI* elem = mesh.elems()(e);
+        std::vector<Index>* values = nullptr;
+        Math::CVecI3 min = elem->getBound().getMin();
+        Math::CVecI3 max = elem->getBound().getMax();
+        if (elem->is<HexI8>()) {
+            values = &cells_;
+        } else if (elem->is<QuaI4>()) {
+            const std::size_t d = elem->getBound().getNormal();
+            values = &faces_[d];
+            max(d)++;
+        } else if (elem->is<LinI2>()) {
+            for (std::size_t d = 0; d < 3; d++) {
+                if (min(d) == max(d)) {
+                    max(d)++;
+                } else {
+                    values = &edges_[d];
+                }
+            }
+        }
+        if (values == nullptr) {
+            continue;
+        }
+        const Math::CVecI3 size = getSize_(*values);
+        const Index index = materials_.add(elem);
+        for (Math::Int i = min(0); i < max(0); i++) {
+            for (Math::Int j = min(1); j < max(1); j++) {
+                for (Math::Int k = min(2); k < max(2); k++) {
+                    set_(*values, Math::CVecI3(i,j,k), size, index);
+                }
+            }
+        }
+    }
+}
+
+Dense::~Dense() {
+
+}
+
+Dense::Index Dense::getCell(const Math::CVecI3& ijk) const {
+    return cells_[getIndex_(ijk)];
+}
+
+Dense::Index Dense::getFace(const Math::Constants::CartesianAxis normal,
+                            const Math::CVecI3& ijk) const {
+    const std::size_t n = getIndex_(ijk);
+    if (faces_[normal].empty()) {
+        return 0;
+    }
+    return faces_[normal][n];
+}
+
+Dense::Index Dense::getEdge(const Math::Constants::CartesianAxis dir,
+                            const Math::CVecI3& ijk) const {
+    const std::size_t n = getIndex_(ijk);
+    if (edges_[dir].empty()) {
+        return 0;
+    }
+    return edges_[dir][n];
+}
+
+void Dense::setCell(const Math::CVecI3& ijk, const Index i) {
+    set_(cells_, ijk, getSize_(cells_), i);
+}
+
+void Dense::setFace(const Math::Constants::CartesianAxis normal,
+                    const Math::CVecI3& ijk, const Index i) {
+    set_(faces_[normal], ijk, getSize_(faces_[normal]), i);
+}
+
+void Dense::setEdge(const Math::Constants::CartesianAxis dir,
+                    const Math::CVecI3& ijk, const Index i) {
+    set_(edges_[dir], ijk, getSize_(edges_[dir]), i);
+}
+
+Structured* Dense::getMeshStructured() const {
+    Structured* res = new Structured(grid_);
+    res->layers() = materials_.layers().cloneElems();
+
+    std::unordered_map<std::size_t, const CoordI3*> nodes;
+    std::vector<CoordI3*> newCoords;
+    std::vector<ElemI*> newElems;
+    CoordId coordId(1);
+    ElemId  elemId(1);
+    const CoordI3* v[8];
+    // Kind 0 are cells, 1 to 3 faces and 4 to 6 edges.
+    for (std::size_t kind = 0; kind < 7; kind++) {
+        const std::vector<Index>* values;
+        if (kind == 0) {
+            values = &cells_;
+        } else if (kind < 4) {
+            values = &faces_[kind-1];
+        } else {
+            values = &edges_[kind-4];
+        }
+        const Math::CVecI3 size = getSize_(*values);
+        for (std::size_t n = 0; n < values->size(); n++) {
+            const Index index = (*values)[n];
+            if (index == 0) {
+                continue;
+            }
+            const Math::CVecI3 ijk(n / (numNodes_(1)*numNodes_(2)),
+                                   n / numNodes_(2) % numNodes_(1),
+                                   n % numNodes_(2));
+            const std::vector<Math::CVecI3> pos =
+                BoxI3(ijk, ijk + size).getPos();
+            for (std::size_t p = 0; p < pos.size(); p++) {
+                const std::size_t node = getIndex_(pos[p]);
+                std::unordered_map<std::size_t, const CoordI3*>::iterator
+                    it = nodes.find(node);
+                if (it == nodes.end()) {
+                    CoordI3* newCoord = new CoordI3(coordId++, pos[p]);
+                    newCoords.push_back(newCoord);
+                    it = nodes.insert(std::make_pair(node, newCoord)).first;
+                }
+                v[p] = it->second;
+            }
+            const Layer::Layer* lay = materials_.getLayer(index);
+            if (lay != nullptr) {
+                lay = res->layers().getId(lay->getId());
+            }
+            const Element::Model* mat = materials_.getModel(index);
+            if (kind == 0) {
+                newElems.push_back(new HexI8(elemId++, v, lay, mat));
+            } else if (kind < 4) {
+                newElems.push_back(new QuaI4(elemId++, v, lay, mat));
+            } else {
+                newElems.push_back(new LinI2(elemId++, v, lay, mat));
+            }
+        }
+    }
+    res->coords().add(newCoords);
+    res->elems().add(newElems);
+    return res;
+}
+
+std::size_t Dense::getMemory() const {
+    std::size_t res = cells_.capacity();
+    for (std::size_t d = 0; d < 3; d++) {
+        res += faces_[d].capacity() + edges_[d].capacity();
+    }
+    return res * sizeof(Index);
+}
+
+std::size_t Dense::getIndex_(const Math::CVecI3& ijk) const {
+    for (std::size_t d = 0; d < 3; d++) {
+        if (ijk(d) < 0 || ijk(d) >= numNodes_(d)) {
+            throw std::out_of_range("Position out of the dense mesh grid.");
+        }
+    }
+    return ((std::size_t) ijk(0)*numNodes_(1) + ijk(1))*numNodes_(2) +
+           ijk(2);
+}
+
+void Dense::set_(std::vector<Index>& values,
+                 const Math::CVecI3& ijk,
+                 const Math::CVecI3& size,
+                 const Index i) {
+    const std::size_t n = getIndex_(ijk);
+    getIndex_(ijk + size);
+    if (values.empty()) {
+        if (i == 0) {
+            return;
+        }
+        values.resize(cells_.size(), 0);
+    }
+    values[n] = i;
+}
+
+Math::CVecI3 Dense::getSize_(const std::vector<Index>& values) const {
+    for (std::size_t d = 0; d < 3; d++) {
+        if (&values == &faces_[d]) {
+            Math::CVecI3 res(1);
+            res(d) = 0;
+            return res;
+        }
+        if (&values == &edges_[d]) {
+            Math::CVecI3 res(0);
+            res(d) = 1;
+            return res;
+        }
+    }
+    return Math::CVecI3(1);
+}
+
+} /* namespace Mesh */
+} /* namespace Geometry */
+} /* namespace SEMBA */
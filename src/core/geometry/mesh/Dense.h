@@ -0,0 +1,100 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SEMBA_GEOMETRY_MESH_DENSE_H_
+#define SEMBA_GEOMETRY_MESH_DENSE_H_
+
+#include <vector>
+
+#include "MaterialTable.h"
+#include "Structured.h"
+
+namespace SEMBA {
+namespace Geometry {
+namespace Mesh {
+
+// Voxel representation of a structured mesh. Every cell, face and edge of
+// the grid holds a two byte index into a MaterialTable, 0 meaning empty.
+// Cells, faces with normal d and edges along d are all addressed by their
+// lower (i,j,k) node. Face and edge arrays are only allocated once
+// something is set on them.
+class Dense {
+public:
+    typedef MaterialTable::Index Index;
+
+    Dense(const Grid3& grid);
+    Dense(const Structured& mesh);
+    virtual ~Dense();
+
+    const Grid3&          grid     () const { return grid_; }
+    MaterialTable&        materials()       { return materials_; }
+    const MaterialTable&  materials() const { return materials_; }
+
+    Index getCell(const Math::CVecI3& ijk) const;
+    Index getFace(const Math::Constants::CartesianAxis normal,
+                  const Math::CVecI3& ijk) const;
+    Index getEdge(const Math::Constants::CartesianAxis dir,
+                  const Math::CVecI3& ijk) const;
+
+    // Raw storage, one value per grid node in (i,j,k) row major order. Face
+    // and edge arrays are empty when nothing was set on them.
+    const std::vector<Index>& cells() const { return cells_; }
+    const std::vector<Index>& faces(const std::size_t d) const {
+        return faces_[d];
+    }
+    const std::vector<Index>& edges(const std::size_t d) const {
+        return edges_[d];
+    }
+
+    void setCell(const Math::CVecI3& ijk, const Index i);
+    void setFace(const Math::Constants::CartesianAxis normal,
+                 const Math::CVecI3& ijk, const Index i);
+    void setEdge(const Math::Constants::CartesianAxis dir,
+                 const Math::CVecI3& ijk, const Index i);
+
+    // Creates one HexI8, QuaI4 or LinI2 per non empty cell, face or edge.
+    Structured* getMeshStructured() const;
+
+    std::size_t getMemory() const;
+
+private:
+    Grid3 grid_;
+    Math::CVecI3 numNodes_;
+    MaterialTable materials_;
+
+    std::vector<Index> cells_;
+    std::vector<Index> faces_[3];
+    std::vector<Index> edges_[3];
+
+    std::size_t getIndex_(const Math::CVecI3& ijk) const;
+    // Extent in cells of the cells, faces or edges stored in values.
+    Math::CVecI3 getSize_(const std::vector<Index>& values) const;
+    void set_(std::vector<Index>& values,
+              const Math::CVecI3& ijk,
+              const Math::CVecI3& size,
+              const Index i);
+};
+
+} /* namespace Mesh */
+} /* namespace Geometry */
+} /* namespace SEMBA */
+
+#endif /* SEMBA_GEOMETRY_MESH_DENSE_H_ */
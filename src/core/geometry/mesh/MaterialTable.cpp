@@ -0,0 +1,106 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#include "MaterialTable.h"
+
+#include <limits>
+#include <stdexcept>
+
+namespace SEMBA {
+namespace Geometry {
+namespace Mesh {
+
+MaterialTable::MaterialTable()
+:   table_(1, std::make_pair(nullptr, nullptr)) {
+
+}
+
+MaterialTable::MaterialTable(const Layer::Group<const Layer::Layer>& layers)
+:   layers_(layers.cloneElems()),
+    table_(1, std::make_pair(nullptr, nullptr)) {
+
+}
+
+MaterialTable::MaterialTable(const MaterialTable& rhs)
+:   table_(1, std::make_pair(nullptr, nullptr)) {
+
+    *this = rhs;
+}
+
+MaterialTable::~MaterialTable() {
+
+}
+
+MaterialTable& MaterialTable::operator=(const MaterialTable& rhs) {
+    if (this == &rhs) {
+        return *this;
+    }
+    layers_ = rhs.layers_.cloneElems();
+    table_ = rhs.table_;
+    index_ = rhs.index_;
+    for (std::size_t i = 1; i < table_.size(); i++) {
+        if (table_[i].second != nullptr) {
+            table_[i].second = layers_.getId(table_[i].second->getId());
+        }
+    }
+    return *this;
+}
+
+MaterialTable::Index MaterialTable::add(const Element::Model* model,
+                                        const Layer::Layer* layer) {
+    const std::pair<MatId, LayerId> key(
+            (model == nullptr)? MatId(0)   : model->getId(),
+            (layer == nullptr)? LayerId(0) : layer->getId());
+    std::map<std::pair<MatId, LayerId>, Index>::const_iterator it =
+        index_.find(key);
+    if (it != index_.end()) {
+        return it->second;
+    }
+    if (table_.size() > std::numeric_limits<Index>::max()) {
+        throw std::length_error("Too many materials in material table.");
+    }
+    if (layer != nullptr) {
+        if (!layers_.existId(layer->getId())) {
+            layers_.add(layer->cloneTo<Layer::Layer>());
+        }
+        layer = layers_.getId(layer->getId());
+    }
+    const Index res = table_.size();
+    table_.push_back(std::make_pair(model, layer));
+    index_[key] = res;
+    return res;
+}
+
+MaterialTable::Index MaterialTable::add(const Element::Base* elem) {
+    return add(elem->getModel(), elem->getLayer());
+}
+
+const Element::Model* MaterialTable::getModel(const Index i) const {
+    return table_.at(i).first;
+}
+
+const Layer::Layer* MaterialTable::getLayer(const Index i) const {
+    return table_.at(i).second;
+}
+
+} /* namespace Mesh */
+} /* namespace Geometry */
+} /* namespace SEMBA */
@@ -0,0 +1,72 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SEMBA_GEOMETRY_MESH_MATERIALTABLE_H_
+#define SEMBA_GEOMETRY_MESH_MATERIALTABLE_H_
+
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "geometry/element/Element.h"
+#include "geometry/layer/Group.h"
+
+namespace SEMBA {
+namespace Geometry {
+namespace Mesh {
+
+// Table of (model, layer) pairs, so that voxel like meshes can store a two
+// byte index per entry instead of element objects. Index 0 means empty.
+// Layers are copied into the table, models are not owned.
+class MaterialTable {
+public:
+    typedef std::uint16_t Index;
+
+    MaterialTable();
+    MaterialTable(const Layer::Group<const Layer::Layer>& layers);
+    MaterialTable(const MaterialTable& rhs);
+    virtual ~MaterialTable();
+
+    MaterialTable& operator=(const MaterialTable& rhs);
+
+    const Layer::Group<>& layers() const { return layers_; }
+
+    Index add(const Element::Model* model,
+              const Layer::Layer* layer = nullptr);
+    Index add(const Element::Base* elem);
+
+    std::size_t size() const { return table_.size() - 1; }
+    const Element::Model* getModel(const Index i) const;
+    const Layer::Layer*   getLayer(const Index i) const;
+
+private:
+    Layer::Group<> layers_;
+    std::vector<std::pair<const Element::Model*,
+                          const Layer::Layer*>> table_;
+    std::map<std::pair<MatId, LayerId>, Index> index_;
+};
+
+} /* namespace Mesh */
+} /* namespace Geometry */
+} /* namespace SEMBA */
+
+#endif /* SEMBA_GEOMETRY_MESH_MATERIALTABLE_H_ */
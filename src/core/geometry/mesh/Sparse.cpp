@@ -0,0 +1,404 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#include "Sparse.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace SEMBA {
+namespace Geometry {
+namespace Mesh {
+
+const std::size_t Sparse::defaultBrickSize;
+const std::uint32_t Sparse::uniform_ =
+    std::numeric_limits<std::uint32_t>::max();
+
+Sparse::Sparse(const Grid3& grid, const std::size_t brickSize)
+:   grid_(grid),
+    brickSize_(brickSize),
+    numCells_(grid.getNumCells()) {
+
+    if (brickSize_ == 0 ||
+        brickSize_ > std::numeric_limits<std::uint16_t>::max()) {
+        throw std::logic_error("Invalid brick size.");
+    }
+    for (std::size_t d = 0; d < 3; d++) {
+        numBricks_(d) = (numCells_(d) + brickSize_ - 1) / brickSize_;
+    }
+    const std::size_t nBricks =
+        (std::size_t) numBricks_(0) * numBricks_(1) * numBricks_(2);
+    value_.resize(nBricks, 0);
+    detail_.resize(nBricks, uniform_);
+}
+
+Sparse::Sparse(const Structured& mesh, const std::size_t brickSize)
+:   Sparse(mesh.grid(), brickSize) {
+
+    materials_ = MaterialTable(mesh.layers());
+    for (std::size_t e = 0; e < mesh.elems().size(); e++) {
+        const ElemI* elem = mesh.elems()(e);
+        if (elem->is<HexI8>()) {
+            setCells(elem->getBound(), materials_.add(elem));
+        }
+    }
+    compress();
+}
+
+Sparse::~Sparse() {
+
+}
+
+bool Sparse::isUniform(const Math::CVecI3& brick) const {
+    return detail_[getBrickId_(brick)] == uniform_;
+}
+
+Sparse::Index Sparse::getCell(const Math::CVecI3& ijk) const {
+    checkCell_(ijk);
+    const Math::CVecI3 brick = ijk / (Math::Int) brickSize_;
+    const std::size_t id = getBrickId_(brick);
+    if (detail_[id] == uniform_) {
+        return value_[id];
+    }
+    return getValue_(bricks_[detail_[id]],
+                     ijk - brick * (Math::Int) brickSize_);
+}
+
+void Sparse::setCell(const Math::CVecI3& ijk, const Index i) {
+    checkCell_(ijk);
+    const Math::CVecI3 brick = ijk / (Math::Int) brickSize_;
+    const std::size_t id = getBrickId_(brick);
+    if (detail_[id] == uniform_ && value_[id] == i) {
+        return;
+    }
+    const Math::CVecI3 local = ijk - brick * (Math::Int) brickSize_;
+    densify_(id).dense[(local(2)*brickSize_ + local(1))*brickSize_ +
+                       local(0)] = i;
+}
+
+void Sparse::setCells(const BoxI3& box, const Index i) {
+    const Math::CVecI3 min = box.getMin();
+    const Math::CVecI3 max = box.getMax();
+    for (std::size_t d = 0; d < 3; d++) {
+        if (min(d) < 0 || max(d) > numCells_(d)) {
+            throw std::out_of_range("Box out of the sparse mesh grid.");
+        }
+        if (min(d) >= max(d)) {
+            return;
+        }
+    }
+    const Math::CVecI3 minBrick = min / (Math::Int) brickSize_;
+    const Math::CVecI3 maxBrick = (max - 1) / (Math::Int) brickSize_;
+    for (Math::Int bk = minBrick(2); bk <= maxBrick(2); bk++) {
+    for (Math::Int bj = minBrick(1); bj <= maxBrick(1); bj++) {
+    for (Math::Int bi = minBrick(0); bi <= maxBrick(0); bi++) {
+        const Math::CVecI3 brick(bi, bj, bk);
+        const std::size_t id = getBrickId_(brick);
+        const Math::CVecI3 origin = brick * (Math::Int) brickSize_;
+        const Math::CVecI3 end = origin + getBrickCells_(brick);
+        Math::CVecI3 lo, hi;
+        bool full = true;
+        for (std::size_t d = 0; d < 3; d++) {
+            lo(d) = std::max(min(d), origin(d)) - origin(d);
+            hi(d) = std::min(max(d), end(d))    - origin(d);
+            full &= (lo(d) == 0) && (hi(d) == end(d) - origin(d));
+        }
+        if (full) {
+            setUniform_(id, i);
+            continue;
+        }
+        if (detail_[id] == uniform_ && value_[id] == i) {
+            continue;
+        }
+        Brick& b = densify_(id);
+        for (Math::Int k = lo(2); k < hi(2); k++) {
+            for (Math::Int j = lo(1); j < hi(1); j++) {
+                std::fill(b.dense.begin() + (k*brickSize_ + j)*brickSize_ +
+                                            lo(0),
+                          b.dense.begin() + (k*brickSize_ + j)*brickSize_ +
+                                            hi(0),
+                          i);
+            }
+        }
+    }
+    }
+    }
+}
+
+void Sparse::compress() {
+    std::vector<Run> row;
+    for (std::size_t n = bricks_.size(); n-- > 0;) {
+        Brick& brick = bricks_[n];
+        const Math::CVecI3 cells = getBrickCells_(getBrickIJK_(brick.id));
+        // Uniform bricks are detected on the cells inside the grid only.
+        const Index first = getValue_(brick, Math::CVecI3(0));
+        bool uniform = true;
+        std::vector<Run> runs;
+        std::vector<std::uint32_t> rows;
+        rows.reserve(brickSize_*brickSize_ + 1);
+        for (std::size_t k = 0; k < brickSize_; k++) {
+            for (std::size_t j = 0; j < brickSize_; j++) {
+                getRow_(brick, j, k, row);
+                rows.push_back(runs.size());
+                runs.insert(runs.end(), row.begin(), row.end());
+                if (uniform && (Math::Int) j < cells(1) &&
+                               (Math::Int) k < cells(2)) {
+                    std::size_t len = 0;
+                    for (std::size_t r = 0; r < row.size(); r++) {
+                        if (row[r].value != first) {
+                            uniform = false;
+                            break;
+                        }
+                        len += row[r].length;
+                        if (len >= (std::size_t) cells(0)) {
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+        rows.push_back(runs.size());
+        if (uniform) {
+            setUniform_(brick.id, first);
+            continue;
+        }
+        const std::size_t denseSize = brickSize_*brickSize_*brickSize_ *
+                                      sizeof(Index);
+        const std::size_t rleSize = runs.size()*sizeof(Run) +
+                                    rows.size()*sizeof(std::uint32_t);
+        if (rleSize < denseSize) {
+            std::vector<Index>().swap(brick.dense);
+            brick.runs.swap(runs);
+            brick.rows.swap(rows);
+        } else if (brick.dense.empty()) {
+            std::vector<Index> dense(brickSize_*brickSize_*brickSize_);
+            for (std::size_t k = 0; k < brickSize_; k++) {
+            for (std::size_t j = 0; j < brickSize_; j++) {
+            for (std::size_t i = 0; i < brickSize_; i++) {
+                dense[(k*brickSize_ + j)*brickSize_ + i] =
+                    getValue_(brick, Math::CVecI3(i,j,k));
+            }
+            }
+            }
+            brick.dense.swap(dense);
+            std::vector<Run>().swap(brick.runs);
+            std::vector<std::uint32_t>().swap(brick.rows);
+        }
+    }
+}
+
+Structured* Sparse::getMeshStructured() const {
+    Structured* res = new Structured(grid_);
+    res->layers() = materials_.layers().cloneElems();
+
+    const Math::CVecI3 numNodes = numCells_ + 1;
+    std::unordered_map<std::size_t, const CoordI3*> nodes;
+    std::vector<CoordI3*> newCoords;
+    std::vector<ElemI*> newElems;
+    CoordId coordId(1);
+    ElemId  elemId(1);
+    std::vector<Run> row;
+    std::vector<std::pair<BoxI3, Index>> boxes;
+    for (std::size_t id = 0; id < detail_.size(); id++) {
+        const Math::CVecI3 brickIJK = getBrickIJK_(id);
+        const Math::CVecI3 origin = brickIJK * (Math::Int) brickSize_;
+        const Math::CVecI3 cells = getBrickCells_(brickIJK);
+        boxes.clear();
+        if (detail_[id] == uniform_) {
+            boxes.push_back(std::make_pair(BoxI3(origin, origin + cells),
+                                           value_[id]));
+        } else {
+            const Brick& brick = bricks_[detail_[id]];
+            for (Math::Int k = 0; k < cells(2); k++) {
+                for (Math::Int j = 0; j < cells(1); j++) {
+                    getRow_(brick, j, k, row);
+                    Math::Int i = 0;
+                    for (std::size_t r = 0; r < row.size(); r++) {
+                        const Math::Int len =
+                            std::min<Math::Int>(row[r].length, cells(0) - i);
+                        if (len <= 0) {
+                            break;
+                        }
+                        const Math::CVecI3 min = origin +
+                                                 Math::CVecI3(i, j, k);
+                        boxes.push_back(std::make_pair(
+                                BoxI3(min, min + Math::CVecI3(len, 1, 1)),
+                                row[r].value));
+                        i += len;
+                    }
+                }
+            }
+        }
+        for (std::size_t b = 0; b < boxes.size(); b++) {
+            const Index index = boxes[b].second;
+            if (index == 0) {
+                continue;
+            }
+            const std::vector<Math::CVecI3> pos = boxes[b].first.getPos();
+            const CoordI3* v[8];
+            for (std::size_t p = 0; p < pos.size(); p++) {
+                const std::size_t node =
+                    ((std::size_t) pos[p](0)*numNodes(1) + pos[p](1)) *
+                    numNodes(2) + pos[p](2);
+                std::unordered_map<std::size_t, const CoordI3*>::iterator
+                    it = nodes.find(node);
+                if (it == nodes.end()) {
+                    CoordI3* newCoord = new CoordI3(coordId++, pos[p]);
+                    newCoords.push_back(newCoord);
+                    it = nodes.insert(std::make_pair(node, newCoord)).first;
+                }
+                v[p] = it->second;
+            }
+            const Layer::Layer* lay = materials_.getLayer(index);
+            if (lay != nullptr) {
+                lay = res->layers().getId(lay->getId());
+            }
+            newElems.push_back(new HexI8(elemId++, v, lay,
+                                         materials_.getModel(index)));
+        }
+    }
+    res->coords().add(newCoords);
+    res->elems().add(newElems);
+    return res;
+}
+
+std::size_t Sparse::getMemory() const {
+    std::size_t res = value_.capacity()*sizeof(Index) +
+                      detail_.capacity()*sizeof(std::uint32_t);
+    for (std::size_t n = 0; n < bricks_.size(); n++) {
+        res += sizeof(Brick) +
+               bricks_[n].dense.capacity()*sizeof(Index) +
+               bricks_[n].rows.capacity()*sizeof(std::uint32_t) +
+               bricks_[n].runs.capacity()*sizeof(Run);
+    }
+    return res;
+}
+
+std::size_t Sparse::getBrickId_(const Math::CVecI3& brick) const {
+    return ((std::size_t) brick(2)*numBricks_(1) + brick(1))*numBricks_(0) +
+           brick(0);
+}
+
+Math::CVecI3 Sparse::getBrickIJK_(const std::size_t id) const {
+    return Math::CVecI3(id % numBricks_(0),
+                        id / numBricks_(0) % numBricks_(1),
+                        id / ((std::size_t) numBricks_(0)*numBricks_(1)));
+}
+
+Math::CVecI3 Sparse::getBrickCells_(const Math::CVecI3& brick) const {
+    Math::CVecI3 res;
+    for (std::size_t d = 0; d < 3; d++) {
+        res(d) = std::min<Math::Int>(brickSize_,
+                                     numCells_(d) - brick(d)*brickSize_);
+    }
+    return res;
+}
+
+Sparse::Index Sparse::getValue_(const Brick& brick,
+                                const Math::CVecI3& local) const {
+    const std::size_t row = local(2)*brickSize_ + local(1);
+    if (!brick.dense.empty()) {
+        return brick.dense[row*brickSize_ + local(0)];
+    }
+    std::size_t i = 0;
+    for (std::size_t r = brick.rows[row]; r < brick.rows[row+1]; r++) {
+        i += brick.runs[r].length;
+        if ((std::size_t) local(0) < i) {
+            return brick.runs[r].value;
+        }
+    }
+    return 0;
+}
+
+void Sparse::getRow_(const Brick& brick,
+                     const std::size_t j, const std::size_t k,
+                     std::vector<Run>& row) const {
+    row.clear();
+    const std::size_t n = k*brickSize_ + j;
+    if (brick.dense.empty()) {
+        row.assign(brick.runs.begin() + brick.rows[n],
+                   brick.runs.begin() + brick.rows[n+1]);
+        return;
+    }
+    for (std::size_t i = 0; i < brickSize_; i++) {
+        const Index value = brick.dense[n*brickSize_ + i];
+        if (row.empty() || row.back().value != value) {
+            Run run;
+            run.length = 0;
+            run.value = value;
+            row.push_back(run);
+        }
+        row.back().length++;
+    }
+}
+
+Sparse::Brick& Sparse::densify_(const std::size_t id) {
+    if (detail_[id] == uniform_) {
+        Brick brick;
+        brick.id = id;
+        brick.dense.assign(brickSize_*brickSize_*brickSize_, value_[id]);
+        detail_[id] = bricks_.size();
+        bricks_.push_back(brick);
+        return bricks_.back();
+    }
+    Brick& brick = bricks_[detail_[id]];
+    if (brick.dense.empty()) {
+        std::vector<Index> dense;
+        dense.reserve(brickSize_*brickSize_*brickSize_);
+        for (std::size_t r = 0; r < brick.runs.size(); r++) {
+            dense.insert(dense.end(), brick.runs[r].length,
+                         brick.runs[r].value);
+        }
+        brick.dense.swap(dense);
+        std::vector<Run>().swap(brick.runs);
+        std::vector<std::uint32_t>().swap(brick.rows);
+    }
+    return brick;
+}
+
+void Sparse::setUniform_(const std::size_t id, const Index i) {
+    value_[id] = i;
+    const std::uint32_t pos = detail_[id];
+    if (pos == uniform_) {
+        return;
+    }
+    // Removes the detailed brick moving the last one into its place.
+    if (pos + 1 != bricks_.size()) {
+        std::swap(bricks_[pos], bricks_.back());
+        detail_[bricks_[pos].id] = pos;
+    }
+    bricks_.pop_back();
+    detail_[id] = uniform_;
+}
+
+void Sparse::checkCell_(const Math::CVecI3& ijk) const {
+    for (std::size_t d = 0; d < 3; d++) {
+        if (ijk(d) < 0 || ijk(d) >= numCells_(d)) {
+            throw std::out_of_range("Cell out of the sparse mesh grid.");
+        }
+    }
+}
+
+} /* namespace Mesh */
+} /* namespace Geometry */
+} /* namespace SEMBA */
@@ -0,0 +1,139 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SEMBA_GEOMETRY_MESH_SPARSE_H_
+#define SEMBA_GEOMETRY_MESH_SPARSE_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "MaterialTable.h"
+#include "Structured.h"
+
+namespace SEMBA {
+namespace Geometry {
+namespace Mesh {
+
+// Block sparse storage of the cell materials of a structured mesh. The grid
+// is split in cubic bricks of brickSize cells which are either uniform,
+// holding a single MaterialTable index, or detailed. compress() turns
+// detailed bricks back to uniform when possible and stores the rest dense
+// or run length encoded along x, whichever is smaller. Only cells are
+// stored, faces and edges of the structured mesh are not represented.
+class Sparse {
+public:
+    typedef MaterialTable::Index Index;
+
+    static const std::size_t defaultBrickSize = 32;
+
+    Sparse(const Grid3& grid,
+           const std::size_t brickSize = defaultBrickSize);
+    Sparse(const Structured& mesh,
+           const std::size_t brickSize = defaultBrickSize);
+    virtual ~Sparse();
+
+    const Grid3&         grid     () const { return grid_; }
+    MaterialTable&       materials()       { return materials_; }
+    const MaterialTable& materials() const { return materials_; }
+
+    std::size_t  getBrickSize() const { return brickSize_; }
+    Math::CVecI3 getNumBricks() const { return numBricks_; }
+    std::size_t  numberOfDetailedBricks() const { return bricks_.size(); }
+    bool         isUniform(const Math::CVecI3& brick) const;
+
+    Index getCell (const Math::CVecI3& ijk) const;
+    void  setCell (const Math::CVecI3& ijk, const Index i);
+    // Sets all cells from box min, included, to box max, excluded.
+    void  setCells(const BoxI3& box, const Index i);
+
+    void compress();
+
+    // Calls f(ijk, index) for every cell of the detailed bricks. Bricks are
+    // visited concurrently, cells of a brick by a single thread.
+    template<typename F>
+    void forEachDetailed(F f) const;
+
+    // Creates one HexI8 per non empty uniform brick or run of cells.
+    Structured* getMeshStructured() const;
+
+    std::size_t getMemory() const;
+
+private:
+    struct Run {
+        std::uint16_t length;
+        Index         value;
+    };
+    // Cells are stored with x running fastest. Run length encoded bricks
+    // keep the position of the first run of each (j,k) row.
+    struct Brick {
+        std::size_t                id;
+        std::vector<Index>         dense;
+        std::vector<std::uint32_t> rows;
+        std::vector<Run>           runs;
+    };
+
+    static const std::uint32_t uniform_;
+
+    Grid3 grid_;
+    std::size_t brickSize_;
+    Math::CVecI3 numCells_, numBricks_;
+    MaterialTable materials_;
+
+    std::vector<Index>         value_;
+    std::vector<std::uint32_t> detail_;
+    std::vector<Brick>         bricks_;
+
+    std::size_t  getBrickId_   (const Math::CVecI3& brick) const;
+    Math::CVecI3 getBrickIJK_  (const std::size_t id) const;
+    Math::CVecI3 getBrickCells_(const Math::CVecI3& brick) const;
+    Index getValue_(const Brick& brick, const Math::CVecI3& local) const;
+    void  getRow_  (const Brick& brick,
+                    const std::size_t j, const std::size_t k,
+                    std::vector<Run>& row) const;
+    Brick& densify_(const std::size_t id);
+    void   setUniform_(const std::size_t id, const Index i);
+    void   checkCell_(const Math::CVecI3& ijk) const;
+};
+
+template<typename F>
+void Sparse::forEachDetailed(F f) const {
+    #pragma omp parallel for schedule(dynamic)
+    for (long long n = 0; n < (long long) bricks_.size(); n++) {
+        const Brick& brick = bricks_[n];
+        const Math::CVecI3 brickIJK = getBrickIJK_(brick.id);
+        const Math::CVecI3 cells = getBrickCells_(brickIJK);
+        const Math::CVecI3 origin = brickIJK * (Math::Int) brickSize_;
+        for (Math::Int k = 0; k < cells(2); k++) {
+            for (Math::Int j = 0; j < cells(1); j++) {
+                for (Math::Int i = 0; i < cells(0); i++) {
+                    const Math::CVecI3 local(i,j,k);
+                    f(origin + local, getValue_(brick, local));
+                }
+            }
+        }
+    }
+}
+
+} /* namespace Mesh */
+} /* namespace Geometry */
+} /* namespace SEMBA */
+
+#endif /* SEMBA_GEOMETRY_MESH_SPARSE_H_ */
@@ -22,6 +22,16 @@
 #include "Unstructured.h"
 #include "Structured.h"
 
+#include <algorithm>
+#include <exception>
+#include <typeinfo>
+#include <unordered_set>
+
+#include "geometry/element/Node.h"
+#include "geometry/element/Line.h"
+#include "geometry/element/Surface.h"
+#include "geometry/element/Volume.h"
+
 namespace SEMBA {
 namespace Geometry {
 namespace Mesh {
@@ -83,27 +93,163 @@ void Structured::applyScalingFactor(const Math::Real factor) {
     grid_.applyScalingFactor(factor);
 }
 
-Unstructured* Structured::getMeshUnstructured() const {
+Structured::Filter::Filter()
+:   types_(0) {
+
+}
+
+Structured::Filter& Structured::Filter::addMatId(const MatId matId) {
+    matIds_.insert(matId);
+    return *this;
+}
+
+Structured::Filter& Structured::Filter::addLayerId(const LayerId layerId) {
+    layerIds_.insert(layerId);
+    return *this;
+}
+
+Structured::Filter& Structured::Filter::addType(const Type type) {
+    types_ |= type;
+    return *this;
+}
+
+bool Structured::Filter::empty() const {
+    return matIds_.empty() && layerIds_.empty() && (types_ == 0);
+}
+
+bool Structured::Filter::isSelected(const ElemI* elem) const {
+    if (!matIds_.empty() && (matIds_.count(elem->getMatId()) == 0)) {
+        return false;
+    }
+    if (!layerIds_.empty() && (layerIds_.count(elem->getLayerId()) == 0)) {
+        return false;
+    }
+    if (types_ != 0) {
+        unsigned type = 0;
+        if (elem->is<NodI>()) {
+            type = node;
+        } else if (elem->is<LinI>()) {
+            type = line;
+        } else if (elem->is<SurfI>()) {
+            type = surface;
+        } else if (elem->is<VolI>()) {
+            type = volume;
+        }
+        if ((types_ & type) == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+Unstructured* Structured::getMeshUnstructured(const Filter& filter) const {
     Unstructured* res = new Unstructured;
 
-    std::vector<CoordR3*> newCoords;
-    newCoords.reserve(coords().size());
-    for (std::size_t i = 0; i < coords().size(); i++) {
-        CoordR3* newCoord = coords()(i)->toUnstructured(grid_);
-        if (newCoord != nullptr) {
-            newCoords.push_back(newCoord);
+    // Elements are selected first so that only the coordinates they use
+    // are converted.
+    const std::size_t nElems = elems().size();
+    std::vector<const ElemI*> selected;
+    std::vector<const CoordI3*> used;
+    if (filter.empty()) {
+        selected.resize(nElems);
+        for (std::size_t i = 0; i < nElems; i++) {
+            selected[i] = elems()(i);
+        }
+        used.resize(coords().size());
+        for (std::size_t i = 0; i < coords().size(); i++) {
+            used[i] = coords()(i);
+        }
+    } else {
+        std::vector<char> isSelected(nElems, false);
+        #pragma omp parallel for schedule(static)
+        for (long long i = 0; i < (long long) nElems; i++) {
+            isSelected[i] = filter.isSelected(elems()(i));
+        }
+        std::unordered_set<const CoordI3*> usedSet;
+        for (std::size_t i = 0; i < nElems; i++) {
+            if (isSelected[i]) {
+                const ElemI* elem = elems()(i);
+                selected.push_back(elem);
+                for (std::size_t j = 0; j < elem->numberOfCoordinates(); j++) {
+                    usedSet.insert(elem->getV(j));
+                }
+            }
+        }
+        used.reserve(usedSet.size());
+        for (std::size_t i = 0; i < coords().size(); i++) {
+            if (usedSet.count(coords()(i)) != 0) {
+                used.push_back(coords()(i));
+            }
+        }
+    }
+
+    // Positions of plain structured coordinates are read from the grid as a
+    // single batch. Relative and conformal coordinates add their own offset.
+    const std::size_t nCoords = used.size();
+    std::vector<Math::CVecI3> cells(nCoords);
+    for (std::size_t i = 0; i < nCoords; i++) {
+        cells[i] = used[i]->pos();
+    }
+    const std::vector<Math::CVecR3> pos = grid_.getPos(cells);
+    std::vector<CoordR3*> newCoords(nCoords);
+    #pragma omp parallel for schedule(static)
+    for (long long i = 0; i < (long long) nCoords; i++) {
+        if (typeid(*used[i]) == typeid(CoordI3)) {
+            newCoords[i] = new CoordR3(used[i]->getId(), pos[i]);
+        } else {
+            newCoords[i] = used[i]->toUnstructured(grid_);
         }
     }
     res->coords().add(newCoords);
 
-    std::vector<ElemR*> newElems;
-    newElems.reserve(elems().size());
-    for (std::size_t i = 0; i < elems().size(); i++) {
-        ElemR* newElem = elems()(i)->toUnstructured(res->coords(), grid_);
-        if (newElem != nullptr) {
-            newElems.push_back(newElem);
+    // Elements are converted by chunks into separated buffers which are
+    // then appended in chunk order, so the result does not depend on the
+    // scheduling. The unstructured coordinates are only read from here on.
+    const std::size_t chunkSize = 1024;
+    const std::size_t nSelected = selected.size();
+    const std::size_t nChunks = (nSelected + chunkSize - 1) / chunkSize;
+    std::vector<std::vector<ElemR*>> buffers(nChunks);
+    std::exception_ptr error;
+    std::size_t errorElem = nSelected;
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (long long c = 0; c < (long long) nChunks; c++) {
+        const std::size_t first = c*chunkSize;
+        const std::size_t last = std::min(first + chunkSize, nSelected);
+        std::vector<ElemR*>& buffer = buffers[c];
+        buffer.reserve(last - first);
+        for (std::size_t i = first; i < last; i++) {
+            try {
+                ElemR* newElem = selected[i]->toUnstructured(res->coords(),
+                                                             grid_);
+                if (newElem != nullptr) {
+                    buffer.push_back(newElem);
+                }
+            } catch (...) {
+                #pragma omp critical (StructuredGetMeshUnstructured)
+                {
+                    if (i < errorElem) {
+                        errorElem = i;
+                        error = std::current_exception();
+                    }
+                }
+                break;
+            }
         }
     }
+    if (error) {
+        for (std::size_t c = 0; c < nChunks; c++) {
+            for (std::size_t i = 0; i < buffers[c].size(); i++) {
+                delete buffers[c][i];
+            }
+        }
+        delete res;
+        std::rethrow_exception(error);
+    }
+    std::vector<ElemR*> newElems;
+    newElems.reserve(nSelected);
+    for (std::size_t c = 0; c < nChunks; c++) {
+        newElems.insert(newElems.end(), buffers[c].begin(), buffers[c].end());
+    }
     res->elems().add(newElems);
     res->layers() = layers().cloneElems();
     return res;
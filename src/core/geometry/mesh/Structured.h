@@ -23,6 +23,7 @@
 #define SEMBA_GEOMETRY_MESH_STRUCTURED_H_
 
 #include <exception>
+#include <set>
 
 #include "geometry/element/Hexahedron8.h"
 
@@ -41,6 +42,33 @@ class Unstructured;
 
 class Structured : public virtual Mesh {
 public:
+    // Selects the elements converted by getMeshUnstructured. A criterion
+    // with no values accepts every element, the selected elements are the
+    // ones accepted by all the criteria.
+    class Filter {
+    public:
+        enum Type {
+            node    = 1,
+            line    = 2,
+            surface = 4,
+            volume  = 8
+        };
+
+        Filter();
+
+        Filter& addMatId  (const MatId   matId);
+        Filter& addLayerId(const LayerId layerId);
+        Filter& addType   (const Type    type);
+
+        bool empty() const;
+        bool isSelected(const ElemI* elem) const;
+
+    private:
+        std::set<MatId>   matIds_;
+        std::set<LayerId> layerIds_;
+        unsigned          types_;
+    };
+
     Structured(const Grid3& grid);
     Structured(const Grid3& grid,
                const Coordinate::Group<const CoordI3>& cG,
@@ -67,7 +95,9 @@ public:
     const Element::Group<ElemI>&      elems () const { return elems_; }
     const Layer::Group<>&             layers() const { return layers_; }
 
-    Unstructured* getMeshUnstructured() const;
+    // Only the selected elements, and the coordinates they use, are
+    // converted. Results keep the order of this mesh.
+    Unstructured* getMeshUnstructured(const Filter& = Filter()) const;
     //Structured* getConnectivityMesh() const;
 
     //void convertToHex(Element::Group<const SurfI> surfs);
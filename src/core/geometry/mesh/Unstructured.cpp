@@ -22,6 +22,11 @@
 #include "Structured.h"
 #include "Unstructured.h"
 
+#include <algorithm>
+#include <exception>
+#include <set>
+#include <stdexcept>
+
 #include "geometry/element/Tetrahedron.h"
 
 namespace SEMBA {
@@ -75,29 +80,191 @@ Structured* Unstructured::getMeshStructured(const Grid3& grid,
         const Math::Real tol) const {
     Structured* res = new Structured(grid);
 
-    std::vector<CoordI3*> newCoords;
-    newCoords.reserve(coords().size());
-    for (std::size_t i = 0; i < coords().size(); i++) {
-        CoordI3* newCoord = coords()(i)->toStructured(grid);
-        if (newCoord != nullptr) {
-            newCoords.push_back(newCoord);
-        }
+    // Coordinates are snapped to the grid as a single batch.
+    const std::size_t nCoords = coords().size();
+    std::vector<Math::CVecR3> pos(nCoords);
+    for (std::size_t i = 0; i < nCoords; i++) {
+        pos[i] = coords()(i)->pos();
+    }
+    const std::vector<std::pair<Math::CVecI3, Math::CVecR3>> cells =
+        grid.getCellPairs(pos);
+    std::vector<CoordI3*> newCoords(nCoords);
+    #pragma omp parallel for schedule(static)
+    for (long long i = 0; i < (long long) nCoords; i++) {
+        newCoords[i] = new CoordI3(coords()(i)->getId(), cells[i].first);
     }
     res->coords().add(newCoords);
 
-    std::vector<ElemI*> newElems;
-    newElems.reserve(elems().size());
-    for (std::size_t i = 0; i < elems().size(); i++) {
-		ElemI* newElem = elems()(i)->toStructured(res->coords(), grid, tol);
-        if (newElem != nullptr) {
-            newElems.push_back(newElem);
+    // Elements are converted concurrently into per element slots so that
+    // the result keeps the same order and ids as the input. The structured
+    // coordinates are only read from here on.
+    const std::size_t nElems = elems().size();
+    std::vector<ElemI*> newElems(nElems, nullptr);
+    std::exception_ptr error;
+    std::size_t errorElem = nElems;
+    #pragma omp parallel for schedule(dynamic, 1024)
+    for (long long i = 0; i < (long long) nElems; i++) {
+        try {
+            newElems[i] = elems()(i)->toStructured(res->coords(), grid, tol);
+        } catch (...) {
+            #pragma omp critical (UnstructuredGetMeshStructured)
+            {
+                if ((std::size_t) i < errorElem) {
+                    errorElem = i;
+                    error = std::current_exception();
+                }
+            }
         }
     }
+    if (error) {
+        for (std::size_t i = 0; i < nElems; i++) {
+            delete newElems[i];
+        }
+        delete res;
+        std::rethrow_exception(error);
+    }
+    std::vector<ElemI*>::iterator last =
+        std::remove(newElems.begin(), newElems.end(), nullptr);
+    newElems.erase(last, newElems.end());
     res->elems().add(newElems);
     res->layers() = layers().cloneElems();
     return res;
 }
 
+void Unstructured::updateMeshStructured(Structured& res,
+        const SEMBA::Group::Generation generation,
+        const Math::Real tol) const {
+    if (!coords().tracker().isTracking() ||
+        !elems().tracker().isTracking()) {
+        throw std::logic_error(
+            "Unstructured: Change tracking is not enabled");
+    }
+    const Grid3& grid = res.grid();
+    // Without the journal of the changes everything is converted again.
+    std::vector<CoordId> changedCoordIds;
+    std::vector<ElemId> changedElemIds;
+    if (coords().tracker().hasJournalAfter(generation) &&
+        elems().tracker().hasJournalAfter(generation)) {
+        changedCoordIds = coords().tracker().getChanged(generation);
+        changedElemIds = elems().tracker().getChanged(generation);
+    } else {
+        changedCoordIds = coords().getIds();
+        changedElemIds = elems().getIds();
+    }
+    const std::set<CoordId> changedCoords(changedCoordIds.begin(),
+                                          changedCoordIds.end());
+    const std::set<ElemId> changedElems(changedElemIds.begin(),
+                                        changedElemIds.end());
+
+    // Coordinates which changed are located again, the rest are shared
+    // with the previous result.
+    const std::size_t nCoords = coords().size();
+    std::vector<std::size_t> coordsToConvert;
+    std::vector<Math::CVecR3> pos;
+    for (std::size_t i = 0; i < nCoords; i++) {
+        const CoordId id = coords()(i)->getId();
+        if (changedCoords.count(id) != 0 || !res.coords().existId(id)) {
+            coordsToConvert.push_back(i);
+            pos.push_back(coords()(i)->pos());
+        }
+    }
+    const std::vector<std::pair<Math::CVecI3, Math::CVecR3>> cells =
+        grid.getCellPairs(pos);
+    Coordinate::Group<CoordI3> newCoords;
+    newCoords.reserve(nCoords);
+    std::vector<CoordId> run;
+    std::size_t next = 0;
+    for (std::size_t i = 0; i < nCoords; i++) {
+        const CoordId id = coords()(i)->getId();
+        if (next < coordsToConvert.size() && coordsToConvert[next] == i) {
+            newCoords.add(res.coords().getId(run));
+            run.clear();
+            newCoords.add(new CoordI3(id, cells[next].first));
+            next++;
+        } else {
+            run.push_back(id);
+        }
+    }
+    newCoords.add(res.coords().getId(run));
+
+    // Elements are converted again when they changed or when one of their
+    // vertices did.
+    const std::size_t nElems = elems().size();
+    std::vector<char> toConvert(nElems, false);
+    #pragma omp parallel for schedule(static)
+    for (long long i = 0; i < (long long) nElems; i++) {
+        const ElemR* elem = elems()(i);
+        bool changed = (changedElems.count(elem->getId()) != 0);
+        for (std::size_t j = 0;
+             !changed && j < elem->numberOfCoordinates(); j++) {
+            changed = (changedCoords.count(elem->getV(j)->getId()) != 0);
+        }
+        toConvert[i] = changed;
+    }
+    std::vector<ElemI*> converted(nElems, nullptr);
+    std::exception_ptr error;
+    std::size_t errorElem = nElems;
+    #pragma omp parallel for schedule(dynamic, 1024)
+    for (long long i = 0; i < (long long) nElems; i++) {
+        if (!toConvert[i]) {
+            continue;
+        }
+        try {
+            converted[i] = elems()(i)->toStructured(newCoords, grid, tol);
+        } catch (...) {
+            #pragma omp critical (UnstructuredUpdateMeshStructured)
+            {
+                if ((std::size_t) i < errorElem) {
+                    errorElem = i;
+                    error = std::current_exception();
+                }
+            }
+        }
+    }
+    if (error) {
+        for (std::size_t i = 0; i < nElems; i++) {
+            delete converted[i];
+        }
+        std::rethrow_exception(error);
+    }
+    Element::Group<ElemI> newElems;
+    newElems.reserve(nElems);
+    std::vector<ElemId> convertedIds;
+    std::vector<ElemId> elemRun;
+    for (std::size_t i = 0; i < nElems; i++) {
+        const ElemId id = elems()(i)->getId();
+        if (toConvert[i]) {
+            newElems.add(res.elems().getId(elemRun));
+            elemRun.clear();
+            convertedIds.push_back(id);
+            if (converted[i] != nullptr) {
+                newElems.add(converted[i]);
+            }
+        } else if (res.elems().existId(id)) {
+            elemRun.push_back(id);
+        }
+    }
+    newElems.add(res.elems().getId(elemRun));
+
+    // The structured mesh only records as changed what was converted here.
+    const bool coordsTracking = res.coords().tracker().isTracking();
+    const bool elemsTracking  = res.elems().tracker().isTracking();
+    res.coords().stopTracking();
+    res.elems().stopTracking();
+    res.coords() = newCoords;
+    res.elems() = newElems;
+    res.layers() = layers().cloneElems();
+    if (coordsTracking) {
+        res.coords().startTracking();
+        res.coords().touchId(changedCoordIds);
+    }
+    if (elemsTracking) {
+        res.elems().startTracking();
+        res.elems().touchId(changedElemIds);
+        res.elems().touchId(convertedIds);
+    }
+}
+
 //Unstructured* Unstructured::getConnectivityMesh() const {
 //    Unstructured* res = new Unstructured;
 //    res->coords() = coords().cloneElems();
@@ -62,6 +62,16 @@ public:
     Structured* getMeshStructured(
             const Grid3& grid,
             const Math::Real tol = Grid3::tolerance) const;
+    // Brings a mesh obtained with getMeshStructured up to date with the
+    // changes made here after generation, converting only the coordinates
+    // and elements which changed, or use a coordinate which changed. The
+    // result is the same as the one of a full conversion. Tracking must be
+    // enabled in coords() and elems() before the changes. When the journal
+    // after generation was truncated everything is converted again.
+    void updateMeshStructured(
+            Structured& mesh,
+            const SEMBA::Group::Generation generation,
+            const Math::Real tol = Grid3::tolerance) const;
     
 	//Unstructured* getConnectivityMesh() const;
     //std::vector<Element::Face> getBorderWithNormal(
@@ -26,6 +26,7 @@
 #include <map>
 
 #include "Group.h"
+#include "Tracker.h"
 
 namespace SEMBA {
 namespace Group {
@@ -83,9 +84,25 @@ public:
     virtual void removeId(const Id);
     virtual void removeId(const std::vector<Id>&);
 
+    // Change tracking is disabled by default. Once started, ids added,
+    // removed or touched are recorded in the tracker. Changes made directly
+    // on the elements must be reported with touchId. The tracking state is
+    // not copied along with the group.
+    void startTracking() { tracker_.start(); }
+    void stopTracking()  { tracker_.stop();  }
+    // Forgets the changes made up to generation.
+    void truncateTracking(const Generation generation) {
+        tracker_.truncate(generation);
+    }
+    const Tracker<Id>& tracker() const { return tracker_; }
+
+    void touchId(const Id);
+    void touchId(const std::vector<Id>&);
+
 private:
     Id lastId_;
     std::map<Id, std::size_t> mapId_;
+    Tracker<Id> tracker_;
 
     void postprocess_(const std::size_t& pos);
     std::vector<std::size_t> getElemsId_(const std::vector<Id>&) const;
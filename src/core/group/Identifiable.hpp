@@ -109,6 +109,9 @@ Identifiable<T,Id>& Identifiable<T,Id>::operator=(Group<T>&& rhs) {
 
 template<typename T, class Id>
 void Identifiable<T,Id>::clear() {
+    if (tracker_.isTracking()) {
+        tracker_.erase(getIds());
+    }
     Group<T>::clear();
     lastId_ = Id(0);
     mapId_.clear();
@@ -206,16 +209,25 @@ Group<T> Identifiable<T,Id>::addId(Group<T>&& rhs) {
 
 template<typename T, class Id>
 void Identifiable<T,Id>::remove(const std::size_t& pos) {
-    mapId_.erase(this->get(pos)->getId());
-    Group<T>::remove(pos);
+    Identifiable<T,Id>::remove(std::vector<std::size_t>(1, pos));
 }
 
 template<typename T, class Id>
 void Identifiable<T,Id>::remove(const std::vector<std::size_t>& pos) {
+    std::vector<Id> ids;
+    ids.reserve(pos.size());
     for (std::size_t i = 0; i < pos.size(); i++) {
-        mapId_.erase(this->get(pos[i])->getId());
+        ids.push_back(this->get(pos[i])->getId());
+        mapId_.erase(ids.back());
     }
+    // The remaining elements are reindexed, they must not be recorded.
+    const bool tracking = tracker_.isTracking();
+    tracker_.stop();
     Group<T>::remove(pos);
+    if (tracking) {
+        tracker_.start();
+        tracker_.erase(ids);
+    }
 }
 
 template<typename T, class Id>
@@ -230,6 +242,16 @@ void Identifiable<T,Id>::removeId(const std::vector<Id>& ids) {
     remove(getElemsId_(ids));
 }
 
+template<typename T, class Id>
+void Identifiable<T,Id>::touchId(const Id id) {
+    touchId(std::vector<Id>(1, id));
+}
+
+template<typename T, class Id>
+void Identifiable<T,Id>::touchId(const std::vector<Id>& ids) {
+    tracker_.touch(ids);
+}
+
 template<typename T, class Id>
 void Identifiable<T,Id>::postprocess_(const std::size_t& firstStep) {
     for(std::size_t i = firstStep; i < this->size(); i++) {
@@ -245,6 +267,14 @@ void Identifiable<T,Id>::postprocess_(const std::size_t& firstStep) {
             throw typename Error::Id::Duplicated<Id>(this->get(i)->getId());
         }
     }
+    if (tracker_.isTracking() && (firstStep < this->size())) {
+        std::vector<Id> ids;
+        ids.reserve(this->size() - firstStep);
+        for (std::size_t i = firstStep; i < this->size(); i++) {
+            ids.push_back(this->get(i)->getId());
+        }
+        tracker_.touch(ids);
+    }
 }
 
 template<typename T, class Id>
@@ -0,0 +1,110 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SEMBA_GROUP_TRACKER_H_
+#define SEMBA_GROUP_TRACKER_H_
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace SEMBA {
+namespace Group {
+
+typedef std::size_t Generation;
+
+// Generations are taken from a single clock so that the ones of different
+// groups can be compared. Generation 0 is before any tracked change.
+inline std::atomic<Generation>& generationClock() {
+    static std::atomic<Generation> clock(0);
+    return clock;
+}
+
+inline Generation getCurrentGeneration() {
+    return generationClock().load();
+}
+
+// Records which ids of a group changed and when. Each change is stamped
+// with a new generation and appended to a journal, so the ids changed
+// after any generation can be retrieved without visiting the group. Besides
+// the journal only a generation per range of rangeSize consecutive ids is
+// kept. The journal can be truncated once old generations are not needed.
+// Trackers are not copied along with the groups owning them, a copy starts
+// with tracking disabled and assignment keeps the state of the target.
+template<class Id>
+class Tracker {
+public:
+    static const std::size_t rangeSize = 1024;
+
+    Tracker();
+    Tracker(const Tracker&);
+    virtual ~Tracker();
+
+    Tracker& operator=(const Tracker&);
+
+    void start();
+    void stop();
+    bool isTracking() const { return tracking_; }
+
+    // Last generation in which this tracker recorded a change.
+    Generation getGeneration() const { return generation_; }
+    // Last generation in which an id of the range holding id changed, 0 if
+    // none did.
+    Generation getRangeGeneration(const Id id) const;
+
+    void touch(const Id id);
+    void touch(const std::vector<Id>& ids);
+    void erase(const std::vector<Id>& ids);
+
+    // Drops the journal up to generation included.
+    void truncate(const Generation generation);
+    // Whether the journal holds all the changes after generation.
+    bool hasJournalAfter(const Generation generation) const;
+
+    // Ids added, modified or removed after generation, ascending. Throws
+    // std::logic_error if the journal was truncated after generation.
+    std::vector<Id> getChanged(const Generation generation) const;
+    // Ids removed after generation and not added again, ascending.
+    std::vector<Id> getRemoved(const Generation generation) const;
+
+private:
+    typedef std::vector<std::pair<Generation, Id>> Journal;
+
+    bool tracking_;
+    Generation generation_;
+    Generation truncated_;
+    std::vector<Generation> ranges_;
+    Journal journal_;
+    Journal removals_;
+
+    void record_(const std::vector<Id>& ids, const bool removed);
+    void check_(const Generation generation) const;
+    static typename Journal::const_iterator after_(
+            const Journal& journal, const Generation generation);
+};
+
+} /* namespace Group */
+} /* namespace SEMBA */
+
+#include "Tracker.hpp"
+
+#endif /* SEMBA_GROUP_TRACKER_H_ */
@@ -0,0 +1,187 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#include "Tracker.h"
+
+#include <algorithm>
+#include <map>
+#include <stdexcept>
+#include <string>
+
+namespace SEMBA {
+namespace Group {
+
+template<class Id>
+Tracker<Id>::Tracker()
+:   tracking_(false),
+    generation_(0),
+    truncated_(0) {
+
+}
+
+template<class Id>
+Tracker<Id>::Tracker(const Tracker&)
+:   tracking_(false),
+    generation_(0),
+    truncated_(0) {
+
+}
+
+template<class Id>
+Tracker<Id>::~Tracker() {
+
+}
+
+template<class Id>
+Tracker<Id>& Tracker<Id>::operator=(const Tracker&) {
+    return *this;
+}
+
+template<class Id>
+void Tracker<Id>::start() {
+    tracking_ = true;
+}
+
+template<class Id>
+void Tracker<Id>::stop() {
+    tracking_ = false;
+}
+
+template<class Id>
+Generation Tracker<Id>::getRangeGeneration(const Id id) const {
+    const std::size_t range = id.toInt() / rangeSize;
+    if (range >= ranges_.size()) {
+        return 0;
+    }
+    return ranges_[range];
+}
+
+template<class Id>
+void Tracker<Id>::touch(const Id id) {
+    touch(std::vector<Id>(1, id));
+}
+
+template<class Id>
+void Tracker<Id>::touch(const std::vector<Id>& ids) {
+    record_(ids, false);
+}
+
+template<class Id>
+void Tracker<Id>::erase(const std::vector<Id>& ids) {
+    record_(ids, true);
+}
+
+template<class Id>
+void Tracker<Id>::truncate(const Generation generation) {
+    journal_.erase(journal_.begin(), after_(journal_, generation));
+    removals_.erase(removals_.begin(), after_(removals_, generation));
+    Journal(journal_).swap(journal_);
+    Journal(removals_).swap(removals_);
+    truncated_ = std::max(truncated_, generation);
+}
+
+template<class Id>
+bool Tracker<Id>::hasJournalAfter(const Generation generation) const {
+    return generation >= truncated_;
+}
+
+template<class Id>
+std::vector<Id> Tracker<Id>::getChanged(const Generation generation) const {
+    check_(generation);
+    typename Journal::const_iterator first = after_(journal_, generation);
+    std::vector<Id> res;
+    res.reserve(journal_.end() - first);
+    for (; first != journal_.end(); ++first) {
+        res.push_back(first->second);
+    }
+    std::sort(res.begin(), res.end());
+    res.erase(std::unique(res.begin(), res.end()), res.end());
+    return res;
+}
+
+template<class Id>
+std::vector<Id> Tracker<Id>::getRemoved(const Generation generation) const {
+    check_(generation);
+    // Last removal of each id, unless it was added again later.
+    std::map<Id, Generation> removed;
+    for (typename Journal::const_iterator it = after_(removals_, generation);
+         it != removals_.end(); ++it) {
+        removed[it->second] = it->first;
+    }
+    for (typename Journal::const_iterator it = after_(journal_, generation);
+         it != journal_.end(); ++it) {
+        typename std::map<Id, Generation>::iterator r =
+            removed.find(it->second);
+        if (r != removed.end() && r->second < it->first) {
+            removed.erase(r);
+        }
+    }
+    std::vector<Id> res;
+    res.reserve(removed.size());
+    for (typename std::map<Id, Generation>::const_iterator
+         it = removed.begin(); it != removed.end(); ++it) {
+        res.push_back(it->first);
+    }
+    return res;
+}
+
+template<class Id>
+void Tracker<Id>::record_(const std::vector<Id>& ids, const bool removed) {
+    if (!tracking_ || ids.empty()) {
+        return;
+    }
+    generation_ = ++generationClock();
+    journal_.reserve(journal_.size() + ids.size());
+    for (std::size_t i = 0; i < ids.size(); i++) {
+        journal_.push_back(std::make_pair(generation_, ids[i]));
+        if (removed) {
+            removals_.push_back(std::make_pair(generation_, ids[i]));
+        }
+        const std::size_t range = ids[i].toInt() / rangeSize;
+        if (range >= ranges_.size()) {
+            ranges_.resize(range + 1, 0);
+        }
+        ranges_[range] = generation_;
+    }
+}
+
+template<class Id>
+void Tracker<Id>::check_(const Generation generation) const {
+    if (!hasJournalAfter(generation)) {
+        throw std::logic_error("Tracker: Changes after generation " +
+                               std::to_string(generation) +
+                               " were truncated");
+    }
+}
+
+template<class Id>
+typename Tracker<Id>::Journal::const_iterator Tracker<Id>::after_(
+        const Journal& journal, const Generation generation) {
+    return std::upper_bound(journal.begin(), journal.end(),
+                            std::make_pair(generation, Id(0)),
+                            [](const std::pair<Generation, Id>& lhs,
+                               const std::pair<Generation, Id>& rhs) {
+                                return lhs.first < rhs.first;
+                            });
+}
+
+} /* namespace Group */
+} /* namespace SEMBA */
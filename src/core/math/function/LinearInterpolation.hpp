@@ -21,7 +21,7 @@
 
 #include "LinearInterpolation.h"
 
-#include <fstream>
+#include "filesystem/InputStream.h"
 
 namespace SEMBA {
 namespace Math {
@@ -105,8 +105,7 @@ void LinearInterpolation<S, T>::initFromFile(
         const std::string& file) {
     static_assert(std::is_same<S, Real>::value, "S must be Real");
     static_assert(std::is_same<T, Real>::value, "T must be Real");
-    std::ifstream iStream;
-    iStream.open(file, std::ifstream::in);
+    FileSystem::InputStream iStream(file);
     if (iStream.fail()) {
         throw std::ios_base::failure(std::string("File: ") + file +
                                      std::string(" does not exist"));
@@ -0,0 +1,77 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#include "LoadOptions.h"
+
+namespace SEMBA {
+namespace Parser {
+
+LoadOptions::LoadOptions(const unsigned sections)
+:   sections_(sections) {
+
+}
+
+bool LoadOptions::isAll() const {
+    return sections_ == allSections && mats_.empty() && layers_.empty();
+}
+
+bool LoadOptions::reads(const Section section) const {
+    switch (section) {
+    case elements:
+        return (sections_ & (elements | coordinates | layers | materials)) ==
+                (elements | coordinates | layers | materials);
+    case connectorOnPoint:
+    case sources:
+    case outputRequests:
+        return (sections_ & section) != 0 && readsAllElements();
+    default:
+        return (sections_ & section) != 0;
+    }
+}
+
+bool LoadOptions::readsAllElements() const {
+    return reads(elements) && mats_.empty() && layers_.empty();
+}
+
+bool LoadOptions::readsMesh() const {
+    return (sections_ & (grids | layers | coordinates | elements)) != 0;
+}
+
+bool LoadOptions::keepsElement(const std::size_t mat,
+                               const std::size_t layer) const {
+    return (mats_.empty() || mats_.count(mat) != 0) &&
+           (layers_.empty() || layers_.count(layer) != 0);
+}
+
+unsigned LoadOptions::getSection(const std::string& key) {
+    static const char* keys[] = {
+            "solverOptions", "materials", "grids", "layers", "coordinates",
+            "elements", "connectorOnPoint", "sources", "outputRequests"};
+    for (std::size_t i = 0; i < sizeof(keys)/sizeof(keys[0]); i++) {
+        if (key == keys[i]) {
+            return 1 << i;
+        }
+    }
+    return 0;
+}
+
+} /* namespace Parser */
+} /* namespace SEMBA */
@@ -0,0 +1,85 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SEMBA_PARSER_LOADOPTIONS_H_
+#define SEMBA_PARSER_LOADOPTIONS_H_
+
+#include <cstddef>
+#include <set>
+#include <string>
+
+namespace SEMBA {
+namespace Parser {
+
+// Parts of a project to be read. Sections which are not selected are
+// skipped without being parsed and read as empty. Elements can also be
+// restricted to those of some materials or layers.
+//
+// Elements need the coordinates, layers and materials they refer to, so
+// they are skipped when any of those is. Connectors, sources and output
+// requests refer to elements by id and are only read when every element
+// is.
+class LoadOptions {
+public:
+    enum Section {
+        solverOptions    = 1 << 0,
+        materials        = 1 << 1,
+        grids            = 1 << 2,
+        layers           = 1 << 3,
+        coordinates      = 1 << 4,
+        elements         = 1 << 5,
+        connectorOnPoint = 1 << 6,
+        sources          = 1 << 7,
+        outputRequests   = 1 << 8,
+        allSections      = (1 << 9) - 1
+    };
+
+    LoadOptions(const unsigned sections = allSections);
+
+    unsigned getSections() const { return sections_; }
+    const std::set<std::size_t>& getMaterials() const { return mats_; }
+    const std::set<std::size_t>& getLayers() const { return layers_; }
+
+    void setSections(const unsigned sections) { sections_ = sections; }
+    // Keeps only the elements with these material or layer ids, where 0
+    // stands for elements without one. An empty set keeps every element.
+    void setMaterials(const std::set<std::size_t>& ids) { mats_ = ids; }
+    void setLayers(const std::set<std::size_t>& ids) { layers_ = ids; }
+
+    bool isAll() const;
+    bool reads(const Section section) const;
+    bool readsAllElements() const;
+    bool readsMesh() const;
+    bool keepsElement(const std::size_t mat, const std::size_t layer) const;
+
+    // Section of a key of a project, 0 for keys which are always read.
+    static unsigned getSection(const std::string& key);
+
+private:
+    unsigned sections_;
+    std::set<std::size_t> mats_;
+    std::set<std::size_t> layers_;
+};
+
+} /* namespace Parser */
+} /* namespace SEMBA */
+
+#endif /* SEMBA_PARSER_LOADOPTIONS_H_ */
@@ -21,6 +21,10 @@
 
 #include "Parser.h"
 
+#include <stdexcept>
+
+#include "filesystem/InputStream.h"
+
 namespace SEMBA {
 namespace Parser {
 
@@ -31,6 +35,14 @@ Parser::~Parser() {
 
 }
 
+Data Parser::readFile(const std::string& filename) const {
+    FileSystem::InputStream stream(filename);
+    if (!stream.is_open()) {
+        throw std::logic_error("Can not open file: " + filename);
+    }
+    return read(stream);
+}
+
 Math::CVecR3 Parser::strToCartesianVector(const std::string& str) {
     std::stringstream iss(str);
     std::string sub;
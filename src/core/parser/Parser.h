@@ -35,6 +35,10 @@ public:
     virtual ~Parser();
 
     virtual Data read(std::istream& inputStream) const = 0;
+    // Reads the file through read, decompressing it on the fly if it is
+    // gzip or zstd compressed. Throws std::logic_error if it can not be
+    // opened.
+    virtual Data readFile(const std::string& filename) const;
 
 protected:
     static inline std::string& trim(std::string &s) {
@@ -0,0 +1,193 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#include "Scanner.h"
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <locale>
+#include <sstream>
+
+namespace SEMBA {
+namespace Parser {
+
+namespace {
+
+// Decimal significands up to this value and powers of ten up to 1e22 are
+// exact doubles, so their product or quotient is correctly rounded.
+const std::uint64_t MaxExactSignificand = std::uint64_t(1) << 53;
+const int MaxExactPower = 22;
+const double Powers[] = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10,
+        1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21,
+        1e22};
+
+inline bool isBlank(const char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' ||
+           c == '\f' || c == '\v';
+}
+
+inline bool isDigit(const char c) {
+    return c >= '0' && c <= '9';
+}
+
+}
+
+Scanner::Scanner(const char* begin, const char* end)
+:   begin_(begin),
+    pos_(begin),
+    end_(end) {
+
+}
+
+Scanner::Scanner(const char* str)
+:   Scanner(str, str + std::strlen(str)) {
+
+}
+
+Scanner::Scanner(const std::string& str)
+:   Scanner(str.data(), str.data() + str.size()) {
+
+}
+
+void Scanner::skipBlanks() {
+    while (pos_ != end_ && isBlank(*pos_)) {
+        pos_++;
+    }
+}
+
+bool Scanner::atEnd() {
+    skipBlanks();
+    return pos_ == end_;
+}
+
+bool Scanner::read(std::size_t& value) {
+    skipBlanks();
+    const char* p = pos_;
+    if (p != end_ && *p == '+') {
+        p++;
+    }
+    if (p == end_ || !isDigit(*p)) {
+        return false;
+    }
+    std::size_t res = 0;
+    const std::size_t max = std::numeric_limits<std::size_t>::max();
+    for (; p != end_ && isDigit(*p); p++) {
+        const std::size_t digit = *p - '0';
+        if (res > (max - digit) / 10) {
+            return false;
+        }
+        res = res * 10 + digit;
+    }
+    if (p != end_ && !isBlank(*p)) {
+        return false;
+    }
+    value = res;
+    pos_ = p;
+    return true;
+}
+
+bool Scanner::read(Math::Real& value) {
+    skipBlanks();
+    const char* p = pos_;
+    bool negative = false;
+    if (p != end_ && (*p == '+' || *p == '-')) {
+        negative = (*p == '-');
+        p++;
+    }
+    std::uint64_t significand = 0;
+    std::size_t digits = 0;
+    int exponent = 0;
+    bool exact = true;
+    for (; p != end_ && isDigit(*p); p++, digits++) {
+        if (significand < MaxExactSignificand / 10) {
+            significand = significand * 10 + (*p - '0');
+        } else {
+            exact = false;
+            exponent++;
+        }
+    }
+    if (p != end_ && *p == '.') {
+        p++;
+        for (; p != end_ && isDigit(*p); p++, digits++) {
+            if (significand < MaxExactSignificand / 10) {
+                significand = significand * 10 + (*p - '0');
+                exponent--;
+            } else {
+                exact = false;
+            }
+        }
+    }
+    if (digits == 0) {
+        return false;
+    }
+    if (p != end_ && (*p == 'e' || *p == 'E')) {
+        p++;
+        bool negativeExponent = false;
+        if (p != end_ && (*p == '+' || *p == '-')) {
+            negativeExponent = (*p == '-');
+            p++;
+        }
+        if (p == end_ || !isDigit(*p)) {
+            return false;
+        }
+        int e = 0;
+        for (; p != end_ && isDigit(*p); p++) {
+            if (e < 100000) {
+                e = e * 10 + (*p - '0');
+            }
+        }
+        exponent += negativeExponent ? -e : e;
+    }
+    if (p != end_ && !isBlank(*p)) {
+        return false;
+    }
+
+    double res;
+    if (exact && exponent >= -MaxExactPower && exponent <= MaxExactPower) {
+        res = static_cast<double>(significand);
+        if (exponent < 0) {
+            res /= Powers[-exponent];
+        } else {
+            res *= Powers[exponent];
+        }
+        if (negative) {
+            res = -res;
+        }
+    } else {
+        // Rare long or extreme values are rounded by the standard library,
+        // in the classic locale as strtod would use the global one. Values
+        // out of the range of doubles are not read.
+        std::istringstream token(std::string(pos_, p));
+        token.imbue(std::locale::classic());
+        token >> res;
+        if (token.fail()) {
+            return false;
+        }
+    }
+    value = res;
+    pos_ = p;
+    return true;
+}
+
+} /* namespace Parser */
+} /* namespace SEMBA */
@@ -0,0 +1,63 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SEMBA_PARSER_SCANNER_H_
+#define SEMBA_PARSER_SCANNER_H_
+
+#include <cstddef>
+#include <string>
+
+#include "math/Types.h"
+
+namespace SEMBA {
+namespace Parser {
+
+// Locale independent scanner of whitespace separated numbers in a range of
+// characters. It neither allocates nor copies the range, which must outlive
+// the scanner. Reads return false, leaving the position at the offending
+// character, when the next token is not a number of the requested kind.
+class Scanner {
+public:
+    Scanner(const char* begin, const char* end);
+    Scanner(const char* str);
+    Scanner(const std::string& str);
+
+    bool read(std::size_t& value);
+    bool read(Math::Real& value);
+
+    // Skips blanks and tells whether there are characters left.
+    bool atEnd();
+    void skipBlanks();
+
+    const char* begin() const { return begin_; }
+    const char* pos  () const { return pos_; }
+    const char* end  () const { return end_; }
+
+private:
+    const char* begin_;
+    const char* pos_;
+    const char* end_;
+};
+
+} /* namespace Parser */
+} /* namespace SEMBA */
+
+#endif /* SEMBA_PARSER_SCANNER_H_ */
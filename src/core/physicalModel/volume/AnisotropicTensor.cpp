@@ -0,0 +1,78 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#include "physicalModel/volume/AnisotropicTensor.h"
+
+namespace SEMBA {
+namespace PhysicalModel {
+namespace Volume {
+
+AnisotropicTensor::AnisotropicTensor(
+        const Id matId,
+        const std::string& name,
+        const Math::MatR33& relativePermittivity,
+        const Math::MatR33& relativePermeability,
+        const Math::MatR33& electricConductivity,
+        const Math::MatR33& magneticConductivity)
+:   Identifiable<Id>(matId),
+    PhysicalModel(name),
+    Anisotropic(Math::Axis::Local()),
+    relativePermittivity_(relativePermittivity),
+    relativePermeability_(relativePermeability),
+    electricConductivity_(electricConductivity),
+    magneticConductivity_(magneticConductivity) {
+
+}
+
+AnisotropicTensor::AnisotropicTensor(const AnisotropicTensor& rhs)
+:   Identifiable<Id>(rhs),
+    PhysicalModel(rhs),
+    Anisotropic(rhs),
+    relativePermittivity_(rhs.relativePermittivity_),
+    relativePermeability_(rhs.relativePermeability_),
+    electricConductivity_(rhs.electricConductivity_),
+    magneticConductivity_(rhs.magneticConductivity_) {
+
+}
+
+AnisotropicTensor::~AnisotropicTensor() {
+
+}
+
+Math::MatR33 AnisotropicTensor::getRelPermittivityMatR() const {
+    return relativePermittivity_;
+}
+
+Math::MatR33 AnisotropicTensor::getRelPermeabilityMatR() const {
+    return relativePermeability_;
+}
+
+Math::MatR33 AnisotropicTensor::getElectricConductivityMat() const {
+    return electricConductivity_;
+}
+
+Math::MatR33 AnisotropicTensor::getMagneticConductivityMat() const {
+    return magneticConductivity_;
+}
+
+} /* namespace Volume */
+} /* namespace PhysicalModel */
+} /* namespace SEMBA */
@@ -0,0 +1,63 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SEMBA_PHYSICALMODEL_VOLUMEANISOTROPICTENSOR_H_
+#define SEMBA_PHYSICALMODEL_VOLUMEANISOTROPICTENSOR_H_
+
+#include <physicalModel/volume/Anisotropic.h>
+
+namespace SEMBA {
+namespace PhysicalModel {
+namespace Volume {
+
+// Anisotropic medium given by its full tensors in global axes, as the
+// effective media obtained averaging materials within a cell.
+class AnisotropicTensor: public Anisotropic {
+public:
+    AnisotropicTensor(
+            const Id matId,
+            const std::string& name,
+            const Math::MatR33& relativePermittivity,
+            const Math::MatR33& relativePermeability,
+            const Math::MatR33& electricConductivity = Math::MatR33(),
+            const Math::MatR33& magneticConductivity = Math::MatR33());
+    AnisotropicTensor(const AnisotropicTensor&);
+    virtual ~AnisotropicTensor();
+
+    SEMBA_CLASS_DEFINE_CLONE(AnisotropicTensor);
+
+    Math::MatR33 getRelPermittivityMatR() const;
+    Math::MatR33 getRelPermeabilityMatR() const;
+    Math::MatR33 getElectricConductivityMat() const;
+    Math::MatR33 getMagneticConductivityMat() const;
+
+private:
+    Math::MatR33 relativePermittivity_;
+    Math::MatR33 relativePermeability_;
+    Math::MatR33 electricConductivity_;
+    Math::MatR33 magneticConductivity_;
+};
+
+} /* namespace Volume */
+} /* namespace PhysicalModel */
+} /* namespace SEMBA */
+
+#endif /* SEMBA_PHYSICALMODEL_VOLUMEANISOTROPICTENSOR_H_ */
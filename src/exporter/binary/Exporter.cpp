@@ -0,0 +1,210 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#include "Exporter.h"
+
+#include <cstring>
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+namespace SEMBA {
+namespace Exporter {
+namespace Binary {
+
+namespace {
+
+const std::size_t ChunkSize = 1 << 20;
+
+std::uint64_t align(const std::uint64_t offset) {
+    return (offset + Alignment - 1) / Alignment * Alignment;
+}
+
+// Contents of one index section, ready to be written. Raw arrays are
+// written straight from the dense mesh storage.
+struct Encoded {
+    const void* data;
+    std::vector<char> buffer;
+    std::uint64_t bytes;
+    std::uint64_t count;
+};
+
+void encodeRaw(const std::vector<Geometry::Mesh::Dense::Index>& values,
+               Encoded& res) {
+    res.count = values.size();
+    res.bytes = res.count * sizeof(Geometry::Mesh::Dense::Index);
+    res.data = values.data();
+}
+
+// Chunks are encoded concurrently and their runs are then merged in order,
+// joining the runs that continue across chunk boundaries.
+void encodeRLE(const std::vector<Geometry::Mesh::Dense::Index>& values,
+               Encoded& res) {
+    typedef Geometry::Mesh::Dense::Index Index;
+    const long long numChunks = (values.size() + ChunkSize - 1) / ChunkSize;
+    std::vector<std::vector<std::uint64_t>> ends(numChunks);
+    std::vector<std::vector<Index>> runs(numChunks);
+#pragma omp parallel for
+    for (long long c = 0; c < numChunks; c++) {
+        const std::size_t first = c * ChunkSize;
+        const std::size_t last = std::min(first + ChunkSize, values.size());
+        for (std::size_t i = first; i < last; i++) {
+            if (runs[c].empty() || runs[c].back() != values[i]) {
+                runs[c].push_back(values[i]);
+                ends[c].push_back(i + 1);
+            } else {
+                ends[c].back() = i + 1;
+            }
+        }
+    }
+    std::vector<std::uint64_t> allEnds;
+    std::vector<Index> allRuns;
+    for (long long c = 0; c < numChunks; c++) {
+        std::size_t r = 0;
+        if (!allRuns.empty() && allRuns.back() == runs[c].front()) {
+            allEnds.back() = ends[c].front();
+            r = 1;
+        }
+        allEnds.insert(allEnds.end(), ends[c].begin() + r, ends[c].end());
+        allRuns.insert(allRuns.end(), runs[c].begin() + r, runs[c].end());
+    }
+    res.count = allRuns.size();
+    res.bytes = res.count * (sizeof(std::uint64_t) + sizeof(Index));
+    res.buffer.resize(res.bytes);
+    if (res.count > 0) {
+        std::memcpy(res.buffer.data(), allEnds.data(),
+                    res.count * sizeof(std::uint64_t));
+        std::memcpy(res.buffer.data() + res.count * sizeof(std::uint64_t),
+                    allRuns.data(), res.count * sizeof(Index));
+    }
+    res.data = res.buffer.data();
+}
+
+}
+
+Exporter::Exporter(const Data* smb,
+                   const std::string& fn,
+                   const unsigned flags)
+:   SEMBA::Exporter::Exporter(fn) {
+    if (smb->mesh == nullptr ||
+        !smb->mesh->is<Geometry::Mesh::Structured>()) {
+        throw std::logic_error(
+                "Binary exporter needs a structured mesh.");
+    }
+    const Geometry::Mesh::Dense dense(
+            *smb->mesh->castTo<Geometry::Mesh::Structured>());
+    write(dense, getFilename() + ".bin", flags);
+}
+
+Exporter::~Exporter() {
+
+}
+
+void Exporter::write(const Geometry::Mesh::Dense& dense,
+                     const std::string& filename,
+                     const unsigned flags) {
+    Header header;
+    std::memset(&header, 0, sizeof(Header));
+    std::memcpy(header.magic, Magic, sizeof(Magic));
+    header.version = Version;
+    header.flags = flags;
+    header.indexBytes = sizeof(Geometry::Mesh::Dense::Index);
+
+    std::vector<double> pos[3];
+    for (std::size_t d = 0; d < 3; d++) {
+        const std::vector<Math::Real>& gridPos = dense.grid().getPos(d);
+        pos[d].assign(gridPos.begin(), gridPos.end());
+        header.numNodes[d] = pos[d].size();
+    }
+
+    const Geometry::Mesh::MaterialTable& table = dense.materials();
+    std::vector<MaterialEntry> entries(table.size() + 1);
+    std::memset(entries.data(), 0, entries.size() * sizeof(MaterialEntry));
+    for (std::size_t i = 1; i < entries.size(); i++) {
+        const Geometry::Element::Model* model = table.getModel(i);
+        const Geometry::Layer::Layer* layer = table.getLayer(i);
+        if (model != nullptr) {
+            entries[i].matId = model->getId().toInt();
+        }
+        if (layer != nullptr) {
+            entries[i].layerId = layer->getId().toInt();
+        }
+    }
+
+    const std::vector<Geometry::Mesh::Dense::Index>* values[7];
+    values[0] = &dense.cells();
+    for (std::size_t d = 0; d < 3; d++) {
+        values[1+d] = &dense.faces(d);
+        values[4+d] = &dense.edges(d);
+    }
+    Encoded encoded[7];
+    for (std::size_t s = 0; s < 7; s++) {
+        if (flags & rle) {
+            encodeRLE(*values[s], encoded[s]);
+        } else {
+            encodeRaw(*values[s], encoded[s]);
+        }
+    }
+
+    const void* data[numSections];
+    std::uint64_t offset = sizeof(Header);
+    for (std::size_t s = 0; s < numSections; s++) {
+        Section& section = header.sections[s];
+        if (s <= gridZ) {
+            data[s] = pos[s].data();
+            section.count = pos[s].size();
+            section.bytes = section.count * sizeof(double);
+        } else if (s == materials) {
+            data[s] = entries.data();
+            section.count = entries.size();
+            section.bytes = section.count * sizeof(MaterialEntry);
+        } else {
+            data[s] = encoded[s-cells].data;
+            section.count = encoded[s-cells].count;
+            section.bytes = encoded[s-cells].bytes;
+        }
+        offset = align(offset);
+        section.offset = offset;
+        offset += section.bytes;
+    }
+
+    std::ofstream file(filename.c_str(), std::ios::out | std::ios::binary);
+    if (!file.is_open()) {
+        throw std::logic_error("Can not open file: " + filename);
+    }
+    const std::vector<char> padding(Alignment, 0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+    std::uint64_t written = sizeof(Header);
+    for (std::size_t s = 0; s < numSections; s++) {
+        const Section& section = header.sections[s];
+        file.write(padding.data(), section.offset - written);
+        file.write(static_cast<const char*>(data[s]), section.bytes);
+        written = section.offset + section.bytes;
+    }
+    if (!file) {
+        throw std::logic_error("Error writing file: " + filename);
+    }
+}
+
+} /* namespace Binary */
+} /* namespace Exporter */
+} /* namespace SEMBA */
@@ -0,0 +1,56 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SEMBA_EXPORTER_BINARY_EXPORTER_H_
+#define SEMBA_EXPORTER_BINARY_EXPORTER_H_
+
+#include <string>
+
+#include "exporter/Exporter.h"
+#include "geometry/mesh/Dense.h"
+#include "Data.h"
+
+#include "Format.h"
+
+namespace SEMBA {
+namespace Exporter {
+namespace Binary {
+
+// Writes the cell, face and edge materials of a structured mesh to
+// fn + ".bin" with the layout described in Format.h. Flags is a combination
+// of Flag values: rle run length encodes the index arrays.
+class Exporter : public SEMBA::Exporter::Exporter {
+public:
+    Exporter(const Data* smb,
+             const std::string& fn,
+             const unsigned flags = 0);
+    virtual ~Exporter();
+
+    static void write(const Geometry::Mesh::Dense& dense,
+                      const std::string& filename,
+                      const unsigned flags = 0);
+};
+
+} /* namespace Binary */
+} /* namespace Exporter */
+} /* namespace SEMBA */
+
+#endif /* SEMBA_EXPORTER_BINARY_EXPORTER_H_ */
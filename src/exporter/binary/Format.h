@@ -0,0 +1,94 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SEMBA_EXPORTER_BINARY_FORMAT_H_
+#define SEMBA_EXPORTER_BINARY_FORMAT_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace SEMBA {
+namespace Exporter {
+namespace Binary {
+
+// Layout of the cell material files. The file starts with a Header followed
+// by the sections it points to, each one starting at a multiple of Alignment
+// so that a solver can mmap the file and use the arrays in place. Integers
+// and reals are stored with the byte order of the writing host.
+//
+// - Grid sections hold numNodes[d] doubles with the grid line positions.
+// - The material section holds one MaterialEntry per index of the table,
+//   entry 0 being the empty one with both ids 0.
+// - Cells, faces with normal d and edges along d hold one index per grid
+//   node in (i,j,k) row major order, addressed by its lower node. Indices
+//   are indexBytes wide, currently the two bytes of a material table index.
+//   Face and edge sections with count 0 are entirely empty.
+// - With the rle flag each index section holds instead count run ends
+//   (std::uint64_t, exclusive and increasing) followed by count indices.
+enum SectionId {
+    gridX = 0,
+    gridY,
+    gridZ,
+    materials,
+    cells,
+    facesX,
+    facesY,
+    facesZ,
+    edgesX,
+    edgesY,
+    edgesZ,
+    numSections
+};
+
+enum Flag {
+    rle = 1
+};
+
+static const char          Magic[8]  = {'S','M','B','C','E','L','L','S'};
+static const std::uint32_t Version   = 1;
+static const std::size_t   Alignment = 64;
+
+struct Section {
+    std::uint64_t offset;
+    std::uint64_t bytes;
+    std::uint64_t count;
+};
+
+struct Header {
+    char          magic[8];
+    std::uint32_t version;
+    std::uint32_t flags;
+    std::uint32_t indexBytes;
+    std::uint32_t reserved;
+    std::uint64_t numNodes[3];
+    Section       sections[numSections];
+};
+
+struct MaterialEntry {
+    std::uint64_t matId;
+    std::uint64_t layerId;
+};
+
+} /* namespace Binary */
+} /* namespace Exporter */
+} /* namespace SEMBA */
+
+#endif /* SEMBA_EXPORTER_BINARY_FORMAT_H_ */
@@ -21,6 +21,10 @@
 
 #include "Exporter.h"
 
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+
 #include "geometry/mesh/Unstructured.h"
 #include "geometry/element/Triangle.h"
 #include "geometry/element/Quadrilateral.h"
@@ -40,11 +44,22 @@ namespace VTK {
 
 Exporter::Exporter(const Data* smb,
                    const std::string& fn)
-:   SEMBA::Exporter::Exporter(fn) {
+:   SEMBA::Exporter::Exporter(fn),
+    incremental_(false) {
     initDir_(fn + ".vtk");
     writeMesh_(smb);
 }
 
+Exporter::Exporter(const Data* smb,
+                   const std::string& fn,
+                   const Group::Generation generation)
+:   SEMBA::Exporter::Exporter(fn),
+    incremental_(true) {
+    initDir_(fn + ".vtk");
+    initChanges_(smb->mesh, generation);
+    writeMesh_(smb);
+}
+
 Exporter::~Exporter() {
 
 }
@@ -94,7 +109,7 @@ void Exporter::writeMesh_(const Data* smb) {
                                          "@" + lay(i)->getName();
                 Group::Group<const Geometry::ElemR> elem = 
                     mesh->elems().getMatLayerId(matId, layId);
-                writeFile_(elem, makeValid_(name), outFile, part);
+                writeFile_(elem, makeValid_(name), outFile, part, true);
             }
         }
     } else {
@@ -103,7 +118,7 @@ void Exporter::writeMesh_(const Data* smb) {
             Group::Group<const Geometry::ElemR> elem =
                 mesh->elems().getLayerId(layId);
             const std::string name = preName + lay(i)->getName();
-            writeFile_(elem, makeValid_(name), outFile, part);
+            writeFile_(elem, makeValid_(name), outFile, part, true);
         }
     }
     // Writes EM Sources.
@@ -155,11 +170,47 @@ void Exporter::writeMesh_(const Data* smb) {
     delete mesh;
 }
 
+void Exporter::initChanges_(const Geometry::Mesh::Mesh* mesh,
+                            const Group::Generation generation) {
+    const Group::Tracker<Geometry::ElemId>*  elemTracker;
+    const Group::Tracker<Geometry::CoordId>* coordTracker;
+    if (mesh->is<Geometry::Mesh::Structured>()) {
+        const Geometry::Mesh::Structured* str =
+            mesh->castTo<Geometry::Mesh::Structured>();
+        elemTracker  = &str->elems ().tracker();
+        coordTracker = &str->coords().tracker();
+    } else {
+        const Geometry::Mesh::Unstructured* uns =
+            mesh->castTo<Geometry::Mesh::Unstructured>();
+        elemTracker  = &uns->elems ().tracker();
+        coordTracker = &uns->coords().tracker();
+    }
+    if (!elemTracker->isTracking() || !coordTracker->isTracking()) {
+        throw std::logic_error("VTK: Change tracking is not enabled");
+    }
+    // Without the journal of the changes all the files are written again.
+    if (!elemTracker->hasJournalAfter(generation) ||
+        !coordTracker->hasJournalAfter(generation)) {
+        incremental_ = false;
+        return;
+    }
+    const std::vector<Geometry::ElemId> elemIds =
+        elemTracker->getChanged(generation);
+    const std::vector<Geometry::CoordId> coordIds =
+        coordTracker->getChanged(generation);
+    changedElems_.insert(elemIds.begin(), elemIds.end());
+    changedCoords_.insert(coordIds.begin(), coordIds.end());
+}
+
 void Exporter::writeFile_(const Group::Group<const Geometry::ElemR>& elems,
                           const std::string& name,
                           std::ofstream& outMain,
-                          std::size_t& part) {
+                          std::size_t& part,
+                          const bool onlyIfModified) {
+    std::string filename = getFilename() + ".vtk" + Separator + name + ".vtu";
     if (elems.empty()) {
+        // Empty parts have no file, not even one left by a previous export.
+        std::remove(filename.c_str());
         return;
     }
     outMain << "    " << "<DataSet "
@@ -169,7 +220,9 @@ void Exporter::writeFile_(const Group::Group<const Geometry::ElemR>& elems,
             << getBasename() + ".vtk" + Separator + name + ".vtu" << "\" "
             << "/>" << std::endl;
 
-    std::string filename = getFilename() + ".vtk" + Separator + name + ".vtu";
+    if (incremental_ && onlyIfModified && !isModified_(elems, filename)) {
+        return;
+    }
     std::ofstream outFile(filename.c_str());
     outFile << "<VTKFile "
             << "type=\"UnstructuredGrid\" "
@@ -190,6 +243,38 @@ void Exporter::writeFile_(const Group::Group<const Geometry::ElemR>& elems,
     outFile.close();
 }
 
+bool Exporter::isModified_(const Group::Group<const Geometry::ElemR>& elems,
+                           const std::string& filename) const {
+    // Elements which left the part without other changes only show in the
+    // number of cells of the previous file.
+    std::ifstream inFile(filename.c_str());
+    std::string line;
+    std::size_t numberOfCells = elems.size() + 1;
+    while (std::getline(inFile, line)) {
+        const std::string tag = "NumberOfCells=\"";
+        const std::size_t pos = line.find(tag);
+        if (pos != std::string::npos) {
+            numberOfCells = std::strtoul(line.c_str() + pos + tag.size(),
+                                         nullptr, 10);
+            break;
+        }
+    }
+    if (numberOfCells != elems.size()) {
+        return true;
+    }
+    for (std::size_t i = 0; i < elems.size(); i++) {
+        if (changedElems_.count(elems(i)->getId()) != 0) {
+            return true;
+        }
+        for (std::size_t j = 0; j < elems(i)->numberOfCoordinates(); j++) {
+            if (changedCoords_.count(elems(i)->getV(j)->getId()) != 0) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
 std::pair<std::vector<Math::CVecR3>, std::map<Geometry::CoordId, std::size_t>>
     Exporter::getPoints_(
         const Group::Group<const Geometry::ElemR>& elems) {
@@ -23,6 +23,7 @@
 #define SEMBA_EXPORTER_VTK_EXPORTER_H_
 
 #include <fstream>
+#include <set>
 #include <utility>
 #include <algorithm>
 
@@ -37,9 +38,21 @@ class Exporter : public SEMBA::Exporter::Exporter {
 public:
     Exporter(const Data* smb,
                 const std::string& fn);
+    // Only writes again the files of the material parts which have an
+    // element or coordinate changed after generation, or whose number of
+    // cells differs from the one in the existing file. Change tracking must
+    // be enabled in the mesh groups before those changes. All the files are
+    // written if the journal after generation was truncated.
+    Exporter(const Data* smb,
+             const std::string& fn,
+             const Group::Generation generation);
     virtual ~Exporter();
 
 private:
+    bool incremental_;
+    std::set<Geometry::ElemId>  changedElems_;
+    std::set<Geometry::CoordId> changedCoords_;
+
     enum CELL_TYPES {
         VTK_VERTEX               = 1,
         VTK_POLY_VERTEX          = 2,
@@ -62,10 +75,15 @@ private:
         VTK_QUADRATIC_HEXAHEDRON = 25
     };
     void writeMesh_(const Data* smb);
+    void initChanges_(const Geometry::Mesh::Mesh* mesh,
+                      const Group::Generation generation);
     void writeFile_(const Group::Group<const Geometry::ElemR>& elems,
                     const std::string& name,
                     std::ofstream& outMain,
-                    std::size_t& part);
+                    std::size_t& part,
+                    const bool onlyIfModified = false);
+    bool isModified_(const Group::Group<const Geometry::ElemR>& elems,
+                     const std::string& filename) const;
     std::pair<std::vector<Math::CVecR3>, 
               std::map<Geometry::CoordId, std::size_t>> getPoints_(
               const Group::Group<const Geometry::ElemR>& elems);
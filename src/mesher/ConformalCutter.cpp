@@ -0,0 +1,409 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#include "ConformalCutter.h"
+
+#include <algorithm>
+#include <exception>
+#include <set>
+#include <typeindex>
+#include <utility>
+
+#include "geometry/element/Triangle.h"
+#include "geometry/element/Quadrilateral4.h"
+
+namespace SEMBA {
+namespace Mesher {
+
+namespace {
+
+typedef std::pair<std::size_t, Math::CVecI3> Face;
+
+bool isLexLower(const Math::CVecR3& lhs, const Math::CVecR3& rhs) {
+    for (std::size_t d = 0; d < 3; d++) {
+        if (lhs(d) != rhs(d)) {
+            return lhs(d) < rhs(d);
+        }
+    }
+    return false;
+}
+
+bool isLexLower(const Math::CVecI3& lhs, const Math::CVecI3& rhs) {
+    for (std::size_t d = 0; d < 3; d++) {
+        if (lhs(d) != rhs(d)) {
+            return lhs(d) < rhs(d);
+        }
+    }
+    return false;
+}
+
+// Twice the signed area of the triangle (p, q, x) projected on the plane
+// spanned by axes a and b. Shared edges are always evaluated from their
+// lexicographically lower vertex, so neighbouring triangles get exactly
+// opposite values and a point on the edge is never missed by both.
+Math::Real getEdgeFunction(const Math::CVecR3& p, const Math::CVecR3& q,
+                           const Math::Real xa, const Math::Real xb,
+                           const std::size_t a, const std::size_t b) {
+    if (isLexLower(q, p)) {
+        return -getEdgeFunction(q, p, xa, xb, a, b);
+    }
+    return (q(a) - p(a))*(xb - p(b)) - (q(b) - p(b))*(xa - p(a));
+}
+
+// Position along d of the point of the edge (p, q) which projects on
+// (xa, xb) in the plane of axes a and b. It is also computed from the lower
+// vertex, so both triangles sharing the edge get exactly the same value.
+Math::Real getEdgePos(const Math::CVecR3& p, const Math::CVecR3& q,
+                      const Math::Real xa, const Math::Real xb,
+                      const std::size_t a, const std::size_t b,
+                      const std::size_t d) {
+    if (isLexLower(q, p)) {
+        return getEdgePos(q, p, xa, xb, a, b, d);
+    }
+    const Math::Real ea = q(a) - p(a);
+    const Math::Real eb = q(b) - p(b);
+    const Math::Real t =
+        (ea*(xa - p(a)) + eb*(xb - p(b))) / (ea*ea + eb*eb);
+    return p(d) + t*(q(d) - p(d));
+}
+
+} /* namespace */
+
+bool ConformalCutter::Cut::operator<(const Cut& rhs) const {
+    if (node != rhs.node) {
+        return isLexLower(node, rhs.node);
+    }
+    if (dir != rhs.dir) {
+        return dir < rhs.dir;
+    }
+    return length < rhs.length;
+}
+
+bool ConformalCutter::Cut::operator==(const Cut& rhs) const {
+    return (node == rhs.node) && (dir == rhs.dir) && (length == rhs.length);
+}
+
+ConformalCutter::ConformalCutter(const Geometry::Grid3& grid)
+:   grid_(grid),
+    tolerance_(1e-6) {
+
+}
+
+std::map<MatId, ConformalCutter::Cuts> ConformalCutter::cut(
+        const Geometry::Mesh::Unstructured& mesh) const {
+    const std::vector<Triangle> tris = getTriangles_(mesh);
+
+    // Triangles are cut in batches whose results are merged in order, so
+    // the output does not depend on the number of threads.
+    const std::size_t batchSize = 1024;
+    const std::size_t nBatches = (tris.size() + batchSize - 1) / batchSize;
+    std::vector<std::vector<std::pair<MatId, Cut>>> batchCuts(nBatches);
+    std::vector<std::vector<Line>> batchLines(nBatches);
+    std::exception_ptr error;
+    long long errorBatch = nBatches;
+#pragma omp parallel for schedule(dynamic)
+    for (long long b = 0; b < (long long) nBatches; b++) {
+        try {
+            const std::size_t end =
+                std::min<std::size_t>((b+1)*batchSize, tris.size());
+            std::vector<Cut> cuts;
+            for (std::size_t t = b*batchSize; t < end; t++) {
+                cuts.clear();
+                cutTriangle_(tris[t], cuts);
+                const MatId matId = tris[t].elem->getMatId();
+                for (std::size_t i = 0; i < cuts.size(); i++) {
+                    batchCuts[b].push_back(std::make_pair(matId, cuts[i]));
+                }
+                joinCuts_(tris[t], cuts, batchLines[b]);
+            }
+        } catch (...) {
+#pragma omp critical (ConformalCutterCut)
+            {
+                if (b < errorBatch) {
+                    errorBatch = b;
+                    error = std::current_exception();
+                }
+            }
+        }
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+
+    std::map<MatId, std::vector<Cut>> matCuts;
+    for (std::size_t b = 0; b < nBatches; b++) {
+        for (std::size_t i = 0; i < batchCuts[b].size(); i++) {
+            matCuts[batchCuts[b][i].first].push_back(batchCuts[b][i].second);
+        }
+        std::vector<std::pair<MatId, Cut>>().swap(batchCuts[b]);
+    }
+
+    std::map<MatId, Cuts> res;
+    for (std::map<MatId, std::vector<Cut>>::iterator
+         it = matCuts.begin(); it != matCuts.end(); ++it) {
+        std::vector<Cut>& cuts = it->second;
+        std::sort(cuts.begin(), cuts.end());
+        cuts.erase(std::unique(cuts.begin(), cuts.end()), cuts.end());
+        std::vector<Geometry::CoordConf*> coords;
+        coords.reserve(cuts.size());
+        for (std::size_t i = 0; i < cuts.size(); i++) {
+            coords.push_back(
+                new Geometry::CoordConf(Geometry::CoordId(i+1),
+                                        cuts[i].node,
+                                        cuts[i].dir,
+                                        cuts[i].length));
+        }
+        res[it->first].coords.add(coords);
+    }
+
+    // Adjacent triangles, as the halves of a quadrilateral, may join the
+    // same pair of cuts; only the first line is kept.
+    std::map<MatId, std::set<std::pair<std::size_t, std::size_t>>> joined;
+    for (std::size_t b = 0; b < nBatches; b++) {
+        for (std::size_t i = 0; i < batchLines[b].size(); i++) {
+            const Line& line = batchLines[b][i];
+            const std::vector<Cut>& cuts = matCuts[line.matId];
+            std::size_t pos[2];
+            for (std::size_t j = 0; j < 2; j++) {
+                pos[j] = std::lower_bound(cuts.begin(), cuts.end(),
+                                          line.cuts[j]) - cuts.begin();
+            }
+            if (!joined[line.matId].insert(
+                    std::make_pair(pos[0], pos[1])).second) {
+                continue;
+            }
+            Cuts& matRes = res[line.matId];
+            const Geometry::CoordI3* v[2] = {matRes.coords(pos[0]),
+                                             matRes.coords(pos[1])};
+            matRes.lines.add(new Geometry::LinConf(
+                    Geometry::ElemId(matRes.lines.size()+1), v, line.norm,
+                    line.elem->getLayer(), line.elem->getModel()));
+        }
+    }
+    return res;
+}
+
+std::vector<ConformalCutter::Triangle> ConformalCutter::getTriangles_(
+        const Geometry::Mesh::Unstructured& mesh) const {
+    std::vector<Triangle> res;
+    std::map<std::type_index, std::size_t> numberOfCorners;
+    for (std::size_t i = 0; i < mesh.elems().size(); i++) {
+        const Geometry::ElemR* elem = mesh.elems()(i);
+        const std::type_index type(typeid(*elem));
+        std::map<std::type_index, std::size_t>::const_iterator it =
+            numberOfCorners.find(type);
+        if (it == numberOfCorners.end()) {
+            std::size_t corners = 0;
+            if (elem->is<Geometry::Tri>()) {
+                corners = 3;
+            } else if (elem->is<Geometry::QuaR4>()) {
+                corners = 4;
+            }
+            it = numberOfCorners.insert(std::make_pair(type, corners)).first;
+        }
+        if (it->second < 3) {
+            continue;
+        }
+        // Quadrilaterals are split along their 0-2 diagonal.
+        for (std::size_t s = 0; s + 2 < it->second; s++) {
+            Triangle tri;
+            tri.v[0] = elem->getVertex(0)->pos();
+            tri.v[1] = elem->getVertex(s+1)->pos();
+            tri.v[2] = elem->getVertex(s+2)->pos();
+            tri.elem = elem;
+            res.push_back(tri);
+        }
+    }
+    return res;
+}
+
+void ConformalCutter::cutTriangle_(const Triangle& tri,
+                                   std::vector<Cut>& cuts) const {
+    for (std::size_t d = 0; d < 3; d++) {
+        const std::size_t a = (d+1)%3;
+        const std::size_t b = (d+2)%3;
+        const Math::CVecR3* v = tri.v;
+        const Math::Real area = getEdgeFunction(v[0], v[1],
+                                                v[2](a), v[2](b), a, b);
+        if (area == 0.0) {
+            // Grazing: the triangle contains the lines along d that reach
+            // it, their cuts are found on the neighbouring triangles.
+            continue;
+        }
+        const std::vector<Math::Real>& posA = grid_.getPos(a);
+        const std::vector<Math::Real>& posB = grid_.getPos(b);
+        Math::Real min[3], max[3];
+        for (std::size_t k = 0; k < 3; k++) {
+            min[k] = std::min(std::min(v[0](k), v[1](k)), v[2](k));
+            max[k] = std::max(std::max(v[0](k), v[1](k)), v[2](k));
+        }
+        const std::size_t iBegin =
+            std::lower_bound(posA.begin(), posA.end(), min[a]) - posA.begin();
+        const std::size_t iEnd =
+            std::upper_bound(posA.begin(), posA.end(), max[a]) - posA.begin();
+        const std::size_t jBegin =
+            std::lower_bound(posB.begin(), posB.end(), min[b]) - posB.begin();
+        const std::size_t jEnd =
+            std::upper_bound(posB.begin(), posB.end(), max[b]) - posB.begin();
+        for (std::size_t i = iBegin; i < iEnd; i++) {
+            for (std::size_t j = jBegin; j < jEnd; j++) {
+                Math::Real w[3];
+                bool inside = true;
+                std::size_t onEdges = 0, edges = 0;
+                for (std::size_t k = 0; k < 3 && inside; k++) {
+                    w[k] = getEdgeFunction(v[(k+1)%3], v[(k+2)%3],
+                                           posA[i], posB[j], a, b) / area;
+                    inside = (w[k] >= 0.0);
+                    if (w[k] == 0.0) {
+                        onEdges++;
+                        edges += k;
+                    }
+                }
+                if (!inside) {
+                    continue;
+                }
+                // Hits on edges and vertices are also found by the
+                // neighbouring triangles, they are computed only from the
+                // shared edge or vertex to get identical cuts.
+                Math::Real pos;
+                if (onEdges == 2) {
+                    pos = v[3 - edges](d);
+                } else if (onEdges == 1) {
+                    pos = getEdgePos(v[(edges+1)%3], v[(edges+2)%3],
+                                     posA[i], posB[j], a, b, d);
+                } else {
+                    pos = (w[0]*v[0](d) + w[1]*v[1](d) + w[2]*v[2](d)) /
+                          (w[0] + w[1] + w[2]);
+                }
+                pos = std::min(std::max(pos, min[d]), max[d]);
+                Cut cut;
+                cut.node(a) = i;
+                cut.node(b) = j;
+                if (!locate_(d, pos, cut.node(d), cut.length)) {
+                    continue;
+                }
+                cut.dir = (cut.length == 0.0) ?
+                    Math::Constants::x : Math::Constants::CartesianAxis(d);
+                cuts.push_back(cut);
+            }
+        }
+    }
+    // Vertex hits are found along several directions.
+    std::sort(cuts.begin(), cuts.end());
+    cuts.erase(std::unique(cuts.begin(), cuts.end()), cuts.end());
+}
+
+bool ConformalCutter::locate_(const std::size_t dir,
+                              const Math::Real pos,
+                              Math::Int& node,
+                              Math::Real& length) const {
+    const std::vector<Math::Real>& gridPos = grid_.getPos(dir);
+    if (gridPos.empty() || pos < gridPos.front() || pos > gridPos.back()) {
+        return false;
+    }
+    std::size_t k =
+        std::upper_bound(gridPos.begin(), gridPos.end(), pos) -
+        gridPos.begin() - 1;
+    length = 0.0;
+    if (k + 1 < gridPos.size()) {
+        length = (pos - gridPos[k]) / (gridPos[k+1] - gridPos[k]);
+        if (length < tolerance_) {
+            length = 0.0;
+        } else if (length > 1.0 - tolerance_) {
+            length = 0.0;
+            k++;
+        }
+    }
+    node = k;
+    return true;
+}
+
+void ConformalCutter::joinCuts_(const Triangle& tri,
+                                const std::vector<Cut>& cuts,
+                                std::vector<Line>& lines) const {
+    Math::Int numCells[3];
+    for (std::size_t d = 0; d < 3; d++) {
+        numCells[d] = grid_.getPos(d).size() - 1;
+    }
+    // Lists the faces whose boundary contains each cut. A cut inside an
+    // edge lies on the four faces around it, a cut on a node on twelve.
+    std::vector<std::pair<Face, std::size_t>> faces;
+    for (std::size_t c = 0; c < cuts.size(); c++) {
+        const Cut& cut = cuts[c];
+        const bool onNode = (cut.length == 0.0);
+        for (std::size_t n = 0; n < 3; n++) {
+            if (!onNode && (n == std::size_t(cut.dir))) {
+                continue;
+            }
+            const std::size_t u = (n+1)%3;
+            const std::size_t v = (n+2)%3;
+            const bool alongU = !onNode && (u == std::size_t(cut.dir));
+            const bool alongV = !onNode && (v == std::size_t(cut.dir));
+            for (Math::Int du = (alongU ? 0 : -1); du <= 0; du++) {
+                for (Math::Int dv = (alongV ? 0 : -1); dv <= 0; dv++) {
+                    Math::CVecI3 cell = cut.node;
+                    cell(u) += du;
+                    cell(v) += dv;
+                    if (cell(u) < 0 || cell(u) >= numCells[u] ||
+                        cell(v) < 0 || cell(v) >= numCells[v]) {
+                        continue;
+                    }
+                    faces.push_back(std::make_pair(Face(n, cell), c));
+                }
+            }
+        }
+    }
+    std::sort(faces.begin(), faces.end(),
+              [](const std::pair<Face, std::size_t>& lhs,
+                 const std::pair<Face, std::size_t>& rhs) {
+        if (lhs.first.first != rhs.first.first) {
+            return lhs.first.first < rhs.first.first;
+        }
+        if (lhs.first.second != rhs.first.second) {
+            return isLexLower(lhs.first.second, rhs.first.second);
+        }
+        return lhs.second < rhs.second;
+    });
+    Math::CVecR3 norm = (tri.v[1] - tri.v[0]) ^ (tri.v[2] - tri.v[0]);
+    if (norm.norm() != 0.0) {
+        norm.normalize();
+    }
+    for (std::size_t i = 0; i < faces.size(); ) {
+        std::size_t j = i + 1;
+        while (j < faces.size() && faces[j].first == faces[i].first) {
+            j++;
+        }
+        // Faces with more cuts belong to triangles lying on them.
+        if (j - i == 2) {
+            Line line;
+            line.matId   = tri.elem->getMatId();
+            line.cuts[0] = cuts[faces[i].second];
+            line.cuts[1] = cuts[faces[i+1].second];
+            line.norm    = norm;
+            line.elem    = tri.elem;
+            lines.push_back(line);
+        }
+        i = j;
+    }
+}
+
+} /* namespace Mesher */
+} /* namespace SEMBA */
@@ -0,0 +1,94 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SEMBA_MESHER_CONFORMALCUTTER_H_
+#define SEMBA_MESHER_CONFORMALCUTTER_H_
+
+#include <map>
+#include <vector>
+
+#include "geometry/mesh/Unstructured.h"
+#include "geometry/coordinate/Conformal.h"
+#include "geometry/element/LineConformal.h"
+
+namespace SEMBA {
+namespace Mesher {
+
+// Intersects the triangles and quadrilaterals of a mesh with the edges of
+// a grid, as needed by conformal FDTD schemes. Every cut is stored as a
+// conformal coordinate: the lower node of the cut edge, its direction and
+// the fraction of its length at which the surface crosses it. Cuts on a
+// node have zero length. The two cuts that a triangle leaves on the
+// boundary of a grid face are joined by a conformal line carrying the
+// normal of the triangle. Results are grouped by material id.
+class ConformalCutter {
+public:
+    struct Cuts {
+        Geometry::Coordinate::Group<Geometry::CoordConf> coords;
+        Geometry::Element::Group<Geometry::LinConf>      lines;
+    };
+
+    ConformalCutter(const Geometry::Grid3& grid);
+
+    // Fraction of an edge under which cuts are snapped onto its nodes.
+    Math::Real getTolerance() const { return tolerance_; }
+    void setTolerance(const Math::Real tolerance) { tolerance_ = tolerance; }
+
+    std::map<MatId, Cuts> cut(const Geometry::Mesh::Unstructured& mesh) const;
+
+private:
+    struct Triangle {
+        Math::CVecR3 v[3];
+        const Geometry::ElemR* elem;
+    };
+
+    struct Cut {
+        Math::CVecI3                   node;
+        Math::Constants::CartesianAxis dir;
+        Math::Real                     length;
+
+        bool operator<(const Cut& rhs) const;
+        bool operator==(const Cut& rhs) const;
+    };
+
+    struct Line {
+        MatId                  matId;
+        Cut                    cuts[2];
+        Math::CVecR3           norm;
+        const Geometry::ElemR* elem;
+    };
+
+    Geometry::Grid3 grid_;
+    Math::Real tolerance_;
+
+    std::vector<Triangle> getTriangles_(
+            const Geometry::Mesh::Unstructured& mesh) const;
+    void cutTriangle_(const Triangle& tri, std::vector<Cut>& cuts) const;
+    bool locate_(const std::size_t dir, const Math::Real pos,
+                 Math::Int& node, Math::Real& length) const;
+    void joinCuts_(const Triangle& tri, const std::vector<Cut>& cuts,
+                   std::vector<Line>& lines) const;
+};
+
+} /* namespace Mesher */
+} /* namespace SEMBA */
+
+#endif /* SEMBA_MESHER_CONFORMALCUTTER_H_ */
@@ -0,0 +1,250 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#include "GridGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+#include "math/Constants.h"
+#include "physicalModel/volume/Classic.h"
+
+namespace SEMBA {
+namespace Mesher {
+
+GridGenerator::GridGenerator(const Math::Real maximumFrequency) {
+    if (maximumFrequency <= 0.0) {
+        throw std::logic_error(
+                "Maximum frequency must be a positive real number.");
+    }
+    maximumFrequency_ = maximumFrequency;
+    cellsPerWavelength_ = 10.0;
+    maximumGrowthRatio_ = 1.3;
+    minimumFeatureDistance_ = 0.0;
+}
+
+void GridGenerator::setCellsPerWavelength(
+        const Math::Real& cellsPerWavelength) {
+    if (cellsPerWavelength <= 0.0) {
+        throw std::logic_error(
+                "Cells per wavelength must be a positive real number.");
+    }
+    cellsPerWavelength_ = cellsPerWavelength;
+}
+
+void GridGenerator::setMaximumGrowthRatio(const Math::Real& ratio) {
+    if (ratio < 1.0) {
+        throw std::logic_error("Maximum growth ratio can't be lower than 1.");
+    }
+    maximumGrowthRatio_ = ratio;
+}
+
+void GridGenerator::setMinimumFeatureDistance(const Math::Real& distance) {
+    minimumFeatureDistance_ = distance;
+}
+
+void GridGenerator::setMaximumStep(const MatId matId,
+                                   const Math::Real& step) {
+    if (step <= 0.0) {
+        throw std::logic_error("Maximum step must be a positive real number.");
+    }
+    maximumStep_[matId] = step;
+}
+
+Math::Real GridGenerator::getMaximumStep() const {
+    return Math::Constants::c0 / maximumFrequency_ / cellsPerWavelength_;
+}
+
+Math::Real GridGenerator::getMaximumStep(
+        const PhysicalModel::PhysicalModel* pM) const {
+    if (pM == nullptr) {
+        return getMaximumStep();
+    }
+    std::map<MatId, Math::Real>::const_iterator it =
+        maximumStep_.find(pM->getId());
+    if (it != maximumStep_.end()) {
+        return it->second;
+    }
+    if (pM->is<PhysicalModel::Volume::Classic>()) {
+        const PhysicalModel::Volume::Classic* vol =
+            pM->castTo<PhysicalModel::Volume::Classic>();
+        const Math::Real n = std::sqrt(vol->getRelativePermittivity() *
+                                       vol->getRelativePermeability());
+        if (n > 1.0) {
+            return getMaximumStep() / n;
+        }
+    }
+    return getMaximumStep();
+}
+
+Geometry::Grid3 GridGenerator::generate(
+        const Geometry::Mesh::Unstructured& mesh,
+        const PMGroup& physicalModels) const {
+    return generate(mesh, physicalModels, mesh.getBoundingBox());
+}
+
+Geometry::Grid3 GridGenerator::generate(
+        const Geometry::Mesh::Unstructured& mesh,
+        const PMGroup& physicalModels,
+        const Geometry::BoxR3& domain) const {
+    const Math::Real background = getMaximumStep();
+    std::vector<Math::Real> features[3];
+    std::vector<Span> spans[3];
+    for (std::size_t e = 0; e < mesh.elems().size(); e++) {
+        const Geometry::ElemR* elem = mesh.elems()(e);
+        const Geometry::BoxR3 bound = elem->getBound();
+        Math::Real step = background;
+        const MatId matId = elem->getMatId();
+        if ((matId != MatId(0)) && physicalModels.existId(matId)) {
+            step = getMaximumStep(physicalModels.getId(matId));
+        }
+        for (std::size_t d = 0; d < 3; d++) {
+            features[d].push_back(bound.getMin()(d));
+            features[d].push_back(bound.getMax()(d));
+            if (step < background) {
+                Span span;
+                span.min  = bound.getMin()(d);
+                span.max  = bound.getMax()(d);
+                span.step = step;
+                spans[d].push_back(span);
+            }
+        }
+    }
+    std::vector<Math::Real> pos[3];
+    for (std::size_t d = 0; d < 3; d++) {
+        pos[d] = generateAxis_(domain.getMin()(d), domain.getMax()(d),
+                               std::move(features[d]), spans[d]);
+    }
+    return Geometry::Grid3(pos);
+}
+
+std::vector<Math::Real> GridGenerator::generateAxis_(
+        const Math::Real min,
+        const Math::Real max,
+        std::vector<Math::Real> features,
+        const std::vector<Span>& spans) const {
+    Math::Real finest = getMaximumStep();
+    for (std::size_t s = 0; s < spans.size(); s++) {
+        finest = std::min(finest, spans[s].step);
+    }
+    std::vector<Math::Real> res;
+    if (max - min <= 0.0) {
+        res.push_back(min);
+        res.push_back(min + finest);
+        return res;
+    }
+    Math::Real minDist = minimumFeatureDistance_;
+    if (minDist <= 0.0) {
+        minDist = Geometry::Grid3::tolerance * finest;
+    }
+
+    // Feature planes closer than the minimum distance are merged.
+    std::sort(features.begin(), features.end());
+    std::vector<Math::Real> x(1, min);
+    for (std::size_t i = 0; i < features.size(); i++) {
+        if ((features[i] > min) && (features[i] < max) &&
+            (features[i] - x.back() >= minDist)) {
+            x.push_back(features[i]);
+        }
+    }
+    if ((max - x.back() < minDist) && (x.size() > 1)) {
+        x.back() = max;
+    } else {
+        x.push_back(max);
+    }
+
+    // Maximum step of each interval between features, spans are located
+    // with a binary search over the features they cover.
+    const std::size_t nSeg = x.size() - 1;
+    std::vector<Math::Real> segStep(nSeg, getMaximumStep());
+    for (std::size_t s = 0; s < spans.size(); s++) {
+        std::size_t k = std::upper_bound(x.begin(), x.end(), spans[s].min) -
+                        x.begin();
+        k = (k > 0)? k-1 : 0;
+        for (; (k < nSeg) && (x[k] < spans[s].max); k++) {
+            if (x[k+1] > spans[s].min) {
+                segStep[k] = std::min(segStep[k], spans[s].step);
+            }
+        }
+    }
+
+    // Step at each feature is limited by its neighbourhood so that it can
+    // grow with the maximum ratio from any finer region. Intervals shorter
+    // than their maximum step are a single cell and also act as such.
+    const Math::Real slope = maximumGrowthRatio_ - 1.0;
+    std::vector<Math::Real> nodeStep(x.size(),
+                                     std::numeric_limits<Math::Real>::max());
+    for (std::size_t k = 0; k < nSeg; k++) {
+        const Math::Real step = std::min(segStep[k], x[k+1] - x[k]);
+        nodeStep[k]   = std::min(nodeStep[k],   step);
+        nodeStep[k+1] = std::min(nodeStep[k+1], step);
+    }
+    for (std::size_t i = 1; i < x.size(); i++) {
+        nodeStep[i] = std::min(nodeStep[i],
+                               nodeStep[i-1] + slope*(x[i]-x[i-1]));
+    }
+    for (std::size_t i = x.size()-1; i-- > 0;) {
+        nodeStep[i] = std::min(nodeStep[i],
+                               nodeStep[i+1] + slope*(x[i+1]-x[i]));
+    }
+
+    // Fills each interval marching from its lower feature. A step is the
+    // largest one not exceeding the sizing function along its length, which
+    // grows linearly from both features. The steps are finally shrunk to
+    // fit exactly in the interval.
+    res.push_back(x.front());
+    std::vector<Math::Real> steps;
+    for (std::size_t k = 0; k < nSeg; k++) {
+        const Math::Real a = x[k];
+        const Math::Real b = x[k+1];
+        const Math::Real length = b - a;
+        steps.clear();
+        Math::Real sum = 0.0;
+        while (length - sum > minDist) {
+            const Math::Real y = a + sum;
+            const Math::Real fromLower = nodeStep[k] + slope*(y - a);
+            const Math::Real fromUpper =
+                (nodeStep[k+1] + slope*(b - y)) / (1.0 + slope);
+            const Math::Real step =
+                std::min(segStep[k], std::min(fromLower, fromUpper));
+            steps.push_back(step);
+            sum += step;
+        }
+        if (steps.empty()) {
+            steps.push_back(length);
+            sum = length;
+        }
+        const Math::Real factor = length / sum;
+        Math::Real acc = a;
+        for (std::size_t i = 0; i + 1 < steps.size(); i++) {
+            acc += steps[i] * factor;
+            res.push_back(acc);
+        }
+        res.push_back(b);
+    }
+    return res;
+}
+
+} /* namespace Mesher */
+} /* namespace SEMBA */
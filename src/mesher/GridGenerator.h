@@ -0,0 +1,87 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SEMBA_MESHER_GRIDGENERATOR_H_
+#define SEMBA_MESHER_GRIDGENERATOR_H_
+
+#include <map>
+#include <vector>
+
+#include "geometry/Grid.h"
+#include "geometry/mesh/Unstructured.h"
+#include "physicalModel/Group.h"
+
+namespace SEMBA {
+namespace Mesher {
+
+// Builds a graded grid for a mesh. Grid lines are placed on the planes
+// bounding each element, the step inside each element is limited to a
+// fraction of the wavelength in its material at the maximum frequency and
+// steps grow geometrically, with a bounded ratio, away from fine regions.
+class GridGenerator {
+public:
+    GridGenerator(const Math::Real maximumFrequency);
+
+    Math::Real getMaximumFrequency() const { return maximumFrequency_; }
+    Math::Real getCellsPerWavelength() const { return cellsPerWavelength_; }
+    Math::Real getMaximumGrowthRatio() const { return maximumGrowthRatio_; }
+    Math::Real getMinimumFeatureDistance() const {
+        return minimumFeatureDistance_;
+    }
+
+    void setCellsPerWavelength(const Math::Real& cellsPerWavelength);
+    void setMaximumGrowthRatio(const Math::Real& ratio);
+    void setMinimumFeatureDistance(const Math::Real& distance);
+    void setMaximumStep(const MatId matId, const Math::Real& step);
+
+    // Maximum step in vacuum and inside a given physical model.
+    Math::Real getMaximumStep() const;
+    Math::Real getMaximumStep(const PhysicalModel::PhysicalModel* pM) const;
+
+    Geometry::Grid3 generate(const Geometry::Mesh::Unstructured& mesh,
+                             const PMGroup& physicalModels) const;
+    Geometry::Grid3 generate(const Geometry::Mesh::Unstructured& mesh,
+                             const PMGroup& physicalModels,
+                             const Geometry::BoxR3& domain) const;
+
+private:
+    // Interval of an axis in which steps can't be larger than step.
+    struct Span {
+        Math::Real min, max, step;
+    };
+
+    Math::Real maximumFrequency_;
+    Math::Real cellsPerWavelength_;
+    Math::Real maximumGrowthRatio_;
+    Math::Real minimumFeatureDistance_;
+    std::map<MatId, Math::Real> maximumStep_;
+
+    std::vector<Math::Real> generateAxis_(
+            const Math::Real min,
+            const Math::Real max,
+            std::vector<Math::Real> features,
+            const std::vector<Span>& spans) const;
+};
+
+} /* namespace Mesher */
+} /* namespace SEMBA */
+
+#endif /* SEMBA_MESHER_GRIDGENERATOR_H_ */
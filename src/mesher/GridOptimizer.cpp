@@ -0,0 +1,250 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#include "GridOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+
+#include "math/Constants.h"
+
+namespace SEMBA {
+namespace Mesher {
+
+GridOptimizer::GridOptimizer(const Math::Real mergeRatio) {
+    if (!(mergeRatio > 0.0 && mergeRatio < 1.0)) {
+        throw std::logic_error("Merge ratio must be between 0 and 1.");
+    }
+    mergeRatio_ = mergeRatio;
+}
+
+GridOptimizer::GridOptimizer(const Options& opts)
+:   GridOptimizer(opts.getMergeRatio()) {
+
+}
+
+bool GridOptimizer::Cell::operator>(const Cell& rhs) const {
+    if (ratio != rhs.ratio) {
+        return ratio > rhs.ratio;
+    }
+    return first > rhs.first;
+}
+
+Math::Real GridOptimizer::getTimeStep(const Geometry::Grid3& grid) {
+    Math::Real sum = 0.0;
+    for (std::size_t d = 0; d < 3; d++) {
+        const std::vector<Math::Real>& step = grid.getStep(d);
+        if (step.empty()) {
+            continue;
+        }
+        const Math::Real minStep = *std::min_element(step.begin(),
+                                                     step.end());
+        sum += 1.0 / (minStep*minStep);
+    }
+    if (sum == 0.0) {
+        return std::numeric_limits<Math::Real>::infinity();
+    }
+    return 1.0 / (Math::Constants::c0 * std::sqrt(sum));
+}
+
+GridOptimizer::Report GridOptimizer::optimize(
+        Geometry::Mesh::Geometric& mesh) const {
+    Geometry::Grid3& grid = mesh.grid();
+    Geometry::CoordR3Group& cG = mesh.coords();
+    const Math::Real timeStep = getTimeStep(grid);
+
+    Report res;
+    res.mergedLines = 0;
+    res.maximumDisplacement = 0.0;
+
+    std::vector<Math::CVecR3> newPos(cG.size());
+    for (std::size_t i = 0; i < cG.size(); i++) {
+        newPos[i] = cG(i)->pos();
+    }
+    std::vector<Math::Real> pos[3];
+    for (std::size_t d = 0; d < 3; d++) {
+        pos[d] = grid.getPos(d);
+        if (pos[d].size() < 3) {
+            continue;
+        }
+        const std::vector<Math::Real>& step = grid.getStep(d);
+        const Math::Real tol = Geometry::Grid3::tolerance *
+                               *std::min_element(step.begin(), step.end());
+
+        std::vector<Line> lines(pos[d].size());
+        for (std::size_t i = 0; i < lines.size(); i++) {
+            lines[i].pos = lines[i].min = lines[i].max = pos[d][i];
+            lines[i].coords = 0;
+            lines[i].prev = i - 1;
+            lines[i].next = i + 1;
+        }
+        for (std::size_t i = 0; i < newPos.size(); i++) {
+            const Math::Real v = newPos[i](d);
+            std::vector<Math::Real>::const_iterator it =
+                std::lower_bound(pos[d].begin(), pos[d].end(), v - tol);
+            if ((it != pos[d].end()) && (std::abs(*it - v) <= tol)) {
+                lines[it - pos[d].begin()].coords++;
+            }
+        }
+
+        const std::size_t merged = mergeLines_(lines);
+        res.mergedLines += merged;
+        if (merged == 0) {
+            continue;
+        }
+
+        // Snaps coordinates on or between merged lines.
+        for (std::size_t i = 0; i < newPos.size(); i++) {
+            const Math::Real v = newPos[i](d);
+            std::size_t lo = 0, hi = lines.size();
+            while (lo < hi) {
+                const std::size_t mid = (lo + hi) / 2;
+                if (lines[mid].max + tol < v) {
+                    lo = mid + 1;
+                } else {
+                    hi = mid;
+                }
+            }
+            if ((lo < lines.size()) && (lines[lo].min < lines[lo].max) &&
+                (lines[lo].min - tol <= v)) {
+                newPos[i](d) = lines[lo].pos;
+            }
+        }
+        pos[d].resize(lines.size());
+        for (std::size_t i = 0; i < lines.size(); i++) {
+            pos[d][i] = lines[i].pos;
+        }
+    }
+
+    for (std::size_t i = 0; i < newPos.size(); i++) {
+        const Math::Real disp = (newPos[i] - cG(i)->pos()).norm();
+        if (disp > 0.0) {
+            res.maximumDisplacement = std::max(res.maximumDisplacement, disp);
+            cG.setPos(i, newPos[i]);
+        }
+    }
+    grid.setPos(pos);
+
+    res.minimumStep = grid.getMinimumSpaceStep();
+    res.timeStepGain = getTimeStep(grid) / timeStep;
+    return res;
+}
+
+Math::Real GridOptimizer::getRatio_(const std::vector<Line>& lines,
+                                    const std::size_t first) {
+    const std::size_t n = lines.size();
+    const Line& lhs = lines[first];
+    if (lhs.next >= n) {
+        return std::numeric_limits<Math::Real>::infinity();
+    }
+    const Line& rhs = lines[lhs.next];
+    Math::Real ref = 0.0;
+    if (lhs.prev < n) {
+        ref = std::max(ref, lhs.pos - lines[lhs.prev].pos);
+    }
+    if (rhs.next < n) {
+        ref = std::max(ref, lines[rhs.next].pos - rhs.pos);
+    }
+    if (ref == 0.0) {
+        return std::numeric_limits<Math::Real>::infinity();
+    }
+    return (rhs.pos - lhs.pos) / ref;
+}
+
+std::size_t GridOptimizer::mergeLines_(std::vector<Line>& lines) const {
+    // Cells are queued smallest ratio first. Merging a cell changes the
+    // ratios of the two cells at each side, so these are queued again and
+    // their previous entries are discarded by version.
+    const std::size_t n = lines.size();
+    const Math::Real threshold =
+        mergeRatio_ * (1.0 - Geometry::Grid3::tolerance);
+    std::vector<std::size_t> version(n, 0);
+    std::priority_queue<Cell, std::vector<Cell>, std::greater<Cell> > queue;
+    for (std::size_t k = 0; k + 1 < n; k++) {
+        const Math::Real ratio = getRatio_(lines, k);
+        if (ratio < threshold) {
+            queue.push({ratio, k, 0});
+        }
+    }
+
+    std::size_t res = 0;
+    while (n - res > 2 && !queue.empty()) {
+        const Cell cell = queue.top();
+        queue.pop();
+        if (cell.version != version[cell.first]) {
+            continue;
+        }
+        // Domain bounds are kept, otherwise the line holding coordinates is
+        // kept or, if both of them do, they meet halfway.
+        Line& lhs = lines[cell.first];
+        const std::size_t r = lhs.next;
+        const Line& rhs = lines[r];
+        Math::Real pos;
+        if (lhs.prev >= n) {
+            pos = lhs.pos;
+        } else if (rhs.next >= n) {
+            pos = rhs.pos;
+        } else if (lhs.coords > 0 && rhs.coords == 0) {
+            pos = lhs.pos;
+        } else if (rhs.coords > 0 && lhs.coords == 0) {
+            pos = rhs.pos;
+        } else {
+            pos = (lhs.pos + rhs.pos) / 2.0;
+        }
+        lhs.pos = pos;
+        lhs.max = rhs.max;
+        lhs.coords += rhs.coords;
+        lhs.next = rhs.next;
+        if (rhs.next < n) {
+            lines[rhs.next].prev = cell.first;
+        }
+        version[r]++;
+        res++;
+
+        std::size_t first = cell.first;
+        for (std::size_t i = 0; i < 2 && lines[first].prev < n; i++) {
+            first = lines[first].prev;
+        }
+        for (std::size_t k = first, i = 0; k < n && i < 4;
+             k = lines[k].next, i++) {
+            version[k]++;
+            const Math::Real ratio = getRatio_(lines, k);
+            if (ratio < threshold) {
+                queue.push({ratio, k, version[k]});
+            }
+        }
+    }
+
+    std::vector<Line> merged;
+    merged.reserve(n - res);
+    for (std::size_t k = 0; k < n; k = lines[k].next) {
+        merged.push_back(lines[k]);
+    }
+    lines.swap(merged);
+    return res;
+}
+
+} /* namespace Mesher */
+} /* namespace SEMBA */
@@ -0,0 +1,84 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SEMBA_MESHER_GRIDOPTIMIZER_H_
+#define SEMBA_MESHER_GRIDOPTIMIZER_H_
+
+#include <vector>
+
+#include "Options.h"
+#include "geometry/mesh/Geometric.h"
+
+namespace SEMBA {
+namespace Mesher {
+
+// Removes cells much smaller than their neighbours, which would otherwise
+// set the stable time step of the whole simulation. Each pair of lines
+// bounding a cell shorter than the merge ratio times its largest neighbour
+// is merged into one line and the coordinates lying on or between them are
+// snapped onto it. The merge ratio must lie in (0, 1).
+class GridOptimizer {
+public:
+    struct Report {
+        Math::Real  minimumStep;
+        Math::Real  timeStepGain;
+        Math::Real  maximumDisplacement;
+        std::size_t mergedLines;
+    };
+
+    GridOptimizer(const Math::Real mergeRatio);
+    GridOptimizer(const Options& opts);
+
+    Math::Real getMergeRatio() const { return mergeRatio_; }
+
+    Report optimize(Geometry::Mesh::Geometric& mesh) const;
+
+    // Largest stable time step of a Yee scheme in vacuum on the grid.
+    static Math::Real getTimeStep(const Geometry::Grid3& grid);
+
+private:
+    // Grid line and the range of original lines merged into it, linked to
+    // its neighbours while merging. Missing neighbours are out of range.
+    struct Line {
+        Math::Real  pos, min, max;
+        std::size_t coords;
+        std::size_t prev, next;
+    };
+    // Cell following a line, queued by ratio to its largest neighbour.
+    struct Cell {
+        Math::Real  ratio;
+        std::size_t first;
+        std::size_t version;
+
+        bool operator>(const Cell& rhs) const;
+    };
+
+    Math::Real mergeRatio_;
+
+    std::size_t mergeLines_(std::vector<Line>& lines) const;
+    static Math::Real getRatio_(const std::vector<Line>& lines,
+                                const std::size_t first);
+};
+
+} /* namespace Mesher */
+} /* namespace SEMBA */
+
+#endif /* SEMBA_MESHER_GRIDOPTIMIZER_H_ */
@@ -34,7 +34,9 @@ namespace Mesher {
 Options::Options() {
     mesher_ = Mesher::DMesher;
     mode_ = Mode::structured;
-    forbiddenLength_ = 1.0;
+    snap_ = false;
+    forbiddenLength_ = 0.25;
+    mergeRatio_ = 0.25;
     subgridPoints_ = 0;
     scalingFactor_ = 1.0;
     postmshExport_ = true;
@@ -202,6 +204,9 @@ void Options::set(const Solver::Settings& opts) {
     if (opts.existsName(        "forbiddenLength")) {
         setForbiddenLength(opts("forbiddenLength").getReal());
     }
+    if (opts.existsName(   "mergeRatio")) {
+        setMergeRatio(opts("mergeRatio").getReal());
+    }
     if (opts.existsName(      "geometryScalingFactor")) {
         setScalingFactor(opts("geometryScalingFactor").getReal());
     }
@@ -251,6 +256,14 @@ Math::Real Options::getForbiddenLength() const {
     return forbiddenLength_;
 }
 
+void Options::setMergeRatio(const Math::Real& mergeRatio) {
+    mergeRatio_ = mergeRatio;
+}
+
+Math::Real Options::getMergeRatio() const {
+    return mergeRatio_;
+}
+
 const std::string& Options::getOutputName() const {
     return outputName_;
 }
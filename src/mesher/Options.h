@@ -69,6 +69,7 @@ public:
     bool isRelaxed() const;
     Math::Int getSubgridPoints() const;
     Math::Real getForbiddenLength() const;
+    Math::Real getMergeRatio() const;
     Math::Real getScalingFactor() const;
     bool isSnap() const;
     bool isGridStepSet() const;
@@ -94,6 +95,7 @@ public:
                              const PhysicalModel::Bound::Bound*);
     void setSubgridPoints(const Math::Int&);
     void setForbiddenLength(const Math::Real& edgeFraction);
+    void setMergeRatio(const Math::Real& mergeRatio);
     void setGridStep(const Math::CVecR3& gridStep);
     void setMode(Mode mode);
     void setSnap(bool snap);
@@ -121,6 +123,7 @@ private:
     Mode mode_;
     bool snap_;
     Math::Real forbiddenLength_;
+    Math::Real mergeRatio_;
     std::string scaleFactorValue_;
     
     std::string outputName_;
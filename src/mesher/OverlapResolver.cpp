@@ -0,0 +1,455 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#include "OverlapResolver.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <iostream>
+#include <set>
+#include <stdexcept>
+#include <typeindex>
+
+#include "geometry/element/Line2.h"
+#include "geometry/element/LineConformal.h"
+#include "geometry/element/Quadrilateral4.h"
+#include "geometry/element/Hexahedron8.h"
+#include "physicalModel/bound/PEC.h"
+#include "physicalModel/bound/PMC.h"
+#include "physicalModel/predefined/PEC.h"
+#include "physicalModel/predefined/PMC.h"
+#include "physicalModel/wire/Wire.h"
+#include "physicalModel/multiport/Multiport.h"
+#include "physicalModel/surface/Surface.h"
+#include "physicalModel/volume/Volume.h"
+
+namespace SEMBA {
+namespace Mesher {
+
+namespace {
+
+enum class Kind { none, line, surface, volume };
+
+// A slot packs its kind (0 for cells, 1 + normal for faces and 4 + dir for
+// edges) and its lower node in a single key.
+typedef std::uint64_t Key;
+
+const std::size_t bitsPerAxis = 20;
+const std::size_t numberOfBuckets = 64;
+
+Key getKey(const Key kind, const Math::CVecI3& ijk) {
+    Key res = kind;
+    for (std::size_t d = 0; d < 3; d++) {
+        if (ijk(d) < 0 || ijk(d) >= (Math::Int(1) << bitsPerAxis)) {
+            throw std::out_of_range(
+                    "Overlap resolver: position out of range.");
+        }
+        res = (res << bitsPerAxis) | Key(ijk(d));
+    }
+    return res;
+}
+
+Key getKind(const Key key) {
+    return key >> (3*bitsPerAxis);
+}
+
+Math::CVecI3 getPos(const Key key) {
+    const Key mask = (Key(1) << bitsPerAxis) - 1;
+    return Math::CVecI3(Math::Int((key >> (2*bitsPerAxis)) & mask),
+                        Math::Int((key >> bitsPerAxis) & mask),
+                        Math::Int(key & mask));
+}
+
+std::size_t getBucket(const Key key) {
+    return (key * 0x9E3779B97F4A7C15ULL) >> 58;
+}
+
+struct Slot {
+    Key         key;
+    std::size_t elem;
+
+    bool operator<(const Slot& rhs) const { return key < rhs.key; }
+};
+
+struct Loss {
+    std::size_t elem;
+    std::size_t winner;
+    Key         key;
+
+    bool operator<(const Loss& rhs) const {
+        if (elem != rhs.elem) {
+            return elem < rhs.elem;
+        }
+        if (winner != rhs.winner) {
+            return winner < rhs.winner;
+        }
+        return key < rhs.key;
+    }
+};
+
+// Appends the unit slots covered by an element of the given kind.
+void getSlots(const Kind kind, const Geometry::BoxI3& box,
+              const std::size_t elem, std::vector<Slot>& slots) {
+    const Math::CVecI3 lo = box.getMin();
+    const Math::CVecI3 hi = box.getMax();
+    std::size_t flat = 3;
+    std::size_t numberOfFlat = 0;
+    for (std::size_t d = 0; d < 3; d++) {
+        if (hi(d) == lo(d)) {
+            numberOfFlat++;
+            flat = (kind == Kind::line) ? flat : d;
+        } else if (kind == Kind::line) {
+            flat = d;
+        }
+    }
+    Key code;
+    Math::CVecI3 end = hi;
+    switch (kind) {
+    case Kind::volume:
+        if (numberOfFlat != 0) {
+            return;
+        }
+        code = 0;
+        break;
+    case Kind::surface:
+        if (numberOfFlat != 1) {
+            return;
+        }
+        code = 1 + flat;
+        end(flat)++;
+        break;
+    case Kind::line:
+        if (numberOfFlat != 2) {
+            return;
+        }
+        code = 4 + flat;
+        for (std::size_t d = 0; d < 3; d++) {
+            if (d != flat) {
+                end(d)++;
+            }
+        }
+        break;
+    default:
+        return;
+    }
+    Math::CVecI3 ijk;
+    for (ijk(0) = lo(0); ijk(0) < end(0); ijk(0)++) {
+        for (ijk(1) = lo(1); ijk(1) < end(1); ijk(1)++) {
+            for (ijk(2) = lo(2); ijk(2) < end(2); ijk(2)++) {
+                Slot slot;
+                slot.key  = getKey(code, ijk);
+                slot.elem = elem;
+                slots.push_back(slot);
+            }
+        }
+    }
+}
+
+Geometry::ElemI* newUnitElement(Geometry::CoordI3Group& cG,
+                                const Geometry::ElemI* elem,
+                                const Key key) {
+    const Key code = getKind(key);
+    const Math::CVecI3 lo = getPos(key);
+    Math::CVecI3 hi = lo + Math::CVecI3(1);
+    if (code == 0) {
+        return new Geometry::HexI8(cG, Geometry::ElemId(0),
+                                   Geometry::BoxI3(lo, hi),
+                                   elem->getLayer(), elem->getModel());
+    }
+    if (code < 4) {
+        hi(code - 1) = lo(code - 1);
+        Geometry::QuaI4* res =
+            new Geometry::QuaI4(cG, Geometry::ElemId(0),
+                                Geometry::BoxI3(lo, hi),
+                                elem->getLayer(), elem->getModel());
+        // Keeps the orientation of the split element.
+        const std::size_t n = code - 1;
+        const Math::CVecI3 oldNormal =
+            (elem->getVertex(1)->pos() - elem->getVertex(0)->pos()) ^
+            (elem->getVertex(3)->pos() - elem->getVertex(0)->pos());
+        const Math::CVecI3 newNormal =
+            (res->getVertex(1)->pos() - res->getVertex(0)->pos()) ^
+            (res->getVertex(3)->pos() - res->getVertex(0)->pos());
+        if ((oldNormal(n) > 0) != (newNormal(n) > 0)) {
+            const Geometry::CoordI3* v[4] = {res->getV(0), res->getV(3),
+                                             res->getV(2), res->getV(1)};
+            Geometry::QuaI4* aux = res;
+            res = new Geometry::QuaI4(Geometry::ElemId(0), v,
+                                      elem->getLayer(), elem->getModel());
+            delete aux;
+        }
+        return res;
+    }
+    for (std::size_t d = 0; d < 3; d++) {
+        if (d != code - 4) {
+            hi(d) = lo(d);
+        }
+    }
+    return new Geometry::LinI2(cG, Geometry::ElemId(0),
+                               Geometry::BoxI3(lo, hi),
+                               elem->getLayer(), elem->getModel());
+}
+
+} /* namespace */
+
+void OverlapResolver::Report::printInfo() const {
+    std::cout << "--- Overlap resolver report ---" << std::endl;
+    std::cout << "Removed elements: " << removed_
+              << " Split elements: " << split_ << std::endl;
+    for (std::size_t i = 0; i < overlaps_.size(); i++) {
+        std::cout << "Element " << overlaps_[i].dropped
+                  << " (material " << overlaps_[i].droppedMatId << ")"
+                  << " lost " << overlaps_[i].slots << " slots to element "
+                  << overlaps_[i].kept
+                  << " (material " << overlaps_[i].keptMatId << ")"
+                  << std::endl;
+    }
+}
+
+OverlapResolver::OverlapResolver() {
+    categories_[Category::pec]       = 6;
+    categories_[Category::pmc]       = 5;
+    categories_[Category::wire]      = 4;
+    categories_[Category::multiport] = 3;
+    categories_[Category::surface]   = 2;
+    categories_[Category::volume]    = 1;
+    categories_[Category::other]     = 0;
+}
+
+Math::Int OverlapResolver::getPriority(const Category category) const {
+    return categories_.at(category);
+}
+
+Math::Int OverlapResolver::getPriority(
+        const Geometry::Element::Model* model) const {
+    if (model != nullptr) {
+        std::map<MatId, Math::Int>::const_iterator it =
+            models_.find(model->getId());
+        if (it != models_.end()) {
+            return it->second;
+        }
+    }
+    return getPriority(getCategory(model));
+}
+
+void OverlapResolver::setPriority(const Category category,
+                                  const Math::Int priority) {
+    categories_[category] = priority;
+}
+
+void OverlapResolver::setPriority(const MatId matId,
+                                  const Math::Int priority) {
+    models_[matId] = priority;
+}
+
+OverlapResolver::Category OverlapResolver::getCategory(
+        const Geometry::Element::Model* model) {
+    if (model == nullptr) {
+        return Category::other;
+    }
+    if (dynamic_cast<const PhysicalModel::Predefined::PEC*>(model) ||
+        dynamic_cast<const PhysicalModel::Bound::PEC*>(model)) {
+        return Category::pec;
+    }
+    if (dynamic_cast<const PhysicalModel::Predefined::PMC*>(model) ||
+        dynamic_cast<const PhysicalModel::Bound::PMC*>(model)) {
+        return Category::pmc;
+    }
+    if (dynamic_cast<const PhysicalModel::Wire::Wire*>(model)) {
+        return Category::wire;
+    }
+    if (dynamic_cast<const PhysicalModel::Multiport::Multiport*>(model)) {
+        return Category::multiport;
+    }
+    if (dynamic_cast<const PhysicalModel::Surface::Surface*>(model)) {
+        return Category::surface;
+    }
+    if (dynamic_cast<const PhysicalModel::Volume::Volume*>(model)) {
+        return Category::volume;
+    }
+    return Category::other;
+}
+
+OverlapResolver::Report OverlapResolver::resolve(
+        Geometry::Mesh::Structured& mesh) const {
+    const std::size_t nElems = mesh.elems().size();
+
+    std::vector<Kind> kinds(nElems);
+    std::vector<Math::Int> priorities(nElems);
+    std::map<std::type_index, Kind> kindOfType;
+    std::map<const Geometry::Element::Model*, Math::Int> priorityOfModel;
+    for (std::size_t e = 0; e < nElems; e++) {
+        const Geometry::ElemI* elem = mesh.elems()(e);
+        const std::type_index type(typeid(*elem));
+        std::map<std::type_index, Kind>::const_iterator it =
+            kindOfType.find(type);
+        if (it == kindOfType.end()) {
+            Kind kind = Kind::none;
+            if (elem->is<Geometry::LinConf>()) {
+                kind = Kind::none;
+            } else if (elem->is<Geometry::HexI8>()) {
+                kind = Kind::volume;
+            } else if (elem->is<Geometry::QuaI4>()) {
+                kind = Kind::surface;
+            } else if (elem->is<Geometry::LinI2>()) {
+                kind = Kind::line;
+            }
+            it = kindOfType.insert(std::make_pair(type, kind)).first;
+        }
+        kinds[e] = it->second;
+        std::map<const Geometry::Element::Model*, Math::Int>::const_iterator
+            pr = priorityOfModel.find(elem->getModel());
+        if (pr == priorityOfModel.end()) {
+            pr = priorityOfModel.insert(std::make_pair(elem->getModel(),
+                    getPriority(elem->getModel()))).first;
+        }
+        priorities[e] = pr->second;
+    }
+
+    // Slots are listed concurrently per chunk of elements and distributed
+    // in element order among buckets, so that the first element covering
+    // a slot comes first within its bucket.
+    const std::size_t chunkSize = 4096;
+    const std::size_t nChunks = (nElems + chunkSize - 1) / chunkSize;
+    std::vector<std::vector<Slot>> chunkSlots(nChunks);
+    std::vector<std::size_t> numberOfSlots(nElems, 0);
+    std::exception_ptr error;
+    long long errorChunk = nChunks;
+#pragma omp parallel for schedule(dynamic)
+    for (long long c = 0; c < (long long) nChunks; c++) {
+        try {
+            const std::size_t end =
+                std::min<std::size_t>((c+1)*chunkSize, nElems);
+            for (std::size_t e = c*chunkSize; e < end; e++) {
+                if (kinds[e] == Kind::none) {
+                    continue;
+                }
+                const std::size_t first = chunkSlots[c].size();
+                getSlots(kinds[e], mesh.elems()(e)->getBound(), e,
+                         chunkSlots[c]);
+                numberOfSlots[e] = chunkSlots[c].size() - first;
+            }
+        } catch (...) {
+#pragma omp critical (OverlapResolverResolve)
+            {
+                if (c < errorChunk) {
+                    errorChunk = c;
+                    error = std::current_exception();
+                }
+            }
+        }
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    std::vector<std::vector<Slot>> buckets(numberOfBuckets);
+    for (std::size_t c = 0; c < nChunks; c++) {
+        for (std::size_t i = 0; i < chunkSlots[c].size(); i++) {
+            buckets[getBucket(chunkSlots[c][i].key)].push_back(
+                    chunkSlots[c][i]);
+        }
+        std::vector<Slot>().swap(chunkSlots[c]);
+    }
+
+    std::vector<std::vector<Loss>> bucketLosses(numberOfBuckets);
+#pragma omp parallel for schedule(dynamic)
+    for (long long b = 0; b < (long long) numberOfBuckets; b++) {
+        std::vector<Slot>& slots = buckets[b];
+        std::stable_sort(slots.begin(), slots.end());
+        for (std::size_t i = 0; i < slots.size(); ) {
+            std::size_t j = i + 1;
+            std::size_t winner = slots[i].elem;
+            while (j < slots.size() && slots[j].key == slots[i].key) {
+                if (priorities[slots[j].elem] > priorities[winner]) {
+                    winner = slots[j].elem;
+                }
+                j++;
+            }
+            for (std::size_t k = i; k < j; k++) {
+                if (slots[k].elem != winner) {
+                    Loss loss;
+                    loss.elem   = slots[k].elem;
+                    loss.winner = winner;
+                    loss.key    = slots[k].key;
+                    bucketLosses[b].push_back(loss);
+                }
+            }
+            i = j;
+        }
+        std::vector<Slot>().swap(slots);
+    }
+
+    std::vector<Loss> losses;
+    for (std::size_t b = 0; b < numberOfBuckets; b++) {
+        losses.insert(losses.end(),
+                      bucketLosses[b].begin(), bucketLosses[b].end());
+    }
+    std::sort(losses.begin(), losses.end());
+
+    Report res;
+    std::vector<std::size_t> toRemove;
+    std::vector<Geometry::ElemI*> newElems;
+    for (std::size_t i = 0; i < losses.size(); ) {
+        const std::size_t e = losses[i].elem;
+        const Geometry::ElemI* elem = mesh.elems()(e);
+        std::set<Key> lost;
+        std::size_t j = i;
+        while (j < losses.size() && losses[j].elem == e) {
+            std::size_t k = j;
+            while (k < losses.size() && losses[k].elem == e &&
+                   losses[k].winner == losses[j].winner) {
+                lost.insert(losses[k].key);
+                k++;
+            }
+            const Geometry::ElemI* winner = mesh.elems()(losses[j].winner);
+            Overlap overlap;
+            overlap.dropped      = elem->getId();
+            overlap.droppedMatId = elem->getMatId();
+            overlap.kept         = winner->getId();
+            overlap.keptMatId    = winner->getMatId();
+            overlap.slots        = k - j;
+            res.overlaps_.push_back(overlap);
+            j = k;
+        }
+        toRemove.push_back(e);
+        if (lost.size() == numberOfSlots[e]) {
+            res.removed_++;
+        } else {
+            res.split_++;
+            std::vector<Slot> slots;
+            getSlots(kinds[e], elem->getBound(), e, slots);
+            for (std::size_t s = 0; s < slots.size(); s++) {
+                if (lost.count(slots[s].key) == 0) {
+                    newElems.push_back(
+                        newUnitElement(mesh.coords(), elem, slots[s].key));
+                }
+            }
+        }
+        i = j;
+    }
+    mesh.elems().remove(toRemove);
+    mesh.elems().addId(newElems);
+    return res;
+}
+
+} /* namespace Mesher */
+} /* namespace SEMBA */
@@ -0,0 +1,101 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SEMBA_MESHER_OVERLAPRESOLVER_H_
+#define SEMBA_MESHER_OVERLAPRESOLVER_H_
+
+#include <map>
+#include <vector>
+
+#include "geometry/mesh/Structured.h"
+
+namespace SEMBA {
+namespace Mesher {
+
+// Leaves at most one HexI8 per grid cell, QuaI4 per face and LinI2 per
+// edge of a structured mesh. Elements are split in unit slots, which are
+// partitioned by position and resolved concurrently: the slot goes to the
+// element with the highest priority, the first one in the mesh on ties.
+// Elements losing all of their slots are removed and those losing some
+// are replaced by unit elements on the slots they keep. Priorities are
+// given per category of physical model and can be overridden per model.
+class OverlapResolver {
+public:
+    enum class Category {
+        pec,
+        pmc,
+        wire,
+        multiport,
+        surface,
+        volume,
+        other
+    };
+
+    // Slots of element dropped which went to element kept.
+    struct Overlap {
+        Geometry::ElemId dropped;
+        MatId            droppedMatId;
+        Geometry::ElemId kept;
+        MatId            keptMatId;
+        std::size_t      slots;
+    };
+
+    class Report {
+    public:
+        Report() {}
+
+        bool empty() const { return overlaps_.empty(); }
+        const std::vector<Overlap>& overlaps() const { return overlaps_; }
+
+        std::size_t getRemovedElements() const { return removed_; }
+        std::size_t getSplitElements  () const { return split_;   }
+
+        void printInfo() const;
+
+    private:
+        friend class OverlapResolver;
+
+        std::vector<Overlap> overlaps_;
+        std::size_t removed_ = 0;
+        std::size_t split_   = 0;
+    };
+
+    OverlapResolver();
+
+    Math::Int getPriority(const Category category) const;
+    Math::Int getPriority(const Geometry::Element::Model* model) const;
+
+    void setPriority(const Category category, const Math::Int priority);
+    void setPriority(const MatId matId, const Math::Int priority);
+
+    static Category getCategory(const Geometry::Element::Model* model);
+
+    Report resolve(Geometry::Mesh::Structured& mesh) const;
+
+private:
+    std::map<Category, Math::Int> categories_;
+    std::map<MatId, Math::Int> models_;
+};
+
+} /* namespace Mesher */
+} /* namespace SEMBA */
+
+#endif /* SEMBA_MESHER_OVERLAPRESOLVER_H_ */
@@ -0,0 +1,397 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#include "StaircaseMesher.h"
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <limits>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <typeindex>
+
+#include "geometry/element/Line2.h"
+#include "geometry/element/Triangle.h"
+#include "geometry/element/Quadrilateral4.h"
+
+namespace SEMBA {
+namespace Mesher {
+
+namespace {
+
+enum class Kind { none, line, triangle, quadrilateral };
+
+bool isLexLower(const Math::CVecI3& lhs, const Math::CVecI3& rhs) {
+    for (std::size_t d = 0; d < 3; d++) {
+        if (lhs(d) != rhs(d)) {
+            return lhs(d) < rhs(d);
+        }
+    }
+    return false;
+}
+
+// Index of the grid plane nearest to x, clamped to the grid.
+Math::Int getNearestPlane(const std::vector<Math::Real>& pos,
+                          const Math::Real x) {
+    const std::size_t k =
+        std::lower_bound(pos.begin(), pos.end(), x) - pos.begin();
+    if (k == 0) {
+        return 0;
+    }
+    if (k == pos.size()) {
+        return pos.size() - 1;
+    }
+    return (x - pos[k-1] <= pos[k] - x) ? k-1 : k;
+}
+
+Math::Real getDistanceToSegment(const Math::CVecR3& p,
+                                const Math::CVecR3& a,
+                                const Math::CVecR3& b) {
+    const Math::CVecR3 ab = b - a;
+    const Math::Real len2 = ab.dot(ab);
+    Math::Real t = 0.0;
+    if (len2 > 0.0) {
+        t = std::min(std::max((p - a).dot(ab) / len2, 0.0), 1.0);
+    }
+    return (p - (a + ab*t)).norm();
+}
+
+} /* namespace */
+
+bool StaircaseMesher::Cell::operator<(const Cell& rhs) const {
+    if (elem->getMatId() != rhs.elem->getMatId()) {
+        return elem->getMatId() < rhs.elem->getMatId();
+    }
+    if (elem->getLayerId() != rhs.elem->getLayerId()) {
+        return elem->getLayerId() < rhs.elem->getLayerId();
+    }
+    if (isLine != rhs.isLine) {
+        return isLine < rhs.isLine;
+    }
+    if (axis != rhs.axis) {
+        return axis < rhs.axis;
+    }
+    return isLexLower(lo, rhs.lo);
+}
+
+StaircaseMesher::StaircaseMesher(const Options& opts)
+:   snap_(opts.isSnap()),
+    forbiddenLength_(opts.getForbiddenLength()) {
+    if (opts.getMode() != Options::Mode::structured) {
+        throw std::logic_error(
+                "Staircase mesher only supports structured mode.");
+    }
+    if (!(forbiddenLength_ >= 0.0 && forbiddenLength_ < 0.5)) {
+        throw std::logic_error(
+                "Forbidden length must be between 0 and 0.5.");
+    }
+}
+
+Geometry::Mesh::Structured* StaircaseMesher::mesh(
+        const Geometry::Mesh::Geometric& in) const {
+    const Geometry::Grid3& grid = in.grid();
+    const std::size_t nElems = in.elems().size();
+
+    std::vector<Kind> kinds(nElems);
+    std::map<std::type_index, Kind> kindOfType;
+    for (std::size_t e = 0; e < nElems; e++) {
+        const Geometry::ElemR* elem = in.elems()(e);
+        const std::type_index type(typeid(*elem));
+        std::map<std::type_index, Kind>::const_iterator it =
+            kindOfType.find(type);
+        if (it == kindOfType.end()) {
+            Kind kind = Kind::none;
+            if (elem->is<Geometry::LinR2>()) {
+                kind = Kind::line;
+            } else if (elem->is<Geometry::Tri>()) {
+                kind = Kind::triangle;
+            } else if (elem->is<Geometry::QuaR4>()) {
+                kind = Kind::quadrilateral;
+            }
+            it = kindOfType.insert(std::make_pair(type, kind)).first;
+        }
+        kinds[e] = it->second;
+    }
+
+    // Elements are meshed in batches whose cells are merged in order, so
+    // the result does not depend on the number of threads.
+    const std::size_t batchSize = 1024;
+    const std::size_t nBatches = (nElems + batchSize - 1) / batchSize;
+    std::vector<std::vector<Cell>> batchCells(nBatches);
+    std::exception_ptr error;
+    long long errorBatch = nBatches;
+#pragma omp parallel for schedule(dynamic)
+    for (long long b = 0; b < (long long) nBatches; b++) {
+        try {
+            const std::size_t end =
+                std::min<std::size_t>((b+1)*batchSize, nElems);
+            for (std::size_t e = b*batchSize; e < end; e++) {
+                const Geometry::ElemR* elem = in.elems()(e);
+                Math::CVecR3 v[4];
+                const std::size_t nV = (kinds[e] == Kind::line) ? 2 :
+                                       (kinds[e] == Kind::triangle) ? 3 :
+                                       (kinds[e] == Kind::quadrilateral) ?
+                                       4 : 0;
+                for (std::size_t i = 0; i < nV; i++) {
+                    v[i] = snapPos_(grid, elem->getVertex(i)->pos());
+                }
+                if (kinds[e] == Kind::line) {
+                    meshLine_(grid, elem, v, batchCells[b]);
+                } else if (nV > 2) {
+                    // Quadrilaterals are split along their 0-2 diagonal.
+                    meshTriangle_(grid, elem, v, batchCells[b]);
+                    if (nV == 4) {
+                        const Math::CVecR3 w[3] = {v[0], v[2], v[3]};
+                        meshTriangle_(grid, elem, w, batchCells[b]);
+                    }
+                }
+            }
+        } catch (...) {
+#pragma omp critical (StaircaseMesherMesh)
+            {
+                if (b < errorBatch) {
+                    errorBatch = b;
+                    error = std::current_exception();
+                }
+            }
+        }
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+
+    // Keeps the first cell of each material, layer and position.
+    std::vector<Cell> cells;
+    std::set<Cell> found;
+    for (std::size_t b = 0; b < nBatches; b++) {
+        for (std::size_t i = 0; i < batchCells[b].size(); i++) {
+            if (found.insert(batchCells[b][i]).second) {
+                cells.push_back(batchCells[b][i]);
+            }
+        }
+        std::vector<Cell>().swap(batchCells[b]);
+    }
+
+    std::vector<std::vector<Math::CVecI3>> cellNodes(cells.size());
+    std::vector<Math::CVecI3> nodes;
+    for (std::size_t c = 0; c < cells.size(); c++) {
+        const Cell& cell = cells[c];
+        std::vector<Math::CVecI3>& v = cellNodes[c];
+        v.push_back(cell.lo);
+        const std::size_t a = cell.isLine ? cell.axis : (cell.axis+1)%3;
+        const std::size_t b = (cell.axis+2)%3;
+        v.push_back(cell.lo);
+        v.back()(a)++;
+        if (!cell.isLine) {
+            v.push_back(v.back());
+            v.back()(b)++;
+            v.push_back(cell.lo);
+            v.back()(b)++;
+            if (cell.reversed) {
+                std::reverse(v.begin() + 1, v.end());
+            }
+        }
+        nodes.insert(nodes.end(), v.begin(), v.end());
+    }
+    std::sort(nodes.begin(), nodes.end(), isLexLower);
+    nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+
+    std::vector<Geometry::CoordI3*> newCoords(nodes.size());
+    for (std::size_t i = 0; i < nodes.size(); i++) {
+        newCoords[i] = new Geometry::CoordI3(Geometry::CoordId(i+1),
+                                             nodes[i]);
+    }
+    std::vector<Geometry::ElemI*> newElems(cells.size());
+#pragma omp parallel for schedule(static)
+    for (long long c = 0; c < (long long) cells.size(); c++) {
+        const Geometry::CoordI3* v[4];
+        for (std::size_t i = 0; i < cellNodes[c].size(); i++) {
+            v[i] = newCoords[std::lower_bound(nodes.begin(), nodes.end(),
+                                              cellNodes[c][i], isLexLower) -
+                             nodes.begin()];
+        }
+        const Geometry::ElemR* elem = cells[c].elem;
+        if (cells[c].isLine) {
+            newElems[c] = new Geometry::LinI2(Geometry::ElemId(c+1), v,
+                                              elem->getLayer(),
+                                              elem->getModel());
+        } else {
+            newElems[c] = new Geometry::QuaI4(Geometry::ElemId(c+1), v,
+                                              elem->getLayer(),
+                                              elem->getModel());
+        }
+    }
+
+    Geometry::Mesh::Structured* res = new Geometry::Mesh::Structured(grid);
+    res->coords().add(newCoords);
+    res->elems().add(newElems);
+    res->layers() = in.layers().cloneElems();
+    return res;
+}
+
+Math::CVecR3 StaircaseMesher::snapPos_(const Geometry::Grid3& grid,
+                                       const Math::CVecR3& pos) const {
+    if (!snap_) {
+        return pos;
+    }
+    Math::CVecR3 res = pos;
+    for (std::size_t d = 0; d < 3; d++) {
+        const std::vector<Math::Real>& gridPos = grid.getPos(d);
+        if (gridPos.size() < 2) {
+            continue;
+        }
+        std::size_t k =
+            std::upper_bound(gridPos.begin(), gridPos.end(), pos(d)) -
+            gridPos.begin();
+        k = std::min<std::size_t>(std::max<std::size_t>(k, 1),
+                                  gridPos.size() - 1);
+        const Math::Real step = gridPos[k] - gridPos[k-1];
+        const Math::Real plane = gridPos[getNearestPlane(gridPos, pos(d))];
+        if (std::abs(pos(d) - plane) <= forbiddenLength_*step) {
+            res(d) = plane;
+        }
+    }
+    return res;
+}
+
+void StaircaseMesher::meshTriangle_(const Geometry::Grid3& grid,
+                                    const Geometry::ElemR* elem,
+                                    const Math::CVecR3 v[3],
+                                    std::vector<Cell>& cells) const {
+    for (std::size_t d = 0; d < 3; d++) {
+        const std::size_t a = (d+1)%3;
+        const std::size_t b = (d+2)%3;
+        // Twice the signed area projected along d, its sign is the one of
+        // the d component of the normal.
+        const Math::Real area = (v[1](a) - v[0](a))*(v[2](b) - v[0](b)) -
+                                (v[1](b) - v[0](b))*(v[2](a) - v[0](a));
+        if (area == 0.0) {
+            continue;
+        }
+        const std::vector<Math::Real>& posA = grid.getPos(a);
+        const std::vector<Math::Real>& posB = grid.getPos(b);
+        const std::vector<Math::Real>& posD = grid.getPos(d);
+        if (posA.size() < 2 || posB.size() < 2 || posD.empty()) {
+            continue;
+        }
+        Math::Real min[3], max[3];
+        for (std::size_t k = 0; k < 3; k++) {
+            min[k] = std::min(std::min(v[0](k), v[1](k)), v[2](k));
+            max[k] = std::max(std::max(v[0](k), v[1](k)), v[2](k));
+        }
+        const std::size_t iBegin = std::max<std::ptrdiff_t>(0,
+            std::upper_bound(posA.begin(), posA.end(), min[a]) -
+            posA.begin() - 1);
+        const std::size_t iEnd = std::min<std::size_t>(posA.size() - 1,
+            std::lower_bound(posA.begin(), posA.end(), max[a]) -
+            posA.begin());
+        const std::size_t jBegin = std::max<std::ptrdiff_t>(0,
+            std::upper_bound(posB.begin(), posB.end(), min[b]) -
+            posB.begin() - 1);
+        const std::size_t jEnd = std::min<std::size_t>(posB.size() - 1,
+            std::lower_bound(posB.begin(), posB.end(), max[b]) -
+            posB.begin());
+        for (std::size_t i = iBegin; i < iEnd; i++) {
+            const Math::Real xa = 0.5*(posA[i] + posA[i+1]);
+            for (std::size_t j = jBegin; j < jEnd; j++) {
+                const Math::Real xb = 0.5*(posB[j] + posB[j+1]);
+                Math::Real w[3];
+                bool inside = true;
+                for (std::size_t k = 0; k < 3 && inside; k++) {
+                    const Math::CVecR3& p = v[(k+1)%3];
+                    const Math::CVecR3& q = v[(k+2)%3];
+                    w[k] = ((q(a) - p(a))*(xb - p(b)) -
+                            (q(b) - p(b))*(xa - p(a))) / area;
+                    inside = (w[k] >= 0.0);
+                }
+                if (!inside) {
+                    continue;
+                }
+                const Math::Real x =
+                    (w[0]*v[0](d) + w[1]*v[1](d) + w[2]*v[2](d)) /
+                    (w[0] + w[1] + w[2]);
+                if (x < posD.front() || x > posD.back()) {
+                    continue;
+                }
+                Cell cell;
+                cell.elem     = elem;
+                cell.isLine   = false;
+                cell.axis     = d;
+                cell.lo(a)    = i;
+                cell.lo(b)    = j;
+                cell.lo(d)    = getNearestPlane(posD, x);
+                cell.reversed = (area < 0.0);
+                cells.push_back(cell);
+            }
+        }
+    }
+}
+
+void StaircaseMesher::meshLine_(const Geometry::Grid3& grid,
+                                const Geometry::ElemR* elem,
+                                const Math::CVecR3 v[2],
+                                std::vector<Cell>& cells) const {
+    Math::CVecI3 cur, end;
+    for (std::size_t d = 0; d < 3; d++) {
+        if (grid.getPos(d).empty()) {
+            return;
+        }
+        cur(d) = getNearestPlane(grid.getPos(d), v[0](d));
+        end(d) = getNearestPlane(grid.getPos(d), v[1](d));
+    }
+    // Each step moves along the axis leaving the next node closest to the
+    // line.
+    while (cur != end) {
+        std::size_t best = 3;
+        Math::Real bestDist = std::numeric_limits<Math::Real>::max();
+        Math::CVecI3 next;
+        for (std::size_t d = 0; d < 3; d++) {
+            if (cur(d) == end(d)) {
+                continue;
+            }
+            Math::CVecI3 aux = cur;
+            aux(d) += (end(d) > cur(d)) ? 1 : -1;
+            const Math::CVecR3 pos(grid.getPos(0)[aux(0)],
+                                   grid.getPos(1)[aux(1)],
+                                   grid.getPos(2)[aux(2)]);
+            const Math::Real dist = getDistanceToSegment(pos, v[0], v[1]);
+            if (dist < bestDist) {
+                best = d;
+                bestDist = dist;
+                next = aux;
+            }
+        }
+        Cell cell;
+        cell.elem     = elem;
+        cell.isLine   = true;
+        cell.axis     = best;
+        cell.lo       = cur;
+        cell.lo(best) = std::min(cur(best), next(best));
+        cell.reversed = false;
+        cells.push_back(cell);
+        cur = next;
+    }
+}
+
+} /* namespace Mesher */
+} /* namespace SEMBA */
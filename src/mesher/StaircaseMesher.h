@@ -0,0 +1,85 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SEMBA_MESHER_STAIRCASEMESHER_H_
+#define SEMBA_MESHER_STAIRCASEMESHER_H_
+
+#include <vector>
+
+#include "Options.h"
+#include "geometry/mesh/Geometric.h"
+#include "geometry/mesh/Structured.h"
+
+namespace SEMBA {
+namespace Mesher {
+
+// Approximates the surfaces and lines of a mesh by faces and edges of its
+// grid. A triangle is probed by the lines along each axis passing through
+// the centres of the cell faces normal to it; every hit places the cell
+// face on the grid plane nearest to it, oriented as the triangle. Lines
+// are replaced by the chain of grid edges closest to them between the
+// nodes nearest to their ends. When snapping is enabled coordinates
+// closer to a grid plane than the forbidden length, relative to the local
+// step, are first moved onto it; this also keeps geometry lying slightly
+// outside the grid bounds. Every coordinate is within half a step of a
+// plane, so the forbidden length must be lower than 0.5.
+class StaircaseMesher {
+public:
+    StaircaseMesher(const Options& opts);
+
+    bool       isSnap() const { return snap_; }
+    Math::Real getForbiddenLength() const { return forbiddenLength_; }
+
+    Geometry::Mesh::Structured* mesh(
+            const Geometry::Mesh::Geometric& mesh) const;
+
+private:
+    // Grid face (normal along axis) or grid edge (along axis) whose lower
+    // node is lo, created for elem.
+    struct Cell {
+        const Geometry::ElemR* elem;
+        bool                   isLine;
+        std::size_t            axis;
+        Math::CVecI3           lo;
+        bool                   reversed;
+
+        bool operator<(const Cell& rhs) const;
+    };
+
+    bool snap_;
+    Math::Real forbiddenLength_;
+
+    Math::CVecR3 snapPos_(const Geometry::Grid3& grid,
+                          const Math::CVecR3& pos) const;
+    void meshTriangle_(const Geometry::Grid3& grid,
+                       const Geometry::ElemR* elem,
+                       const Math::CVecR3 v[3],
+                       std::vector<Cell>& cells) const;
+    void meshLine_(const Geometry::Grid3& grid,
+                   const Geometry::ElemR* elem,
+                   const Math::CVecR3 v[2],
+                   std::vector<Cell>& cells) const;
+};
+
+} /* namespace Mesher */
+} /* namespace SEMBA */
+
+#endif /* SEMBA_MESHER_STAIRCASEMESHER_H_ */
@@ -0,0 +1,428 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#include "SubcellAverager.h"
+
+#include <algorithm>
+#include <exception>
+#include <map>
+#include <string>
+#include <typeindex>
+
+#include "geometry/element/Triangle.h"
+#include "geometry/element/Quadrilateral4.h"
+#include "geometry/element/Hexahedron8.h"
+#include "physicalModel/volume/Classic.h"
+#include "physicalModel/volume/AnisotropicTensor.h"
+
+namespace SEMBA {
+namespace Mesher {
+
+namespace {
+
+typedef std::map<MatId, const PhysicalModel::Volume::Classic*> Materials;
+
+struct Triangle {
+    Math::CVecR3 v[3];
+};
+
+// Fractions under this tolerance, or above one minus it, are rounding.
+const Math::Real tolerance = 1e-9;
+
+bool isLexLower(const Math::CVecR3& lhs, const Math::CVecR3& rhs) {
+    for (std::size_t d = 0; d < 3; d++) {
+        if (lhs(d) != rhs(d)) {
+            return lhs(d) < rhs(d);
+        }
+    }
+    return false;
+}
+
+// Twice the signed area of (p, q, (x,y)) in the xy plane. Shared edges are
+// evaluated from their lexicographically lower vertex, so neighbouring
+// triangles get exactly opposite values.
+Math::Real getEdgeFunction(const Math::CVecR3& p, const Math::CVecR3& q,
+                           const Math::Real x, const Math::Real y) {
+    if (isLexLower(q, p)) {
+        return -getEdgeFunction(q, p, x, y);
+    }
+    return (q(0) - p(0))*(y - p(1)) - (q(1) - p(1))*(x - p(0));
+}
+
+// Height at which the line along z through (x,y) crosses the triangle.
+// Lines through an edge or vertex shared by triangles seen from the same
+// side cross only one of them, so closed surfaces give an even count.
+bool getCrossing(const Triangle& tri, const Math::Real x, const Math::Real y,
+                 Math::Real& z) {
+    const Math::CVecR3* v = tri.v;
+    const Math::Real area = getEdgeFunction(v[0], v[1], v[2](0), v[2](1));
+    if (area == 0.0) {
+        return false;
+    }
+    const Math::Real sign = (area > 0.0) ? 1.0 : -1.0;
+    Math::Real w[3];
+    for (std::size_t k = 0; k < 3; k++) {
+        const Math::CVecR3& p = v[(k+1)%3];
+        const Math::CVecR3& q = v[(k+2)%3];
+        const Math::Real e = sign*getEdgeFunction(p, q, x, y);
+        if (e < 0.0) {
+            return false;
+        }
+        if (e == 0.0) {
+            const Math::Real dx = sign*(q(0) - p(0));
+            const Math::Real dy = sign*(q(1) - p(1));
+            if (dy > 0.0 || (dy == 0.0 && dx < 0.0)) {
+                return false;
+            }
+        }
+        w[k] = e;
+    }
+    const Math::Real sum = w[0] + w[1] + w[2];
+    z = (w[0]*v[0](2) + w[1]*v[1](2) + w[2]*v[2](2)) / sum;
+    return true;
+}
+
+Materials getMaterials(const Geometry::Mesh::Geometric& mesh) {
+    Materials res;
+    std::map<const Geometry::Element::Model*, bool> visited;
+    for (std::size_t e = 0; e < mesh.elems().size(); e++) {
+        const Geometry::Element::Model* model =
+            mesh.elems()(e)->getModel();
+        if (model == nullptr || visited.count(model) != 0) {
+            continue;
+        }
+        visited[model] = true;
+        const PhysicalModel::Volume::Classic* classic =
+            dynamic_cast<const PhysicalModel::Volume::Classic*>(model);
+        if (classic != nullptr) {
+            res[classic->getId()] = classic;
+        }
+    }
+    return res;
+}
+
+// Index of the first cell reaching beyond x and of the last cell starting
+// before y, plus one.
+std::pair<std::size_t, std::size_t> getCellRange(
+        const std::vector<Math::Real>& pos,
+        const Math::Real x, const Math::Real y) {
+    const std::size_t nCells = pos.size() - 1;
+    std::size_t first = std::upper_bound(pos.begin(), pos.end(), x) -
+                        pos.begin();
+    first = (first == 0) ? 0 : first - 1;
+    const std::size_t last = std::min<std::size_t>(nCells,
+        std::lower_bound(pos.begin(), pos.end(), y) - pos.begin());
+    return std::make_pair(first, std::max(first, last));
+}
+
+Math::MatR33 getTensor(const Math::Real parallel,
+                       const Math::Real normal,
+                       const Math::CVecR3& n) {
+    Math::MatR33 res;
+    for (std::size_t r = 0; r < 3; r++) {
+        for (std::size_t c = 0; c < 3; c++) {
+            const Math::Real nn = n(r)*n(c);
+            res(r,c) = normal*nn + parallel*(((r == c) ? 1.0 : 0.0) - nn);
+        }
+    }
+    return res;
+}
+
+} /* namespace */
+
+SubcellAverager::SubcellAverager(const std::size_t samples)
+:   samples_(std::max<std::size_t>(samples, 1)) {
+
+}
+
+SubcellAverager::SubcellAverager(const Options& opts)
+:   samples_(4) {
+    if (opts.getSubgridPoints() > 0) {
+        samples_ = opts.getSubgridPoints();
+    }
+}
+
+std::vector<SubcellAverager::Fill> SubcellAverager::getFills(
+        const Geometry::Mesh::Geometric& mesh) const {
+    const Geometry::Grid3& grid = mesh.grid();
+    const std::vector<Math::Real>& posX = grid.getPos(0);
+    const std::vector<Math::Real>& posY = grid.getPos(1);
+    const std::vector<Math::Real>& posZ = grid.getPos(2);
+    if (posX.size() < 2 || posY.size() < 2 || posZ.size() < 2) {
+        return std::vector<Fill>();
+    }
+    const std::size_t nx = posX.size() - 1;
+    const std::size_t ny = posY.size() - 1;
+    const std::size_t nz = posZ.size() - 1;
+
+    const Materials materials = getMaterials(mesh);
+    std::vector<MatId> matIds;
+    std::map<MatId, std::size_t> matIndex;
+    for (Materials::const_iterator it = materials.begin();
+         it != materials.end(); ++it) {
+        matIndex[it->first] = matIds.size();
+        matIds.push_back(it->first);
+    }
+    const std::size_t nMats = matIds.size();
+
+    // Triangles of each material, quadrilaterals split along 0-2.
+    std::vector<Triangle> tris;
+    std::vector<std::size_t> triMat;
+    std::map<std::type_index, std::size_t> cornersOfType;
+    for (std::size_t e = 0; e < mesh.elems().size(); e++) {
+        const Geometry::ElemR* elem = mesh.elems()(e);
+        std::map<MatId, std::size_t>::const_iterator mat =
+            matIndex.find(elem->getMatId());
+        if (elem->getModel() == nullptr || mat == matIndex.end()) {
+            continue;
+        }
+        const std::type_index type(typeid(*elem));
+        if (cornersOfType.count(type) == 0) {
+            cornersOfType[type] = elem->is<Geometry::Tri>()   ? 3 :
+                                  elem->is<Geometry::QuaR4>() ? 4 : 0;
+        }
+        const std::size_t corners = cornersOfType[type];
+        for (std::size_t s = 0; s + 2 < corners; s++) {
+            Triangle tri;
+            tri.v[0] = elem->getVertex(0)->pos();
+            tri.v[1] = elem->getVertex(s+1)->pos();
+            tri.v[2] = elem->getVertex(s+2)->pos();
+            tris.push_back(tri);
+            triMat.push_back(mat->second);
+        }
+    }
+
+    // Triangles are binned by the xy columns of cells they may cross.
+    std::vector<std::vector<std::size_t>> bins(nx*ny);
+    for (std::size_t t = 0; t < tris.size(); t++) {
+        const Math::CVecR3* v = tris[t].v;
+        const std::pair<std::size_t, std::size_t> rx = getCellRange(posX,
+            std::min(std::min(v[0](0), v[1](0)), v[2](0)),
+            std::max(std::max(v[0](0), v[1](0)), v[2](0)));
+        const std::pair<std::size_t, std::size_t> ry = getCellRange(posY,
+            std::min(std::min(v[0](1), v[1](1)), v[2](1)),
+            std::max(std::max(v[0](1), v[1](1)), v[2](1)));
+        for (std::size_t i = rx.first; i < rx.second; i++) {
+            for (std::size_t j = ry.first; j < ry.second; j++) {
+                bins[i*ny + j].push_back(t);
+            }
+        }
+    }
+
+    const std::size_t s = samples_;
+    std::vector<std::vector<Fill>> binFills(bins.size());
+    std::exception_ptr error;
+    long long errorBin = bins.size();
+#pragma omp parallel for schedule(dynamic)
+    for (long long b = 0; b < (long long) bins.size(); b++) {
+        if (bins[b].empty()) {
+            continue;
+        }
+        try {
+            const std::size_t i = b / ny;
+            const std::size_t j = b % ny;
+            // Filled length and its first moments per cell and material.
+            std::vector<Math::Real> acc(nz*nMats*4, 0.0);
+            std::vector<std::pair<std::size_t, Math::Real>> crossings;
+            for (std::size_t qx = 0; qx < s; qx++) {
+                const Math::Real x =
+                    posX[i] + (qx + 0.5)/s*(posX[i+1] - posX[i]);
+                for (std::size_t qy = 0; qy < s; qy++) {
+                    const Math::Real y =
+                        posY[j] + (qy + 0.5)/s*(posY[j+1] - posY[j]);
+                    crossings.clear();
+                    for (std::size_t n = 0; n < bins[b].size(); n++) {
+                        const std::size_t t = bins[b][n];
+                        Math::Real z;
+                        if (getCrossing(tris[t], x, y, z)) {
+                            crossings.push_back(std::make_pair(triMat[t], z));
+                        }
+                    }
+                    std::sort(crossings.begin(), crossings.end());
+                    for (std::size_t c = 0; c + 1 < crossings.size(); c++) {
+                        const std::size_t m = crossings[c].first;
+                        if (crossings[c+1].first != m) {
+                            // Surface not closed along this line.
+                            continue;
+                        }
+                        const Math::Real z0 = crossings[c].second;
+                        const Math::Real z1 = crossings[c+1].second;
+                        const std::pair<std::size_t, std::size_t> rz =
+                            getCellRange(posZ, z0, z1);
+                        for (std::size_t k = rz.first; k < rz.second; k++) {
+                            const Math::Real lo = std::max(z0, posZ[k]);
+                            const Math::Real hi = std::min(z1, posZ[k+1]);
+                            if (hi <= lo) {
+                                continue;
+                            }
+                            Math::Real* a = &acc[(k*nMats + m)*4];
+                            a[0] += hi - lo;
+                            a[1] += (hi - lo)*x;
+                            a[2] += (hi - lo)*y;
+                            a[3] += (hi - lo)*0.5*(hi + lo);
+                        }
+                        c++;
+                    }
+                }
+            }
+            for (std::size_t k = 0; k < nz; k++) {
+                const Math::CVecR3 lo(posX[i], posY[j], posZ[k]);
+                const Math::CVecR3 hi(posX[i+1], posY[j+1], posZ[k+1]);
+                const Math::Real full = s*s*(hi(2) - lo(2));
+                Fill fill;
+                fill.cell = Math::CVecI3(i, j, k);
+                bool isPartial = false;
+                Math::Real largest = 0.0;
+                for (std::size_t m = 0; m < nMats; m++) {
+                    const Math::Real* a = &acc[(k*nMats + m)*4];
+                    const Math::Real f = a[0] / full;
+                    if (f <= tolerance) {
+                        continue;
+                    }
+                    fill.fractions.push_back(
+                        std::make_pair(matIds[m], std::min(f, 1.0)));
+                    if (f < 1.0 - tolerance) {
+                        isPartial = true;
+                        if (f > largest) {
+                            largest = f;
+                            const Math::CVecR3 centroid(a[1]/a[0],
+                                                        a[2]/a[0],
+                                                        a[3]/a[0]);
+                            fill.normal = (lo + hi)/2.0 - centroid;
+                            if (fill.normal.norm() > 0.0) {
+                                fill.normal.normalize();
+                            }
+                        }
+                    }
+                }
+                if (isPartial) {
+                    binFills[b].push_back(fill);
+                }
+            }
+        } catch (...) {
+#pragma omp critical (SubcellAveragerGetFills)
+            {
+                if (b < errorBin) {
+                    errorBin = b;
+                    error = std::current_exception();
+                }
+            }
+        }
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+
+    std::vector<Fill> res;
+    for (std::size_t b = 0; b < binFills.size(); b++) {
+        res.insert(res.end(), binFills[b].begin(), binFills[b].end());
+    }
+    return res;
+}
+
+Geometry::Mesh::Structured* SubcellAverager::average(
+        const Geometry::Mesh::Geometric& mesh,
+        PhysicalModel::Group<>& models) const {
+    const Materials materials = getMaterials(mesh);
+    const std::vector<Fill> fills = getFills(mesh);
+
+    std::map<std::vector<Math::Real>, std::size_t> mediumIndex;
+    std::vector<PhysicalModel::PhysicalModel*> newModels;
+    std::vector<std::size_t> fillModel(fills.size());
+    for (std::size_t f = 0; f < fills.size(); f++) {
+        // Vacuum fills what the materials leave.
+        Math::Real background = 1.0;
+        Math::Real parallel[4] = {0.0, 0.0, 0.0, 0.0};
+        Math::Real inverse[4] = {0.0, 0.0, 0.0, 0.0};
+        bool isZero[4] = {false, false, false, false};
+        for (std::size_t m = 0; m < fills[f].fractions.size(); m++) {
+            const Math::Real frac = fills[f].fractions[m].second;
+            const PhysicalModel::Volume::Classic* mat =
+                materials.at(fills[f].fractions[m].first);
+            const Math::Real value[4] = {mat->getRelativePermittivity(),
+                                         mat->getRelativePermeability(),
+                                         mat->getElectricConductivity(),
+                                         mat->getMagneticConductivity()};
+            for (std::size_t p = 0; p < 4; p++) {
+                parallel[p] += frac*value[p];
+                if (value[p] == 0.0) {
+                    isZero[p] = true;
+                } else {
+                    inverse[p] += frac/value[p];
+                }
+            }
+            background -= frac;
+        }
+        background = std::max(background, 0.0);
+        const Math::Real vacuum[4] = {1.0, 1.0, 0.0, 0.0};
+        Math::MatR33 tensor[4];
+        std::vector<Math::Real> key;
+        for (std::size_t p = 0; p < 4; p++) {
+            parallel[p] += background*vacuum[p];
+            if (vacuum[p] == 0.0 && background > tolerance) {
+                isZero[p] = true;
+            } else if (vacuum[p] != 0.0) {
+                inverse[p] += background/vacuum[p];
+            }
+            const Math::Real normal = isZero[p] ? 0.0 : 1.0/inverse[p];
+            if (fills[f].normal.norm() == 0.0) {
+                tensor[p] = getTensor(parallel[p], parallel[p],
+                                      fills[f].normal);
+            } else {
+                tensor[p] = getTensor(parallel[p], normal, fills[f].normal);
+            }
+            for (std::size_t r = 0; r < 3; r++) {
+                for (std::size_t c = 0; c < 3; c++) {
+                    key.push_back(tensor[p](r,c));
+                }
+            }
+        }
+        std::map<std::vector<Math::Real>, std::size_t>::const_iterator it =
+            mediumIndex.find(key);
+        if (it == mediumIndex.end()) {
+            const std::size_t index = newModels.size();
+            newModels.push_back(new PhysicalModel::Volume::AnisotropicTensor(
+                    PhysicalModel::Id(0),
+                    "Subcell average " + std::to_string(index + 1),
+                    tensor[0], tensor[1], tensor[2], tensor[3]));
+            it = mediumIndex.insert(std::make_pair(key, index)).first;
+        }
+        fillModel[f] = it->second;
+    }
+    models.addId(newModels);
+
+    Geometry::Mesh::Structured* res =
+        new Geometry::Mesh::Structured(mesh.grid());
+    std::vector<Geometry::ElemI*> elems;
+    elems.reserve(fills.size());
+    for (std::size_t f = 0; f < fills.size(); f++) {
+        const Math::CVecI3& cell = fills[f].cell;
+        elems.push_back(new Geometry::HexI8(res->coords(),
+                Geometry::ElemId(f+1),
+                Geometry::BoxI3(cell, cell + Math::CVecI3(1)),
+                nullptr, newModels[fillModel[f]]));
+    }
+    res->elems().add(elems);
+    return res;
+}
+
+} /* namespace Mesher */
+} /* namespace SEMBA */
@@ -0,0 +1,74 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SEMBA_MESHER_SUBCELLAVERAGER_H_
+#define SEMBA_MESHER_SUBCELLAVERAGER_H_
+
+#include <utility>
+#include <vector>
+
+#include "Options.h"
+#include "geometry/mesh/Geometric.h"
+#include "geometry/mesh/Structured.h"
+#include "physicalModel/Group.h"
+
+namespace SEMBA {
+namespace Mesher {
+
+// Computes the fraction of each grid cell filled by the volumes enclosed by
+// closed surfaces of Volume::Classic materials, so that cells cut by them
+// can be given an effective medium instead of being staircased. Cells are
+// probed by samples x samples lines along z, whose crossings with the
+// surfaces are found exactly; the filled length of each line is then
+// accumulated per cell. Unlisted space is vacuum. The normal of a cell
+// points from the centroid of its filled part to the cell centre.
+class SubcellAverager {
+public:
+    struct Fill {
+        Math::CVecI3                              cell;
+        std::vector<std::pair<MatId, Math::Real>> fractions;
+        Math::CVecR3                              normal;
+    };
+
+    SubcellAverager(const std::size_t samples = 4);
+    SubcellAverager(const Options& opts);
+
+    std::size_t getSamples() const { return samples_; }
+
+    // Cells partially filled by any material, sorted by (i,j,k).
+    std::vector<Fill> getFills(const Geometry::Mesh::Geometric& mesh) const;
+
+    // Averages the materials of each partially filled cell: arithmetically
+    // along the interface and harmonically across it. Models are added to
+    // the group with new ids, cells sharing a medium share its model, and
+    // the returned mesh has one HexI8 per cell.
+    Geometry::Mesh::Structured* average(
+            const Geometry::Mesh::Geometric& mesh,
+            PhysicalModel::Group<>& models) const;
+
+private:
+    std::size_t samples_;
+};
+
+} /* namespace Mesher */
+} /* namespace SEMBA */
+
+#endif /* SEMBA_MESHER_SUBCELLAVERAGER_H_ */
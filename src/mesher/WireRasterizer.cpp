@@ -0,0 +1,311 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#include "WireRasterizer.h"
+
+#include <algorithm>
+#include <exception>
+#include <limits>
+#include <map>
+#include <typeindex>
+
+#include "geometry/element/Line2.h"
+#include "physicalModel/wire/Wire.h"
+
+namespace SEMBA {
+namespace Mesher {
+
+namespace {
+
+// Index of the node whose dual cell contains x: the nearest one, the lower
+// on ties.
+Math::Int getNode(const std::vector<Math::Real>& pos, const Math::Real x) {
+    const std::size_t k =
+        std::lower_bound(pos.begin(), pos.end(), x) - pos.begin();
+    if (k == 0) {
+        return 0;
+    }
+    if (k == pos.size()) {
+        return pos.size() - 1;
+    }
+    return (x - pos[k-1] <= pos[k] - x) ? k-1 : k;
+}
+
+// Bound of the dual cell of node n along the direction of sign.
+Math::Real getDualBound(const std::vector<Math::Real>& pos,
+                        const Math::Int n, const Math::Int sign) {
+    if (sign > 0) {
+        if (n + 1 >= Math::Int(pos.size())) {
+            return std::numeric_limits<Math::Real>::infinity();
+        }
+        return 0.5*(pos[n] + pos[n+1]);
+    }
+    if (n == 0) {
+        return -std::numeric_limits<Math::Real>::infinity();
+    }
+    return 0.5*(pos[n-1] + pos[n]);
+}
+
+struct Segment {
+    std::size_t                     elem;
+    Geometry::CoordId               v[2];
+    const Geometry::Element::Model* model;
+};
+
+} /* namespace */
+
+std::vector<WireRasterizer::Wire> WireRasterizer::getWires(
+        const Geometry::Mesh::Geometric& mesh) const {
+    std::vector<Segment> segments;
+    std::map<std::type_index, bool> isLineType;
+    std::map<const Geometry::Element::Model*, bool> isWireModel;
+    for (std::size_t e = 0; e < mesh.elems().size(); e++) {
+        const Geometry::ElemR* elem = mesh.elems()(e);
+        const Geometry::Element::Model* model = elem->getModel();
+        if (model == nullptr) {
+            continue;
+        }
+        if (isWireModel.count(model) == 0) {
+            isWireModel[model] =
+                dynamic_cast<const PhysicalModel::Wire::Wire*>(model) !=
+                nullptr;
+        }
+        const std::type_index type(typeid(*elem));
+        if (isLineType.count(type) == 0) {
+            isLineType[type] = elem->is<Geometry::LinR2>();
+        }
+        if (!isWireModel[model] || !isLineType[type]) {
+            continue;
+        }
+        Segment seg;
+        seg.elem  = e;
+        seg.v[0]  = elem->getV(0)->getId();
+        seg.v[1]  = elem->getV(1)->getId();
+        seg.model = model;
+        segments.push_back(seg);
+    }
+
+    std::map<Geometry::CoordId, std::vector<std::size_t>> adjacent;
+    for (std::size_t s = 0; s < segments.size(); s++) {
+        adjacent[segments[s].v[0]].push_back(s);
+        if (segments[s].v[1] != segments[s].v[0]) {
+            adjacent[segments[s].v[1]].push_back(s);
+        }
+    }
+    // Polylines end at extremes, junctions and changes of model.
+    std::map<Geometry::CoordId, bool> isBreak;
+    for (std::map<Geometry::CoordId, std::vector<std::size_t>>::
+         const_iterator it = adjacent.begin(); it != adjacent.end(); ++it) {
+        const std::vector<std::size_t>& segs = it->second;
+        isBreak[it->first] = (segs.size() != 2) ||
+            (segments[segs[0]].model != segments[segs[1]].model);
+    }
+
+    // Polylines are followed from the segments leaving a break along their
+    // own orientation, then from those reaching one and finally the loops.
+    std::vector<Wire> res;
+    std::vector<std::vector<Geometry::CoordId>> vertices;
+    std::vector<bool> visited(segments.size(), false);
+    for (std::size_t pass = 0; pass < 3; pass++) {
+        for (std::size_t s = 0; s < segments.size(); s++) {
+            if (visited[s]) {
+                continue;
+            }
+            std::size_t side;
+            if (pass == 0 && isBreak[segments[s].v[0]]) {
+                side = 0;
+            } else if (pass == 1 && isBreak[segments[s].v[1]]) {
+                side = 1;
+            } else if (pass == 2) {
+                side = 0;
+            } else {
+                continue;
+            }
+            const Geometry::ElemR* first =
+                mesh.elems()(segments[s].elem);
+            Wire wire;
+            wire.model  = first->getModel();
+            wire.layer  = first->getLayer();
+            wire.closed = false;
+            wire.length = 0.0;
+            std::vector<Geometry::CoordId> ids(1, segments[s].v[side]);
+            std::size_t cur = s;
+            while (true) {
+                visited[cur] = true;
+                wire.elems.push_back(
+                        mesh.elems()(segments[cur].elem)->getId());
+                const Geometry::CoordId next =
+                    (segments[cur].v[0] == ids.back()) ?
+                    segments[cur].v[1] : segments[cur].v[0];
+                ids.push_back(next);
+                if (isBreak[next]) {
+                    break;
+                }
+                const std::vector<std::size_t>& segs = adjacent[next];
+                const std::size_t other = (segs[0] == cur) ? segs[1] : segs[0];
+                if (visited[other]) {
+                    wire.closed = true;
+                    break;
+                }
+                cur = other;
+            }
+            res.push_back(wire);
+            vertices.push_back(ids);
+        }
+    }
+
+    const Geometry::Grid3& grid = mesh.grid();
+    std::exception_ptr error;
+    long long errorWire = res.size();
+#pragma omp parallel for schedule(dynamic)
+    for (long long w = 0; w < (long long) res.size(); w++) {
+        try {
+            std::vector<Math::CVecR3> points;
+            points.reserve(vertices[w].size());
+            for (std::size_t i = 0; i < vertices[w].size(); i++) {
+                points.push_back(
+                        mesh.coords().getId(vertices[w][i])->pos());
+            }
+            rasterize_(grid, points, res[w]);
+        } catch (...) {
+#pragma omp critical (WireRasterizerGetWires)
+            {
+                if (w < errorWire) {
+                    errorWire = w;
+                    error = std::current_exception();
+                }
+            }
+        }
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    return res;
+}
+
+Geometry::Mesh::Structured* WireRasterizer::getMeshStructured(
+        const Geometry::Grid3& grid,
+        const std::vector<Wire>& wires) {
+    Geometry::Mesh::Structured* res = new Geometry::Mesh::Structured(grid);
+    std::vector<Geometry::ElemI*> elems;
+    for (std::size_t w = 0; w < wires.size(); w++) {
+        for (std::size_t i = 0; i + 1 < wires[w].nodes.size(); i++) {
+            const Geometry::CoordI3* v[2];
+            for (std::size_t j = 0; j < 2; j++) {
+                const Math::CVecI3& pos = wires[w].nodes[i+j];
+                v[j] = res->coords().getPos(pos);
+                if (v[j] == nullptr) {
+                    v[j] = res->coords().addPos(
+                            std::vector<Math::CVecI3>(1, pos))(0);
+                }
+            }
+            elems.push_back(new Geometry::LinI2(
+                    Geometry::ElemId(elems.size()+1), v,
+                    wires[w].layer, wires[w].model));
+        }
+    }
+    res->elems().add(elems);
+    return res;
+}
+
+void WireRasterizer::rasterize_(const Geometry::Grid3& grid,
+                                const std::vector<Math::CVecR3>& points,
+                                Wire& wire) const {
+    const std::vector<Math::Real>* pos[3] = {&grid.getPos(0),
+                                             &grid.getPos(1),
+                                             &grid.getPos(2)};
+    for (std::size_t d = 0; d < 3; d++) {
+        if (pos[d]->empty()) {
+            return;
+        }
+    }
+    Math::CVecI3 cur;
+    for (std::size_t d = 0; d < 3; d++) {
+        cur(d) = getNode(*pos[d], points[0](d));
+    }
+    // Nodes visited and the length along the wire at which they are entered.
+    std::vector<Math::CVecI3> nodes(1, cur);
+    std::vector<Math::Real> enter(1, 0.0);
+    Math::Real offset = 0.0;
+    for (std::size_t i = 0; i + 1 < points.size(); i++) {
+        const Math::CVecR3& a = points[i];
+        const Math::CVecR3& b = points[i+1];
+        const Math::Real length = (b - a).norm();
+        if (length == 0.0) {
+            continue;
+        }
+        Math::Int sign[3];
+        Math::Real tNext[3];
+        for (std::size_t d = 0; d < 3; d++) {
+            sign[d] = (b(d) > a(d)) ? 1 : (b(d) < a(d)) ? -1 : 0;
+            tNext[d] = std::numeric_limits<Math::Real>::infinity();
+            if (sign[d] != 0) {
+                tNext[d] = (getDualBound(*pos[d], cur(d), sign[d]) - a(d)) /
+                           (b(d) - a(d));
+            }
+        }
+        while (true) {
+            std::size_t d = 0;
+            for (std::size_t k = 1; k < 3; k++) {
+                if (tNext[k] < tNext[d]) {
+                    d = k;
+                }
+            }
+            if (!(tNext[d] < 1.0)) {
+                break;
+            }
+            cur(d) += sign[d];
+            nodes.push_back(cur);
+            enter.push_back(offset + std::max(tNext[d], 0.0)*length);
+            tNext[d] = (getDualBound(*pos[d], cur(d), sign[d]) - a(d)) /
+                       (b(d) - a(d));
+        }
+        // Ends lying on a dual face are settled by the nearest node rule.
+        for (std::size_t d = 0; d < 3; d++) {
+            const Math::Int target = getNode(*pos[d], b(d));
+            while (cur(d) != target) {
+                cur(d) += (target > cur(d)) ? 1 : -1;
+                nodes.push_back(cur);
+                enter.push_back(offset + length);
+            }
+        }
+        offset += length;
+    }
+    wire.length = offset;
+    wire.nodes = nodes;
+    wire.lengths.clear();
+    if (nodes.size() < 2) {
+        return;
+    }
+    std::vector<Math::Real> middle(nodes.size());
+    for (std::size_t k = 0; k < nodes.size(); k++) {
+        const Math::Real exit = (k + 1 < nodes.size()) ? enter[k+1] : offset;
+        middle[k] = 0.5*(enter[k] + exit);
+    }
+    for (std::size_t k = 0; k + 1 < nodes.size(); k++) {
+        wire.lengths.push_back(middle[k+1] - middle[k]);
+    }
+    wire.lengths.front() += middle.front();
+    wire.lengths.back()  += offset - middle.back();
+}
+
+} /* namespace Mesher */
+} /* namespace SEMBA */
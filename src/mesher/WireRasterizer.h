@@ -0,0 +1,70 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SEMBA_MESHER_WIRERASTERIZER_H_
+#define SEMBA_MESHER_WIRERASTERIZER_H_
+
+#include <vector>
+
+#include "geometry/mesh/Geometric.h"
+#include "geometry/mesh/Structured.h"
+
+namespace SEMBA {
+namespace Mesher {
+
+// Maps thin wires to chains of grid edges. The LinR2 elements of wire
+// models are joined into polylines which are broken at extremes, at
+// junctions and where the model changes. Each polyline is traversed with a
+// digital differential analyser over the dual grid, whose cells surround
+// the grid nodes: every dual face crossed is a grid edge, so chains are
+// contiguous and a point always maps to its nearest node, which keeps
+// junctions and extremes shared. Every edge records the length of wire it
+// stands for, running between the middles of the stays of the wire around
+// its two nodes, so that lengths add up to the length of the polyline.
+class WireRasterizer {
+public:
+    struct Wire {
+        const Geometry::Element::Model* model;
+        const Geometry::Layer::Layer*   layer;
+        std::vector<Geometry::ElemId>   elems;
+        bool                            closed;
+        Math::Real                      length;
+        std::vector<Math::CVecI3>       nodes;
+        std::vector<Math::Real>         lengths;
+    };
+
+    std::vector<Wire> getWires(const Geometry::Mesh::Geometric& mesh) const;
+
+    // Creates a LinI2 per edge of the wires, with their model and layer.
+    static Geometry::Mesh::Structured* getMeshStructured(
+            const Geometry::Grid3& grid,
+            const std::vector<Wire>& wires);
+
+private:
+    void rasterize_(const Geometry::Grid3& grid,
+                    const std::vector<Math::CVecR3>& points,
+                    Wire& wire) const;
+};
+
+} /* namespace Mesher */
+} /* namespace SEMBA */
+
+#endif /* SEMBA_MESHER_WIRERASTERIZER_H_ */
@@ -0,0 +1,116 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SEMBA_PARSER_BINARY_MESHFORMAT_H_
+#define SEMBA_PARSER_BINARY_MESHFORMAT_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace SEMBA {
+namespace Parser {
+namespace Binary {
+
+// Layout of the binary mesh files written next to a project so that its
+// mesh can be loaded again without parsing text. The file starts with a
+// MeshHeader followed by the sections it points to, each one starting at a
+// multiple of MeshAlignment. Values are stored with the byte order of the
+// writing host.
+//
+// - coordIds and coordPos hold the id and the three positions of each
+//   coordinate, as std::uint64_t and double.
+// - Grid sections hold the grid lines of geometric meshes as doubles, and
+//   are empty otherwise.
+// - layerIds holds std::uint64_t ids and layerNames the names of the same
+//   layers, each one ended by a null character.
+// - elemTypes holds the ElementType of every element, as std::uint8_t, in
+//   the order of the mesh.
+// - Each ElementType has its own ids (std::uint64_t), material and layer
+//   ids (std::uint32_t, 0 for none) and vertices, NumVertices per element
+//   given as std::uint32_t positions in coordIds.
+enum ElementType {
+    node = 0,
+    line2,
+    triangle3,
+    triangle6,
+    quadrilateral4,
+    tetrahedron4,
+    tetrahedron10,
+    hexahedron8,
+    numElementTypes
+};
+
+static const std::size_t NumVertices[numElementTypes] = {1,2,3,6,4,4,10,8};
+
+enum MeshSectionId {
+    coordIds = 0,
+    coordPos,
+    gridX,
+    gridY,
+    gridZ,
+    layerIds,
+    layerNames,
+    elemTypes,
+    firstElemSection
+};
+
+enum ElementField {
+    elemIds = 0,
+    elemMats,
+    elemLayers,
+    elemVertices,
+    numElementFields
+};
+
+static const std::size_t NumMeshSections =
+        firstElemSection + numElementTypes*numElementFields;
+
+inline std::size_t getMeshSection(const std::size_t type,
+                                  const ElementField field) {
+    return firstElemSection + type*numElementFields + field;
+}
+
+enum MeshFlag {
+    hasGrid = 1
+};
+
+static const char          MeshMagic[8]  = {'S','M','B','M','E','S','H',0};
+static const std::uint32_t MeshVersion   = 1;
+static const std::size_t   MeshAlignment = 64;
+
+struct MeshSection {
+    std::uint64_t offset;
+    std::uint64_t bytes;
+    std::uint64_t count;
+};
+
+struct MeshHeader {
+    char          magic[8];
+    std::uint32_t version;
+    std::uint32_t flags;
+    MeshSection   sections[NumMeshSections];
+};
+
+} /* namespace Binary */
+} /* namespace Parser */
+} /* namespace SEMBA */
+
+#endif /* SEMBA_PARSER_BINARY_MESHFORMAT_H_ */
@@ -0,0 +1,352 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#include "MeshReader.h"
+
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include "geometry/mesh/Geometric.h"
+#include "geometry/element/Node.h"
+#include "geometry/element/Line2.h"
+#include "geometry/element/Triangle3.h"
+#include "geometry/element/Triangle6.h"
+#include "geometry/element/Quadrilateral4.h"
+#include "geometry/element/Tetrahedron4.h"
+#include "geometry/element/Tetrahedron10.h"
+#include "geometry/element/Hexahedron8.h"
+
+namespace SEMBA {
+namespace Parser {
+namespace Binary {
+
+namespace {
+
+std::size_t getValueSize(const std::size_t section) {
+    switch (section) {
+    case coordIds:
+    case layerIds:
+        return sizeof(std::uint64_t);
+    case coordPos:
+    case gridX:
+    case gridY:
+    case gridZ:
+        return sizeof(double);
+    case layerNames:
+    case elemTypes:
+        return sizeof(std::uint8_t);
+    default:
+        if ((section - firstElemSection) % numElementFields == elemIds) {
+            return sizeof(std::uint64_t);
+        }
+        return sizeof(std::uint32_t);
+    }
+}
+
+template<typename T>
+Geometry::ElemR* newElem(const MeshReader& reader,
+                         const std::size_t type,
+                         const std::size_t n,
+                         const std::vector<Geometry::CoordR3*>& coords,
+                         const std::unordered_map<std::size_t,
+                                 const Geometry::Layer::Layer*>& layers,
+                         const PhysicalModel::Group<>& mG) {
+    const std::uint64_t id =
+            reader.get<std::uint64_t>(getMeshSection(type, elemIds))[n];
+    const std::uint32_t mat =
+            reader.get<std::uint32_t>(getMeshSection(type, elemMats))[n];
+    const std::uint32_t lay =
+            reader.get<std::uint32_t>(getMeshSection(type, elemLayers))[n];
+    const std::uint32_t* vIds =
+            reader.get<std::uint32_t>(getMeshSection(type, elemVertices)) +
+            n*NumVertices[type];
+
+    const Geometry::CoordR3* v[NumVertices[hexahedron8] + 2];
+    for (std::size_t i = 0; i < NumVertices[type]; i++) {
+        if (vIds[i] >= coords.size()) {
+            throw std::logic_error("Binary mesh element " +
+                    std::to_string(id) + " has a wrong vertex.");
+        }
+        v[i] = coords[vIds[i]];
+    }
+    const Geometry::Layer::Layer* layPtr = nullptr;
+    if (lay != 0) {
+        std::unordered_map<std::size_t, const Geometry::Layer::Layer*>::
+            const_iterator it = layers.find(lay);
+        if (it == layers.end()) {
+            throw std::logic_error("Binary mesh element " +
+                    std::to_string(id) + " has a wrong layer.");
+        }
+        layPtr = it->second;
+    }
+    const PhysicalModel::PhysicalModel* matPtr = nullptr;
+    if (mat != 0) {
+        matPtr = mG.getId(MatId(mat));
+    }
+    return new T(Geometry::ElemId(id), v, layPtr, matPtr);
+}
+
+}
+
+MeshReader::MeshReader(const std::string& filename)
+:   file_(new FileSystem::MappedFile(filename)),
+    data_(file_->data()),
+    size_(file_->size()) {
+    check_();
+}
+
+MeshReader::MeshReader(const char* data, const std::size_t size)
+:   data_(data),
+    size_(size) {
+    check_();
+}
+
+MeshReader::~MeshReader() {
+
+}
+
+const MeshHeader& MeshReader::header() const {
+    return *reinterpret_cast<const MeshHeader*>(data_);
+}
+
+Geometry::Mesh::Unstructured* MeshReader::read(
+        const PhysicalModel::Group<>& mG,
+        const LoadOptions& options) const {
+    // Sections too long to be checked on construction are checked here,
+    // before anything is created, and only if they are read.
+    if (options.reads(LoadOptions::elements)) {
+        checkElemTypes_();
+    }
+    if (options.reads(LoadOptions::layers)) {
+        checkLayerNames_();
+    }
+    const long long numCoords =
+            options.reads(LoadOptions::coordinates) ? count(coordIds) : 0;
+    const std::uint64_t* cIds = get<std::uint64_t>(coordIds);
+    const double* cPos = get<double>(coordPos);
+    std::vector<Geometry::CoordR3*> coords(numCoords);
+#pragma omp parallel for
+    for (long long i = 0; i < numCoords; i++) {
+        coords[i] = new Geometry::CoordR3(
+                Geometry::CoordId(cIds[i]),
+                Math::CVecR3(cPos[3*i], cPos[3*i+1], cPos[3*i+2]));
+    }
+
+    std::vector<Geometry::Layer::Layer*> layers(
+            options.reads(LoadOptions::layers) ? count(layerIds) : 0);
+    std::unordered_map<std::size_t, const Geometry::Layer::Layer*> layerIds_;
+    const char* name = get<char>(layerNames);
+    for (std::size_t i = 0; i < layers.size(); i++) {
+        layers[i] = new Geometry::Layer::Layer(
+                Geometry::LayerId(get<std::uint64_t>(layerIds)[i]), name);
+        layerIds_[layers[i]->getId().toInt()] = layers[i];
+        name += std::strlen(name) + 1;
+    }
+
+    // Elements of each type are created concurrently and then interleaved
+    // in the order of elemTypes. Elements not kept by options are left null.
+    // On failure the error of the first failing element of the type is
+    // thrown, as in a serial loop.
+    const bool readElems = options.reads(LoadOptions::elements);
+    std::vector<Geometry::ElemR*> byType[numElementTypes];
+    std::exception_ptr error;
+    for (std::size_t t = 0; t < numElementTypes && readElems && !error; t++) {
+        const long long n = count(getMeshSection(t, elemIds));
+        long long errorElem = n;
+        const std::uint32_t* mats =
+                get<std::uint32_t>(getMeshSection(t, elemMats));
+        const std::uint32_t* lays =
+                get<std::uint32_t>(getMeshSection(t, elemLayers));
+        byType[t].resize(n, nullptr);
+#pragma omp parallel for
+        for (long long e = 0; e < n; e++) {
+            if (!options.keepsElement(mats[e], lays[e])) {
+                continue;
+            }
+            try {
+                Geometry::ElemR* elem;
+                switch (t) {
+                case node:
+                    elem = newElem<Geometry::NodR>(
+                            *this, t, e, coords, layerIds_, mG);
+                    break;
+                case line2:
+                    elem = newElem<Geometry::LinR2>(
+                            *this, t, e, coords, layerIds_, mG);
+                    break;
+                case triangle3:
+                    elem = newElem<Geometry::Tri3>(
+                            *this, t, e, coords, layerIds_, mG);
+                    break;
+                case triangle6:
+                    elem = newElem<Geometry::Tri6>(
+                            *this, t, e, coords, layerIds_, mG);
+                    break;
+                case quadrilateral4:
+                    elem = newElem<Geometry::QuaR4>(
+                            *this, t, e, coords, layerIds_, mG);
+                    break;
+                case tetrahedron4:
+                    elem = newElem<Geometry::Tet4>(
+                            *this, t, e, coords, layerIds_, mG);
+                    break;
+                case tetrahedron10:
+                    elem = newElem<Geometry::Tet10>(
+                            *this, t, e, coords, layerIds_, mG);
+                    break;
+                default:
+                    elem = newElem<Geometry::HexR8>(
+                            *this, t, e, coords, layerIds_, mG);
+                    break;
+                }
+                byType[t][e] = elem;
+            }
+            catch (...) {
+#pragma omp critical (BinaryMeshReaderRead)
+                {
+                    if (e < errorElem) {
+                        errorElem = e;
+                        error = std::current_exception();
+                    }
+                }
+            }
+        }
+    }
+    std::vector<Geometry::ElemR*> elems;
+    if (readElems && !error) {
+        const std::uint8_t* types = get<std::uint8_t>(elemTypes);
+        std::size_t next[numElementTypes] = {};
+        elems.reserve(count(elemTypes));
+        for (std::size_t e = 0; e < count(elemTypes); e++) {
+            Geometry::ElemR* elem = byType[types[e]][next[types[e]]++];
+            if (elem != nullptr) {
+                elems.push_back(elem);
+            }
+        }
+    }
+    if (error) {
+        for (std::size_t t = 0; t < numElementTypes; t++) {
+            for (std::size_t e = 0; e < byType[t].size(); e++) {
+                delete byType[t][e];
+            }
+        }
+        for (std::size_t i = 0; i < coords.size(); i++) {
+            delete coords[i];
+        }
+        for (std::size_t i = 0; i < layers.size(); i++) {
+            delete layers[i];
+        }
+        std::rethrow_exception(error);
+    }
+
+    Geometry::Mesh::Unstructured* res;
+    if (header().flags & hasGrid) {
+        std::vector<Math::Real> pos[3];
+        for (std::size_t d = 0;
+             d < 3 && options.reads(LoadOptions::grids); d++) {
+            const double* p = get<double>(gridX+d);
+            pos[d].assign(p, p + count(gridX+d));
+        }
+        res = new Geometry::Mesh::Geometric(Geometry::Grid3(pos));
+    } else {
+        res = new Geometry::Mesh::Unstructured();
+    }
+    res->coords().add(coords);
+    res->layers().add(layers);
+    res->elems().add(elems);
+    return res;
+}
+
+void MeshReader::check_() const {
+    if (size_ < sizeof(MeshHeader) ||
+        std::memcmp(header().magic, MeshMagic, sizeof(MeshMagic)) != 0) {
+        throw std::logic_error("File is not a binary mesh.");
+    }
+    if (header().version != MeshVersion) {
+        throw std::logic_error("Binary mesh version " +
+                std::to_string(header().version) + " is not supported.");
+    }
+    for (std::size_t s = 0; s < NumMeshSections; s++) {
+        const MeshSection& section = header().sections[s];
+        if (section.offset % MeshAlignment != 0 ||
+            section.offset > size_ ||
+            section.bytes > size_ - section.offset ||
+            section.bytes != section.count * getValueSize(s)) {
+            throw std::logic_error("Binary mesh section " +
+                    std::to_string(s) + " is corrupt.");
+        }
+    }
+    std::size_t numElems = 0;
+    for (std::size_t t = 0; t < numElementTypes; t++) {
+        const std::size_t n = count(getMeshSection(t, elemIds));
+        if (count(getMeshSection(t, elemMats)) != n ||
+            count(getMeshSection(t, elemLayers)) != n ||
+            count(getMeshSection(t, elemVertices)) != n*NumVertices[t]) {
+            throw std::logic_error("Binary mesh elements are corrupt.");
+        }
+        numElems += n;
+    }
+    if (count(elemTypes) != numElems ||
+        count(coordPos) != 3*count(coordIds)) {
+        throw std::logic_error("Binary mesh sections are inconsistent.");
+    }
+    const char* names = get<char>(layerNames);
+    if (count(layerNames) < count(layerIds) ||
+        (count(layerNames) > 0 && names[count(layerNames)-1] != '\0')) {
+        throw std::logic_error("Binary mesh layers are corrupt.");
+    }
+}
+
+void MeshReader::checkElemTypes_() const {
+    const std::uint8_t* types = get<std::uint8_t>(elemTypes);
+    std::size_t numOfType[numElementTypes] = {};
+    for (std::size_t e = 0; e < count(elemTypes); e++) {
+        if (types[e] >= numElementTypes) {
+            throw std::logic_error("Binary mesh element type is corrupt.");
+        }
+        numOfType[types[e]]++;
+    }
+    for (std::size_t t = 0; t < numElementTypes; t++) {
+        if (numOfType[t] != count(getMeshSection(t, elemIds))) {
+            throw std::logic_error("Binary mesh element types are corrupt.");
+        }
+    }
+}
+
+void MeshReader::checkLayerNames_() const {
+    const char* names = get<char>(layerNames);
+    std::size_t numNames = 0;
+    for (std::size_t i = 0; i < count(layerNames); i++) {
+        if (names[i] == '\0') {
+            numNames++;
+        }
+    }
+    if (numNames != count(layerIds)) {
+        throw std::logic_error("Binary mesh layers are corrupt.");
+    }
+}
+
+} /* namespace Binary */
+} /* namespace Parser */
+} /* namespace SEMBA */
@@ -0,0 +1,84 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SEMBA_PARSER_BINARY_MESHREADER_H_
+#define SEMBA_PARSER_BINARY_MESHREADER_H_
+
+#include <memory>
+#include <string>
+
+#include "filesystem/MappedFile.h"
+#include "geometry/mesh/Unstructured.h"
+#include "parser/LoadOptions.h"
+#include "physicalModel/Group.h"
+
+#include "MeshFormat.h"
+
+namespace SEMBA {
+namespace Parser {
+namespace Binary {
+
+// Maps a file written by MeshWriter. The sections can be used in place
+// through get, or converted into a mesh with read. Files with a wrong
+// header or inconsistent section sizes throw std::logic_error on
+// construction, which does not visit the sections. The element types and
+// layer names are checked by read, when they are read.
+class MeshReader {
+public:
+    MeshReader(const std::string& filename);
+    // Reads a mesh stored in memory which must outlive the reader and be
+    // aligned to MeshAlignment.
+    MeshReader(const char* data, const std::size_t size);
+    virtual ~MeshReader();
+
+    const MeshHeader& header() const;
+
+    std::size_t count(const std::size_t section) const {
+        return header().sections[section].count;
+    }
+    template<typename T>
+    const T* get(const std::size_t section) const {
+        return reinterpret_cast<const T*>(
+                data_ + header().sections[section].offset);
+    }
+
+    // Elements refer to the models in mG by id. A Mesh::Geometric is
+    // returned for files holding a grid. Sections which options skips are
+    // left empty and never touched, so they are not even paged in.
+    Geometry::Mesh::Unstructured* read(
+            const PhysicalModel::Group<>& mG,
+            const LoadOptions& options = LoadOptions()) const;
+
+private:
+    std::unique_ptr<FileSystem::MappedFile> file_;
+    const char* data_;
+    std::size_t size_;
+
+    void check_() const;
+    void checkElemTypes_() const;
+    void checkLayerNames_() const;
+};
+
+} /* namespace Binary */
+} /* namespace Parser */
+} /* namespace SEMBA */
+
+#endif /* SEMBA_PARSER_BINARY_MESHREADER_H_ */
@@ -0,0 +1,262 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#include "MeshWriter.h"
+
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+
+#include "geometry/mesh/Geometric.h"
+#include "geometry/element/Node.h"
+#include "geometry/element/Line2.h"
+#include "geometry/element/Triangle3.h"
+#include "geometry/element/Triangle6.h"
+#include "geometry/element/Quadrilateral4.h"
+#include "geometry/element/Tetrahedron4.h"
+#include "geometry/element/Tetrahedron10.h"
+#include "geometry/element/Hexahedron8.h"
+
+namespace SEMBA {
+namespace Parser {
+namespace Binary {
+
+namespace {
+
+std::uint64_t align(const std::uint64_t offset) {
+    return (offset + MeshAlignment - 1) / MeshAlignment * MeshAlignment;
+}
+
+std::size_t getType(const Geometry::ElemR* elem) {
+    static const std::type_index types[numElementTypes] = {
+            typeid(Geometry::NodR),
+            typeid(Geometry::LinR2),
+            typeid(Geometry::Tri3),
+            typeid(Geometry::Tri6),
+            typeid(Geometry::QuaR4),
+            typeid(Geometry::Tet4),
+            typeid(Geometry::Tet10),
+            typeid(Geometry::HexR8)};
+    const std::type_index type(typeid(*elem));
+    for (std::size_t t = 0; t < numElementTypes; t++) {
+        if (type == types[t]) {
+            return t;
+        }
+    }
+    throw std::logic_error("Element " + elem->getId().toStr() +
+                           " has a type not supported by binary meshes.");
+}
+
+}
+
+void MeshWriter::write(const Data& data, const std::string& filename) {
+    if (data.mesh == nullptr ||
+        !data.mesh->is<Geometry::Mesh::Unstructured>()) {
+        throw std::logic_error("Binary meshes need an unstructured mesh.");
+    }
+    write(*data.mesh->castTo<Geometry::Mesh::Unstructured>(), filename);
+}
+
+void MeshWriter::write(const Geometry::Mesh::Unstructured& mesh,
+                       const std::string& filename) {
+    std::ofstream file(filename.c_str(), std::ios::out | std::ios::binary);
+    if (!file.is_open()) {
+        throw std::logic_error("Can not open file: " + filename);
+    }
+    write(mesh, file);
+    if (!file) {
+        throw std::logic_error("Error writing file: " + filename);
+    }
+}
+
+void MeshWriter::write(const Geometry::Mesh::Unstructured& mesh,
+                       std::ostream& stream) {
+    MeshHeader header;
+    std::memset(&header, 0, sizeof(MeshHeader));
+    std::memcpy(header.magic, MeshMagic, sizeof(MeshMagic));
+    header.version = MeshVersion;
+
+    const Geometry::CoordR3Group& cG = mesh.coords();
+    const long long numCoords = cG.size();
+    if (cG.size() > std::numeric_limits<std::uint32_t>::max()) {
+        throw std::logic_error("Too many coordinates for a binary mesh.");
+    }
+    std::vector<std::uint64_t> cIds(numCoords);
+    std::vector<double> cPos(3*numCoords);
+    std::unordered_map<const Geometry::CoordR3*, std::uint32_t> cIndex;
+    cIndex.reserve(numCoords);
+    for (long long i = 0; i < numCoords; i++) {
+        cIndex[cG(i)] = i;
+    }
+#pragma omp parallel for
+    for (long long i = 0; i < numCoords; i++) {
+        cIds[i] = cG(i)->getId().toInt();
+        for (std::size_t d = 0; d < 3; d++) {
+            cPos[3*i+d] = cG(i)->pos()(d);
+        }
+    }
+
+    std::vector<double> grid[3];
+    if (mesh.is<Geometry::Mesh::Geometric>()) {
+        header.flags |= hasGrid;
+        const Geometry::Grid3& g =
+                mesh.castTo<Geometry::Mesh::Geometric>()->grid();
+        for (std::size_t d = 0; d < 3; d++) {
+            grid[d].assign(g.getPos(d).begin(), g.getPos(d).end());
+        }
+    }
+
+    std::vector<std::uint64_t> lIds;
+    std::string lNames;
+    for (std::size_t i = 0; i < mesh.layers().size(); i++) {
+        lIds.push_back(mesh.layers()(i)->getId().toInt());
+        lNames += mesh.layers()(i)->getName();
+        lNames.push_back('\0');
+    }
+
+    // Types and positions within their type are found serially, the
+    // arrays of each type are then filled concurrently.
+    const Geometry::Element::Group<Geometry::ElemR>& elems = mesh.elems();
+    const long long numElems = elems.size();
+    std::vector<std::uint8_t> types(numElems);
+    std::vector<std::size_t> posInType(numElems);
+    std::size_t numOfType[numElementTypes] = {};
+    for (long long e = 0; e < numElems; e++) {
+        types[e] = getType(elems(e));
+        posInType[e] = numOfType[types[e]]++;
+    }
+    std::vector<std::uint64_t> eIds[numElementTypes];
+    std::vector<std::uint32_t> eMats[numElementTypes];
+    std::vector<std::uint32_t> eLayers[numElementTypes];
+    std::vector<std::uint32_t> eVertices[numElementTypes];
+    for (std::size_t t = 0; t < numElementTypes; t++) {
+        eIds[t].resize(numOfType[t]);
+        eMats[t].resize(numOfType[t]);
+        eLayers[t].resize(numOfType[t]);
+        eVertices[t].resize(numOfType[t]*NumVertices[t]);
+    }
+    bool missingCoord = false;
+    bool largeId = false;
+#pragma omp parallel for
+    for (long long e = 0; e < numElems; e++) {
+        const Geometry::ElemR* elem = elems(e);
+        const std::size_t t = types[e];
+        const std::size_t n = posInType[e];
+        const std::size_t matId = elem->getMatId().toInt();
+        const std::size_t layId = elem->getLayerId().toInt();
+        if (matId > std::numeric_limits<std::uint32_t>::max() ||
+            layId > std::numeric_limits<std::uint32_t>::max()) {
+#pragma omp atomic write
+            largeId = true;
+        }
+        eIds[t][n] = elem->getId().toInt();
+        eMats[t][n] = static_cast<std::uint32_t>(matId);
+        eLayers[t][n] = static_cast<std::uint32_t>(layId);
+        for (std::size_t v = 0; v < NumVertices[t]; v++) {
+            std::unordered_map<const Geometry::CoordR3*, std::uint32_t>::
+                const_iterator it = cIndex.find(elem->getVertex(v));
+            if (it == cIndex.end()) {
+#pragma omp atomic write
+                missingCoord = true;
+            } else {
+                eVertices[t][n*NumVertices[t] + v] = it->second;
+            }
+        }
+    }
+    if (missingCoord) {
+        throw std::logic_error(
+                "Mesh elements use coordinates which are not in the mesh.");
+    }
+    if (largeId) {
+        throw std::logic_error(
+                "Material or layer ids too large for a binary mesh.");
+    }
+
+    const void* data[NumMeshSections];
+    std::size_t sizes[NumMeshSections];
+    std::size_t counts[NumMeshSections];
+    data[coordIds] = cIds.data();
+    sizes[coordIds] = sizeof(std::uint64_t);
+    counts[coordIds] = cIds.size();
+    data[coordPos] = cPos.data();
+    sizes[coordPos] = sizeof(double);
+    counts[coordPos] = cPos.size();
+    for (std::size_t d = 0; d < 3; d++) {
+        data[gridX+d] = grid[d].data();
+        sizes[gridX+d] = sizeof(double);
+        counts[gridX+d] = grid[d].size();
+    }
+    data[layerIds] = lIds.data();
+    sizes[layerIds] = sizeof(std::uint64_t);
+    counts[layerIds] = lIds.size();
+    data[layerNames] = lNames.data();
+    sizes[layerNames] = 1;
+    counts[layerNames] = lNames.size();
+    data[elemTypes] = types.data();
+    sizes[elemTypes] = sizeof(std::uint8_t);
+    counts[elemTypes] = types.size();
+    for (std::size_t t = 0; t < numElementTypes; t++) {
+        std::size_t s = getMeshSection(t, elemIds);
+        data[s] = eIds[t].data();
+        sizes[s] = sizeof(std::uint64_t);
+        counts[s] = eIds[t].size();
+        s = getMeshSection(t, elemMats);
+        data[s] = eMats[t].data();
+        sizes[s] = sizeof(std::uint32_t);
+        counts[s] = eMats[t].size();
+        s = getMeshSection(t, elemLayers);
+        data[s] = eLayers[t].data();
+        sizes[s] = sizeof(std::uint32_t);
+        counts[s] = eLayers[t].size();
+        s = getMeshSection(t, elemVertices);
+        data[s] = eVertices[t].data();
+        sizes[s] = sizeof(std::uint32_t);
+        counts[s] = eVertices[t].size();
+    }
+
+    std::uint64_t offset = sizeof(MeshHeader);
+    for (std::size_t s = 0; s < NumMeshSections; s++) {
+        MeshSection& section = header.sections[s];
+        offset = align(offset);
+        section.offset = offset;
+        section.count = counts[s];
+        section.bytes = counts[s] * sizes[s];
+        offset += section.bytes;
+    }
+
+    const std::vector<char> padding(MeshAlignment, 0);
+    stream.write(reinterpret_cast<const char*>(&header), sizeof(MeshHeader));
+    std::uint64_t written = sizeof(MeshHeader);
+    for (std::size_t s = 0; s < NumMeshSections; s++) {
+        const MeshSection& section = header.sections[s];
+        stream.write(padding.data(), section.offset - written);
+        stream.write(static_cast<const char*>(data[s]), section.bytes);
+        written = section.offset + section.bytes;
+    }
+}
+
+} /* namespace Binary */
+} /* namespace Parser */
+} /* namespace SEMBA */
@@ -0,0 +1,56 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SEMBA_PARSER_BINARY_MESHWRITER_H_
+#define SEMBA_PARSER_BINARY_MESHWRITER_H_
+
+#include <ostream>
+#include <string>
+
+#include "Data.h"
+#include "geometry/mesh/Unstructured.h"
+
+#include "MeshFormat.h"
+
+namespace SEMBA {
+namespace Parser {
+namespace Binary {
+
+// Writes unstructured and geometric meshes with the layout of MeshFormat.h.
+// Meshes holding elements of types not listed in ElementType, more
+// coordinates or material and layer ids than std::uint32_t holds throw
+// std::logic_error.
+class MeshWriter {
+public:
+    static void write(const Data& data, const std::string& filename);
+    static void write(const Geometry::Mesh::Unstructured& mesh,
+                      const std::string& filename);
+    // Offsets are written relative to the current position of the stream,
+    // which must be aligned to MeshAlignment to map the result.
+    static void write(const Geometry::Mesh::Unstructured& mesh,
+                      std::ostream& stream);
+};
+
+} /* namespace Binary */
+} /* namespace Parser */
+} /* namespace SEMBA */
+
+#endif /* SEMBA_PARSER_BINARY_MESHWRITER_H_ */
@@ -21,6 +21,9 @@
 
 #include "Parser.h"
 
+#include <exception>
+#include <memory>
+
 #include "math/function/Gaussian.h"
 #include "math/function/BandLimited.h"
 #include "geometry/element/Line2.h"
@@ -47,12 +50,29 @@
 #include "source/port/TEMCoaxial.h"
 #include "outputRequest/BulkCurrent.h"
 #include "outputRequest/FarField.h"
+#include "filesystem/Hash.h"
+#include "filesystem/InputStream.h"
+#include "filesystem/MappedFile.h"
+#include "parser/Scanner.h"
+#include "Snapshot.h"
 
 namespace SEMBA {
 namespace Parser {
 namespace JSON {
 
+Parser::Parser(const LoadOptions& options)
+:   options_(options) {
+
+}
+
 Data Parser::read(std::istream& stream) const {
+    if (!options_.isAll()) {
+        return readStreaming(stream);
+    }
+    return readTree_(stream);
+}
+
+Data Parser::readTree_(std::istream& stream) const {
 
     json j;
     try {
@@ -63,7 +83,7 @@ Data Parser::read(std::istream& stream) const {
     }
 
     Util::ProgressBar progress;
-    progress.init("Parser GiD-JSON", 7, 0);
+    progress.init("Parser GiD-JSON", 6, 0);
 
     std::string version = j.at("_version").get<std::string>();
     if (!checkVersionCompatibility(version)) {
@@ -83,23 +103,8 @@ Data Parser::read(std::istream& stream) const {
     res.mesh = readGeometricMesh(*res.physicalModels, j);
     progress.advance();
 
-    if (res.mesh != nullptr) {
-		readConnectorOnPoint(
-			*res.physicalModels,
-			*res.mesh->castTo<Geometry::Mesh::Geometric>(), j);
-		progress.advance();
-
-        res.sources = readSources(
-                *res.mesh->castTo<Geometry::Mesh::Geometric>(), j);
-        progress.advance();
-
-        res.outputRequests = readOutputRequests(
-                *res.mesh->castTo<Geometry::Mesh::Geometric>(), j);
-        progress.advance();
-    } else {
-        res.sources = new Source::Group<>();
-        res.outputRequests = new OutputRequest::Group<>();
-    }
+    readMeshDependents(res, j, options_);
+    progress.advance();
 
     postReadOperations(res);
     progress.advance();
@@ -109,6 +114,461 @@ Data Parser::read(std::istream& stream) const {
     return res;
 }
 
+// Coordinate and element records are gathered in batches of strings which
+// are parsed concurrently into flat records as soon as they are full. Groups
+// are built from those records at the end, when every section they refer
+// to is known. Record errors are kept until getMesh, as read discards the
+// mesh instead of failing when any of its sections is wrong.
+class Parser::StreamHandler : public SaxHandler {
+public:
+    StreamHandler(const LoadOptions& options)
+    :   options_(options),
+        depth_(0),
+        section_(none),
+        type_(-1),
+        hasCoords_(false),
+        hasElems_(false) {
+        records_.push_back(ElementRecords(Geometry::HexR8::sizeOfCoordinates));
+        records_.push_back(ElementRecords(Geometry::Tet4::sizeOfCoordinates));
+        records_.push_back(ElementRecords(Geometry::QuaR4::sizeOfCoordinates));
+        records_.push_back(ElementRecords(Geometry::Tri3::sizeOfCoordinates));
+        records_.push_back(ElementRecords(Geometry::LinR2::sizeOfCoordinates));
+    }
+
+    virtual ~StreamHandler() {}
+
+    void null() {
+        if (depth_ == 1) {
+            setMeta_(json());
+        } else if (section_ == meta) {
+            dom_.null();
+        } else if (isFlatValue_()) {
+            addNumber_("null", false);
+        }
+    }
+
+    void boolean(const bool value) {
+        if (depth_ == 1) {
+            setMeta_(json(value));
+        } else if (section_ == meta) {
+            dom_.boolean(value);
+        } else if (isFlatValue_()) {
+            addNumber_(value ? "true" : "false", false);
+        }
+    }
+
+    void number(const std::string& text) {
+        if (depth_ == 1) {
+            setMeta_(SaxDom::toNumber(text));
+        } else if (section_ == meta) {
+            dom_.number(text);
+        } else if (isFlatValue_()) {
+            addNumber_(text, true);
+        }
+    }
+
+    void string(const std::string& value) {
+        if (depth_ == 1) {
+            setMeta_(json(value));
+        } else if (section_ == meta) {
+            dom_.string(value);
+        } else if (isFlatValue_()) {
+            addNumber_(json(value).dump(), false);
+        } else if ((section_ == coordinates && depth_ == 2) ||
+                   (section_ == elements && depth_ == 3 && type_ >= 0)) {
+            batch_.push_back(value);
+            if (batch_.size() >= BatchSize) {
+                parseBatch_();
+            }
+        }
+    }
+
+    void key(const std::string& key) {
+        if (depth_ == 1) {
+            key_ = key;
+        } else if ((section_ == coordinates && depth_ == 2) ||
+                   (section_ == elements && depth_ == 3)) {
+            field_ = key;
+        } else if (section_ == elements && depth_ == 2) {
+            type_ = -1;
+            for (std::size_t t = 0; t < numTypes; t++) {
+                if (key == typeNames[t]) {
+                    type_ = t;
+                }
+            }
+        } else if (section_ == meta) {
+            dom_.key(key);
+        }
+    }
+
+    void startObject() {
+        if (depth_ == 0) {
+            depth_++;
+            return;
+        }
+        if (depth_ == 1) {
+            if (key_ == "elements") {
+                section_ = elements;
+                hasElems_ = true;
+            } else if (key_ == "coordinates") {
+                section_ = coordinates;
+                hasCoords_ = true;
+            } else {
+                section_ = meta;
+                dom_.clear();
+            }
+        }
+        if (section_ == meta) {
+            dom_.startObject();
+        }
+        depth_++;
+    }
+
+    void endObject() {
+        depth_--;
+        if (section_ == meta) {
+            dom_.endObject();
+        }
+        close_();
+    }
+
+    void startArray() {
+        if (depth_ == 0) {
+            throw std::logic_error("Project file is not a JSON object.");
+        }
+        if (depth_ == 1) {
+            section_ = (key_ == "coordinates") ? coordinates : meta;
+            if (section_ == coordinates) {
+                hasCoords_ = true;
+            } else {
+                dom_.clear();
+            }
+        }
+        if (section_ == meta) {
+            dom_.startArray();
+        }
+        depth_++;
+    }
+
+    void endArray() {
+        depth_--;
+        if (section_ == meta) {
+            dom_.endArray();
+        } else if (section_ == elements && depth_ == 2) {
+            parseBatch_();
+        }
+        close_();
+    }
+
+    bool skipValue() const {
+        const unsigned section = LoadOptions::getSection(key_);
+        return depth_ == 1 && section != 0 &&
+               !options_.reads(static_cast<LoadOptions::Section>(section));
+    }
+
+    const json& getMeta() const { return meta_; }
+
+    // Skipped sections are left empty.
+    Geometry::Mesh::Geometric* getMesh(const PhysicalModel::Group<>& mG) {
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
+        coordRecords_.checkSizes();
+        for (std::size_t t = 0; t < numTypes; t++) {
+            records_[t].checkSizes();
+        }
+        if ((!hasCoords_ && options_.reads(LoadOptions::coordinates)) ||
+            (!hasElems_ && options_.reads(LoadOptions::elements))) {
+            throw std::logic_error("Mesh sections were not found.");
+        }
+        Geometry::Grid3 grid;
+        if (options_.reads(LoadOptions::grids)) {
+            grid = readGrids(meta_);
+        }
+        Geometry::Layer::Group<> layers;
+        if (options_.reads(LoadOptions::layers)) {
+            layers = readLayers(meta_);
+        }
+        Geometry::CoordR3Group coords = readCoordinates(coordRecords_);
+        if (!options_.readsAllElements()) {
+            for (std::size_t t = 0; t < numTypes; t++) {
+                records_[t].filter(options_);
+            }
+        }
+        Geometry::Element::Group<Geometry::ElemR> elems;
+        elems.add(newElems<Geometry::HexR8>(mG, layers, coords, records_[0]));
+        elems.add(newElems<Geometry::Tet4> (mG, layers, coords, records_[1]));
+        elems.add(newElems<Geometry::QuaR4>(mG, layers, coords, records_[2]));
+        elems.add(newElems<Geometry::Tri3> (mG, layers, coords, records_[3]));
+        elems.add(newElems<Geometry::LinR2>(mG, layers, coords, records_[4]));
+        return new Geometry::Mesh::Geometric(grid, coords, elems, layers);
+    }
+
+private:
+    enum Section {
+        none,
+        meta,
+        coordinates,
+        elements
+    };
+
+    static const std::size_t BatchSize = 1 << 16;
+    static const std::size_t numTypes = 5;
+    static const char* typeNames[numTypes];
+
+    const LoadOptions& options_;
+    std::size_t depth_;
+    Section section_;
+    std::string key_, field_;
+    int type_;
+    SaxDom dom_;
+    json meta_;
+
+    bool hasCoords_, hasElems_;
+    std::vector<std::string> batch_;
+    CoordinateRecords coordRecords_;
+    std::vector<ElementRecords> records_;
+    std::exception_ptr error_;
+
+    void setMeta_(json&& value) {
+        if (key_ == "_version" &&
+            !checkVersionCompatibility(value.get<std::string>())) {
+            throw std::logic_error("File version " +
+                    value.get<std::string>() + " is not supported.");
+        }
+        meta_[key_] = std::move(value);
+    }
+
+    void close_() {
+        if (depth_ == 1) {
+            if (section_ == meta) {
+                meta_[key_] = std::move(dom_.get());
+            } else if (section_ == coordinates) {
+                parseBatch_();
+            }
+            section_ = none;
+        }
+    }
+
+    bool isFlatValue_() const {
+        return (section_ == coordinates && depth_ == 3) ||
+               (section_ == elements && depth_ == 4 && type_ >= 0);
+    }
+
+    // Values of the arrays of the flat layout are appended as they come.
+    // Values which are not numbers are given as text and fail as numbers
+    // which can not be read.
+    void addNumber_(const std::string& text, const bool isNumber) {
+        if (error_) {
+            return;
+        }
+        try {
+            Scanner scanner(text);
+            if (section_ == coordinates && field_ == "positions") {
+                Math::Real value;
+                if (!isNumber || !scanner.read(value) || !scanner.atEnd()) {
+                    throw std::logic_error("Coordinate position " + text +
+                                           " is not a number.");
+                }
+                coordRecords_.pos.push_back(value);
+                return;
+            }
+            std::vector<std::size_t>* values = nullptr;
+            if (section_ == coordinates && field_ == "ids") {
+                values = &coordRecords_.ids;
+            } else if (section_ == elements && field_ == "ids") {
+                values = &records_[type_].ids;
+            } else if (section_ == elements && field_ == "materials") {
+                values = &records_[type_].mats;
+            } else if (section_ == elements && field_ == "layers") {
+                values = &records_[type_].layers;
+            } else if (section_ == elements && field_ == "vertices") {
+                values = &records_[type_].vertices;
+            } else {
+                throw std::logic_error("Unknown mesh array \"" +
+                                       field_ + "\".");
+            }
+            std::size_t value;
+            if (!isNumber || !scanner.read(value) || !scanner.atEnd()) {
+                throw std::logic_error("Mesh " + field_ + " value " + text +
+                                       " is not an unsigned integer.");
+            }
+            values->push_back(value);
+        }
+        catch (...) {
+            error_ = std::current_exception();
+        }
+    }
+
+    void parseBatch_() {
+        if (!error_ && !batch_.empty()) {
+            try {
+                if (section_ == coordinates) {
+                    coordRecords_.add(batch_);
+                } else {
+                    records_[type_].add(batch_);
+                }
+            }
+            catch (...) {
+                error_ = std::current_exception();
+            }
+        }
+        batch_.clear();
+    }
+};
+
+const char* Parser::StreamHandler::typeNames[] = {
+        "hexahedra", "tetrahedra", "quadrilateral", "triangle", "line"};
+
+Data Parser::readStreaming(std::istream& stream) const {
+
+    StreamHandler handler(options_);
+    Sax(stream).parse(handler);
+    const json& j = handler.getMeta();
+
+    if (j.find("_version") == j.end()) {
+        throw std::logic_error("File version was not found.");
+    }
+
+    Data res;
+
+    res.solver = readSolver(j);
+    res.physicalModels = readPhysicalModels(j);
+    if (res.physicalModels == nullptr &&
+        !options_.reads(LoadOptions::materials)) {
+        res.physicalModels = new PhysicalModel::Group<>();
+    }
+    if (options_.readsMesh()) {
+        try {
+            res.mesh = handler.getMesh(*res.physicalModels);
+        }
+        catch (...) {
+            res.mesh = nullptr;
+        }
+    }
+    readMeshDependents(res, j, options_);
+
+    postReadOperations(res);
+
+    return res;
+}
+
+Data Parser::readCached(const std::string& filename,
+                        const std::string& cacheFolder) const {
+
+    const FileSystem::MappedFile file(filename);
+    const std::uint64_t key = FileSystem::hash(file.data(), file.size());
+    const std::string snapshotName =
+            cacheFolder + "/" + FileSystem::hashToStr(key) + ".smbsnap";
+
+    std::unique_ptr<Snapshot> snapshot;
+    try {
+        snapshot.reset(new Snapshot(snapshotName));
+    }
+    catch (const std::exception&) {
+    }
+    if (snapshot && snapshot->getKey() == key && snapshot->isUpToDate()) {
+        return readSnapshot_(*snapshot);
+    }
+    snapshot.reset();
+
+    if (!options_.isAll()) {
+        FileSystem::InputStream stream(filename);
+        return readStreaming(stream);
+    }
+
+    json j;
+    if (FileSystem::InputStream::getCompression(file.data(), file.size()) ==
+            FileSystem::InputStream::Compression::none) {
+        j = json::parse(file.data(), file.data() + file.size());
+    } else {
+        FileSystem::InputStream stream(filename);
+        stream >> j;
+    }
+    return readAndStore_(j, key, snapshotName, cacheFolder);
+}
+
+Data Parser::readSnapshot_(const Snapshot& snapshot) const {
+    const json& j = snapshot.getProject();
+
+    Data res;
+    if (options_.reads(LoadOptions::solverOptions)) {
+        res.solver = readSolver(j);
+    }
+    if (options_.reads(LoadOptions::materials)) {
+        res.physicalModels = readPhysicalModels(j);
+    } else {
+        res.physicalModels = new PhysicalModel::Group<>();
+    }
+    res.mesh = snapshot.getMesh(*res.physicalModels, options_);
+    readMeshDependents(res, j, options_);
+
+    postReadOperations(res);
+
+    return res;
+}
+
+Data Parser::readAndStore_(json& j,
+                           const std::uint64_t key,
+                           const std::string& snapshotName,
+                           const std::string& cacheFolder) const {
+
+    std::string version = j.at("_version").get<std::string>();
+    if (!checkVersionCompatibility(version)) {
+        throw std::logic_error(
+                "File version " + version + " is not supported.");
+    }
+
+    Data res;
+    res.solver = readSolver(j);
+    res.physicalModels = readPhysicalModels(j);
+    res.mesh = readGeometricMesh(*res.physicalModels, j);
+
+    // The mesh is stored before sources and output requests add their
+    // elements to it, as those are added again when it is restored.
+    j.erase("layers");
+    j.erase("coordinates");
+    j.erase("elements");
+    try {
+        FileSystem::Project(cacheFolder).makeDir();
+        Snapshot::write(snapshotName, key, Snapshot::findDependencies(j), j,
+                res.mesh == nullptr ? nullptr :
+                    res.mesh->castTo<Geometry::Mesh::Unstructured>());
+    }
+    catch (const std::exception&) {
+    }
+
+    readMeshDependents(res, j, options_);
+
+    postReadOperations(res);
+
+    return res;
+}
+
+void Parser::readMeshDependents(Data& res, const json& j,
+                                const LoadOptions& options) {
+    if (res.mesh != nullptr) {
+        Geometry::Mesh::Geometric& mesh =
+                *res.mesh->castTo<Geometry::Mesh::Geometric>();
+        if (options.reads(LoadOptions::connectorOnPoint)) {
+            readConnectorOnPoint(*res.physicalModels, mesh, j);
+        }
+        if (options.reads(LoadOptions::sources)) {
+            res.sources = readSources(mesh, j);
+        } else {
+            res.sources = new Source::Group<>();
+        }
+        if (options.reads(LoadOptions::outputRequests)) {
+            res.outputRequests = readOutputRequests(mesh, j);
+        } else {
+            res.outputRequests = new OutputRequest::Group<>();
+        }
+    } else {
+        res.sources = new Source::Group<>();
+        res.outputRequests = new OutputRequest::Group<>();
+    }
+}
+
 Solver::Info* Parser::readSolver(const json& j) {
     if (j.find("solverOptions") == j.end()) {
         return nullptr;
@@ -471,16 +931,21 @@ Geometry::Coordinate::Group<Geometry::CoordR3> Parser::readCoordinates(
         throw std::logic_error("Coordinates label was not found.");
     }
 
-    Geometry::Coordinate::Group<Geometry::CoordR3> res;
-    const json& c = j.at("coordinates").get<json>();
-    for (json::const_iterator it = c.begin(); it != c.end(); ++it) {
-        Geometry::CoordId id;
-        Math::CVecR3 pos;
-        std::stringstream ss(it->get<std::string>());
-        ss >> id >> pos(0) >> pos(1) >> pos(2);
-        res.add(new Geometry::CoordR3(id, pos));
+    return readCoordinates(
+            CoordinateRecords(j.at("coordinates").get<json>()));
+}
+
+Geometry::Coordinate::Group<Geometry::CoordR3> Parser::readCoordinates(
+        const CoordinateRecords& records) {
+    std::vector<Geometry::CoordR3*> coords(records.size());
+    for (std::size_t i = 0; i < records.size(); i++) {
+        coords[i] = new Geometry::CoordR3(
+                Geometry::CoordId(records.ids[i]),
+                Math::CVecR3(records.pos[3*i],
+                             records.pos[3*i+1],
+                             records.pos[3*i+2]));
     }
-    return res;
+    return Geometry::Coordinate::Group<Geometry::CoordR3>(coords);
 }
 
 Geometry::Element::Group<Geometry::ElemR> Parser::readElements(
@@ -606,12 +1071,11 @@ Geometry::Grid3 Parser::readGrids(const json& j) {
         /** Reads grid lines positions from a json file. Positions must be 
         * labeled with: xs, ys, and zs. */
         FileSystem::Project file(g.at("filename").get<std::string>());
-        std::ifstream fileStream(file);
+        FileSystem::InputStream fileStream(file);
         std::stringstream ss;
         ss << "{";
         if (fileStream) {
             ss << fileStream.rdbuf();
-            fileStream.close();
         }
         ss << "}";
         json jsonGridPos;
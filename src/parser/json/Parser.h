@@ -28,6 +28,7 @@
 #include <iostream>
 #include <string>
 #include <algorithm>
+#include <exception>
 
 #include "geometry/mesh/Geometric.h"
 #include "physicalModel/bound/PEC.h"
@@ -51,7 +52,10 @@
 #include "util/ProgressBar.h"
 
 #include "parser/Parser.h"
+#include "parser/LoadOptions.h"
 #include "json.hpp"
+#include "Records.h"
+#include "Sax.h"
 
 
 namespace SEMBA {
@@ -60,11 +64,46 @@ namespace JSON {
 
 using json = nlohmann::json;
 
+class Snapshot;
+
 class Parser : public SEMBA::Parser::Parser {
 public:
+    Parser(const LoadOptions& options = LoadOptions());
+
+    // Projects read with options other than the default ones are streamed
+    // as in readStreaming, so that skipped sections are only scanned.
     Data read(std::istream& inputFileStream) const;
+    // Same result as read, but coordinates and elements are parsed while
+    // the stream is tokenized instead of being stored in a DOM first. Only
+    // the remaining, small, sections are kept as json.
+    Data readStreaming(std::istream& inputFileStream) const;
+    // Same result as read. Each parsed project is kept in cacheFolder as a
+    // binary Snapshot named after the hash of the project file, which is
+    // restored instead of parsing the file while neither the file nor the
+    // files it refers to change. A cache which can not be written only
+    // makes later reads slower. Snapshots are only written by reads with
+    // the default options, but any options can restore them. Compressed
+    // files are hashed as stored and decompressed when parsed.
+    Data readCached(const std::string& filename,
+                    const std::string& cacheFolder) const;
 
 private:
+    class StreamHandler;
+
+    LoadOptions options_;
+
+    // Each way of reading returns its own result, so that it is never
+    // copied along with its mesh.
+    Data readTree_(std::istream&) const;
+    Data readSnapshot_(const Snapshot&) const;
+    Data readAndStore_(json& project,
+                       const std::uint64_t key,
+                       const std::string& snapshotName,
+                       const std::string& cacheFolder) const;
+
+    static void readMeshDependents(Data& res, const json&,
+                                   const LoadOptions&);
+
     static Solver::Info* readSolver(const json&);
     static Solver::Settings readSolverSettings(const json&);
     static PhysicalModel::Group<>* readPhysicalModels(const json&);
@@ -86,6 +125,8 @@ private:
     static Geometry::Layer::Group<> readLayers(const json&);
     static Geometry::Coordinate::Group<Geometry::CoordR3> readCoordinates(
             const json&);
+    static Geometry::Coordinate::Group<Geometry::CoordR3> readCoordinates(
+            const CoordinateRecords&);
     static Geometry::Element::Group<Geometry::ElemR> readElements(
             const PhysicalModel::Group<>& physicalModels,
             const Geometry::Layer::Group<>&,
@@ -160,52 +201,84 @@ Geometry::Element::Group<T> readElemIdsAsGroupOf(
 }
 
 template<typename T>
-Geometry::Element::Group<Geometry::ElemR> readElemStrAs(
+T* newElem(
         const PhysicalModel::Group<>& mG,
         const Geometry::Layer::Group<>& lG,
         const Geometry::CoordR3Group& cG,
-        const json& e) {
-    Geometry::Element::Group<Geometry::ElemR> res;
-
-    for (json::const_iterator it = e.begin(); it != e.end(); ++it) {
-
-        Geometry::ElemId elemId;
-        MatId matId;
-        Geometry::Layer::Id layerId;
-        std::vector<Geometry::CoordId> vId;
-
-        std::stringstream ss(it->get<std::string>());
-        ss >> elemId >> matId >> layerId;
-        vId.resize(T::sizeOfCoordinates);
-        for (std::size_t j = 0; j < T::sizeOfCoordinates; j++) {
-            ss >> vId[j];
-        }
+        const std::size_t id,
+        const std::size_t mat,
+        const std::size_t layer,
+        const std::size_t* vertices) {
+    const Geometry::Layer::Layer* layerPtr;
+    const PhysicalModel::PhysicalModel* matPtr;
+    const Geometry::CoordR3* vPtr[T::sizeOfCoordinates];
+
+    if (mat != 0) {
+        matPtr = mG.getId(MatId(mat));
+    } else {
+        matPtr = nullptr;
+    }
+    if (layer != 0) {
+        layerPtr = lG.getId(Geometry::LayerId(layer));
+    } else {
+        layerPtr = nullptr;
+    }
+    for (std::size_t i = 0; i < T::sizeOfCoordinates; ++i) {
+        vPtr[i] = cG.getId(Geometry::CoordId(vertices[i]));
+    }
 
-        const Geometry::Layer::Layer* layerPtr;
-        const PhysicalModel::PhysicalModel* matPtr;
-        std::vector<const Geometry::CoordR3*> vPtr;
+    return new T(Geometry::ElemId(id), vPtr, layerPtr, matPtr);
+}
 
-        if (matId != MatId(0)) {
-            matPtr = mG.getId(matId);
-        } else {
-            matPtr = nullptr;
+// Creates the elements of the records concurrently. On failure the elements
+// already created are deleted and the error of the first failing record is
+// thrown, as in a serial loop.
+template<typename T>
+std::vector<Geometry::ElemR*> newElems(
+        const PhysicalModel::Group<>& mG,
+        const Geometry::Layer::Group<>& lG,
+        const Geometry::CoordR3Group& cG,
+        const ElementRecords& records) {
+    std::vector<Geometry::ElemR*> res(records.size(), nullptr);
+    const long long n = records.size();
+    long long firstError = n;
+    std::exception_ptr error;
+#pragma omp parallel for
+    for (long long i = 0; i < n; i++) {
+        try {
+            res[i] = newElem<T>(mG, lG, cG,
+                    records.ids[i], records.mats[i], records.layers[i],
+                    &records.vertices[i*T::sizeOfCoordinates]);
         }
-        if (layerId != Geometry::LayerId(0)) {
-            layerPtr = lG.getId(layerId);
-        } else {
-            layerPtr = nullptr;
+        catch (...) {
+#pragma omp critical
+            {
+                if (i < firstError) {
+                    firstError = i;
+                    error = std::current_exception();
+                }
+            }
         }
-        vPtr.resize(vId.size(), nullptr);
-        for (size_t i = 0; i < vId.size(); ++i) {
-            vPtr[i] = cG.getId(vId[i]);
+    }
+    if (error) {
+        for (std::size_t i = 0; i < res.size(); i++) {
+            delete res[i];
         }
-
-        res.add(new T(elemId, vPtr.data(), layerPtr, matPtr));
+        std::rethrow_exception(error);
     }
-
     return res;
 }
 
+template<typename T>
+Geometry::Element::Group<Geometry::ElemR> readElemStrAs(
+        const PhysicalModel::Group<>& mG,
+        const Geometry::Layer::Group<>& lG,
+        const Geometry::CoordR3Group& cG,
+        const json& e) {
+    return Geometry::Element::Group<Geometry::ElemR>(
+            newElems<T>(mG, lG, cG, ElementRecords(T::sizeOfCoordinates, e)));
+}
+
 } /* namespace JSON */
 } /* namespace Parser */
 } /* namespace SEMBA */
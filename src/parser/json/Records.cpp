@@ -0,0 +1,335 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#include "Records.h"
+
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+#include <type_traits>
+
+#include "parser/Scanner.h"
+
+namespace SEMBA {
+namespace Parser {
+namespace JSON {
+
+namespace {
+
+const std::size_t ChunkSize = 1 << 12;
+
+void throwRecordError(const std::string& kind,
+                      const std::string& record,
+                      const std::size_t index,
+                      const Scanner& scanner,
+                      const std::string& expected) {
+    const std::size_t column = scanner.pos() - scanner.begin();
+    throw std::logic_error(
+            kind + " record " + std::to_string(index) + " \"" + record +
+            "\": " + expected + " at column " + std::to_string(column + 1) +
+            ".");
+}
+
+// Copies an array of numbers concurrently. Values of the wrong kind throw
+// naming the first of them.
+template<typename T>
+void readNumbers(const std::string& name,
+                 const nlohmann::json& array,
+                 std::vector<T>& res) {
+    if (!array.is_array()) {
+        throw std::logic_error(name + " must be an array.");
+    }
+    const long long n = array.size();
+    res.resize(n);
+    bool wrong = false;
+#pragma omp parallel for
+    for (long long i = 0; i < n; i++) {
+        const nlohmann::json& value = array[i];
+        if (std::is_integral<T>::value ? value.is_number_unsigned() :
+                                         value.is_number()) {
+            res[i] = value.get<T>();
+        } else {
+#pragma omp atomic write
+            wrong = true;
+        }
+    }
+    if (wrong) {
+        for (long long i = 0; i < n; i++) {
+            if (std::is_integral<T>::value ? !array[i].is_number_unsigned() :
+                                             !array[i].is_number()) {
+                throw std::logic_error(name + " value " + std::to_string(i) +
+                        " " + array[i].dump() + " is not " +
+                        (std::is_integral<T>::value ?
+                                "an unsigned integer." : "a number."));
+            }
+        }
+    }
+}
+
+CoordinateRecords emptyLike(const CoordinateRecords&) {
+    return CoordinateRecords();
+}
+
+ElementRecords emptyLike(const ElementRecords& rhs) {
+    return ElementRecords(rhs.numVertices);
+}
+
+}
+
+// Parses the n records returned by get(i) into thread local buffers which
+// are then appended in order. Records after the first malformed one of a
+// chunk are skipped, so the first chunk with an error holds the first
+// malformed record of all.
+template<typename R, typename G>
+void parseInChunks(const std::size_t n, const G& get, R& res) {
+    const long long numChunks = (n + ChunkSize - 1) / ChunkSize;
+    std::vector<R> chunks(numChunks, emptyLike(res));
+    std::vector<std::exception_ptr> errors(numChunks);
+#pragma omp parallel for
+    for (long long c = 0; c < numChunks; c++) {
+        const std::size_t first = c * ChunkSize;
+        const std::size_t last = std::min(first + ChunkSize, n);
+        chunks[c].reserve(last - first);
+        try {
+            for (std::size_t i = first; i < last; i++) {
+                chunks[c].add_(get(i), res.size() + i);
+            }
+        }
+        catch (...) {
+            errors[c] = std::current_exception();
+        }
+    }
+    for (long long c = 0; c < numChunks; c++) {
+        if (errors[c]) {
+            std::rethrow_exception(errors[c]);
+        }
+    }
+    res.reserve(res.size() + n);
+    for (long long c = 0; c < numChunks; c++) {
+        res.append(chunks[c]);
+    }
+}
+
+CoordinateRecords::CoordinateRecords() {
+
+}
+
+CoordinateRecords::CoordinateRecords(const nlohmann::json& records) {
+    if (records.is_object()) {
+        readNumbers("Coordinate ids", records.at("ids"), ids);
+        readNumbers("Coordinate positions", records.at("positions"), pos);
+        checkSizes();
+        return;
+    }
+    if (!records.is_array()) {
+        throw std::logic_error("Coordinate records must be an array.");
+    }
+    parseInChunks(records.size(),
+            [&records](const std::size_t i) -> const std::string& {
+                return records[i].get_ref<const std::string&>();
+            }, *this);
+}
+
+void CoordinateRecords::clear() {
+    ids.clear();
+    pos.clear();
+}
+
+void CoordinateRecords::reserve(const std::size_t n) {
+    ids.reserve(n);
+    pos.reserve(3*n);
+}
+
+void CoordinateRecords::add(const std::string& record) {
+    add_(record, size());
+}
+
+void CoordinateRecords::add(const std::vector<std::string>& records) {
+    parseInChunks(records.size(),
+            [&records](const std::size_t i) -> const std::string& {
+                return records[i];
+            }, *this);
+}
+
+void CoordinateRecords::append(const CoordinateRecords& rhs) {
+    ids.insert(ids.end(), rhs.ids.begin(), rhs.ids.end());
+    pos.insert(pos.end(), rhs.pos.begin(), rhs.pos.end());
+}
+
+void CoordinateRecords::checkSizes() const {
+    if (pos.size() != 3*ids.size()) {
+        throw std::logic_error("Coordinates have " +
+                std::to_string(ids.size()) + " ids and " +
+                std::to_string(pos.size()) + " positions.");
+    }
+}
+
+void CoordinateRecords::add_(const std::string& record,
+                             const std::size_t index) {
+    std::size_t id;
+    Math::Real p[3];
+    read(record, index, id, p);
+    ids.push_back(id);
+    pos.insert(pos.end(), p, p + 3);
+}
+
+void CoordinateRecords::read(const std::string& record,
+                             const std::size_t index,
+                             std::size_t& id,
+                             Math::Real pos[3]) {
+    Scanner scanner(record);
+    if (!scanner.read(id)) {
+        throwRecordError("Coordinate", record, index, scanner,
+                         "expected an id");
+    }
+    for (std::size_t d = 0; d < 3; d++) {
+        if (!scanner.read(pos[d])) {
+            throwRecordError("Coordinate", record, index, scanner,
+                             "expected a real");
+        }
+    }
+    if (!scanner.atEnd()) {
+        throwRecordError("Coordinate", record, index, scanner,
+                         "unexpected characters");
+    }
+}
+
+ElementRecords::ElementRecords(const std::size_t numVertices)
+:   numVertices(numVertices) {
+
+}
+
+ElementRecords::ElementRecords(const std::size_t numVertices,
+                               const nlohmann::json& records)
+:   numVertices(numVertices) {
+    if (records.is_object()) {
+        readNumbers("Element ids", records.at("ids"), ids);
+        readNumbers("Element materials", records.at("materials"), mats);
+        readNumbers("Element layers", records.at("layers"), layers);
+        readNumbers("Element vertices", records.at("vertices"), vertices);
+        checkSizes();
+        return;
+    }
+    if (!records.is_array()) {
+        throw std::logic_error("Element records must be an array.");
+    }
+    parseInChunks(records.size(),
+            [&records](const std::size_t i) -> const std::string& {
+                return records[i].get_ref<const std::string&>();
+            }, *this);
+}
+
+void ElementRecords::clear() {
+    ids.clear();
+    mats.clear();
+    layers.clear();
+    vertices.clear();
+}
+
+void ElementRecords::reserve(const std::size_t n) {
+    ids.reserve(n);
+    mats.reserve(n);
+    layers.reserve(n);
+    vertices.reserve(n*numVertices);
+}
+
+void ElementRecords::add(const std::string& record) {
+    add_(record, size());
+}
+
+void ElementRecords::add(const std::vector<std::string>& records) {
+    parseInChunks(records.size(),
+            [&records](const std::size_t i) -> const std::string& {
+                return records[i];
+            }, *this);
+}
+
+void ElementRecords::append(const ElementRecords& rhs) {
+    ids.insert(ids.end(), rhs.ids.begin(), rhs.ids.end());
+    mats.insert(mats.end(), rhs.mats.begin(), rhs.mats.end());
+    layers.insert(layers.end(), rhs.layers.begin(), rhs.layers.end());
+    vertices.insert(vertices.end(),
+                    rhs.vertices.begin(), rhs.vertices.end());
+}
+
+void ElementRecords::filter(const LoadOptions& options) {
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < size(); i++) {
+        if (!options.keepsElement(mats[i], layers[i])) {
+            continue;
+        }
+        ids[kept] = ids[i];
+        mats[kept] = mats[i];
+        layers[kept] = layers[i];
+        std::copy(vertices.begin() + i*numVertices,
+                  vertices.begin() + (i+1)*numVertices,
+                  vertices.begin() + kept*numVertices);
+        kept++;
+    }
+    ids.resize(kept);
+    mats.resize(kept);
+    layers.resize(kept);
+    vertices.resize(kept*numVertices);
+}
+
+void ElementRecords::checkSizes() const {
+    if (mats.size() != ids.size() || layers.size() != ids.size() ||
+        vertices.size() != numVertices*ids.size()) {
+        throw std::logic_error("Elements have " +
+                std::to_string(ids.size()) + " ids, " +
+                std::to_string(mats.size()) + " materials, " +
+                std::to_string(layers.size()) + " layers and " +
+                std::to_string(vertices.size()) + " vertices.");
+    }
+}
+
+void ElementRecords::add_(const std::string& record,
+                          const std::size_t index) {
+    buffer_.resize(3 + numVertices);
+    read(record, index, numVertices, buffer_.data());
+    ids.push_back(buffer_[0]);
+    mats.push_back(buffer_[1]);
+    layers.push_back(buffer_[2]);
+    vertices.insert(vertices.end(), buffer_.begin() + 3, buffer_.end());
+}
+
+void ElementRecords::read(const std::string& record,
+                          const std::size_t index,
+                          const std::size_t numVertices,
+                          std::size_t* values) {
+    static const char* names[3] = {"an id", "a material id", "a layer id"};
+    Scanner scanner(record);
+    for (std::size_t i = 0; i < 3 + numVertices; i++) {
+        if (!scanner.read(values[i])) {
+            throwRecordError("Element", record, index, scanner,
+                    std::string("expected ") +
+                    (i < 3 ? names[i] : "a coordinate id"));
+        }
+    }
+    if (!scanner.atEnd()) {
+        throwRecordError("Element", record, index, scanner,
+                         "unexpected characters");
+    }
+}
+
+} /* namespace JSON */
+} /* namespace Parser */
+} /* namespace SEMBA */
@@ -0,0 +1,120 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SEMBA_PARSER_JSON_RECORDS_H_
+#define SEMBA_PARSER_JSON_RECORDS_H_
+
+#include <string>
+#include <vector>
+
+#include "math/Types.h"
+#include "parser/LoadOptions.h"
+
+#include "json.hpp"
+
+namespace SEMBA {
+namespace Parser {
+namespace JSON {
+
+// Flat contents of the coordinate records of a project, "id x y z" strings.
+// Malformed records throw std::logic_error quoting the record, its index in
+// the array and the column of the offending token. Arrays of records are
+// parsed concurrently in chunks; the error reported is always the one of
+// the first malformed record, as in a serial parse.
+//
+// Projects can also give the records as an object of parallel arrays of
+// numbers, {"ids": [...], "positions": [x1, y1, z1, x2, ...]}, which are
+// copied without any string parsing.
+class CoordinateRecords {
+    template<typename R, typename G>
+    friend void parseInChunks(const std::size_t, const G&, R&);
+public:
+    std::vector<std::size_t> ids;
+    std::vector<Math::Real>  pos;
+
+    CoordinateRecords();
+    CoordinateRecords(const nlohmann::json& records);
+
+    std::size_t size() const { return ids.size(); }
+
+    void clear();
+    void reserve(const std::size_t n);
+    void add(const std::string& record);
+    void add(const std::vector<std::string>& records);
+    void append(const CoordinateRecords& rhs);
+    // Throws std::logic_error if the sizes of the arrays do not match.
+    void checkSizes() const;
+
+    static void read(const std::string& record,
+                     const std::size_t index,
+                     std::size_t& id,
+                     Math::Real pos[3]);
+
+private:
+    void add_(const std::string& record, const std::size_t index);
+};
+
+// Flat contents of the element records of a type, "id mat layer v1 ... vn"
+// strings, with numVertices coordinate ids per record. As for coordinates,
+// the records can also be an object of arrays of numbers, with keys "ids",
+// "materials", "layers" and "vertices".
+class ElementRecords {
+    template<typename R, typename G>
+    friend void parseInChunks(const std::size_t, const G&, R&);
+public:
+    std::size_t numVertices;
+    std::vector<std::size_t> ids;
+    std::vector<std::size_t> mats;
+    std::vector<std::size_t> layers;
+    std::vector<std::size_t> vertices;
+
+    ElementRecords(const std::size_t numVertices);
+    ElementRecords(const std::size_t numVertices,
+                   const nlohmann::json& records);
+
+    std::size_t size() const { return ids.size(); }
+
+    void clear();
+    void reserve(const std::size_t n);
+    void add(const std::string& record);
+    void add(const std::vector<std::string>& records);
+    void append(const ElementRecords& rhs);
+    // Removes the records of the elements which options does not keep.
+    void filter(const LoadOptions& options);
+    void checkSizes() const;
+
+    // Stores the 3 + numVertices values of the record in values.
+    static void read(const std::string& record,
+                     const std::size_t index,
+                     const std::size_t numVertices,
+                     std::size_t* values);
+
+private:
+    std::vector<std::size_t> buffer_;
+
+    void add_(const std::string& record, const std::size_t index);
+};
+
+} /* namespace JSON */
+} /* namespace Parser */
+} /* namespace SEMBA */
+
+#endif /* SEMBA_PARSER_JSON_RECORDS_H_ */
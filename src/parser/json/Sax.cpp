@@ -0,0 +1,522 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#include "Sax.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <stdexcept>
+
+#include "parser/Scanner.h"
+
+namespace SEMBA {
+namespace Parser {
+namespace JSON {
+
+namespace {
+
+const std::size_t BufferSize = 1 << 16;
+
+void appendUTF8(std::string& str, const unsigned long code) {
+    if (code < 0x80) {
+        str.push_back(static_cast<char>(code));
+    } else if (code < 0x800) {
+        str.push_back(static_cast<char>(0xC0 | (code >> 6)));
+        str.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+    } else if (code < 0x10000) {
+        str.push_back(static_cast<char>(0xE0 | (code >> 12)));
+        str.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+        str.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+    } else {
+        str.push_back(static_cast<char>(0xF0 | (code >> 18)));
+        str.push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+        str.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+        str.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+    }
+}
+
+inline bool isDigit(const char c) {
+    return c >= '0' && c <= '9';
+}
+
+// -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+bool isNumber(const std::string& str) {
+    std::string::const_iterator it = str.begin();
+    if (it != str.end() && *it == '-') {
+        ++it;
+    }
+    if (it == str.end() || !isDigit(*it)) {
+        return false;
+    }
+    if (*it++ != '0') {
+        while (it != str.end() && isDigit(*it)) {
+            ++it;
+        }
+    }
+    if (it != str.end() && *it == '.') {
+        if (++it == str.end() || !isDigit(*it)) {
+            return false;
+        }
+        while (it != str.end() && isDigit(*it)) {
+            ++it;
+        }
+    }
+    if (it != str.end() && (*it == 'e' || *it == 'E')) {
+        if (++it != str.end() && (*it == '+' || *it == '-')) {
+            ++it;
+        }
+        if (it == str.end() || !isDigit(*it)) {
+            return false;
+        }
+        while (it != str.end() && isDigit(*it)) {
+            ++it;
+        }
+    }
+    return it == str.end();
+}
+
+}
+
+SaxDom::SaxDom() {
+    clear();
+}
+
+SaxDom::~SaxDom() {
+
+}
+
+void SaxDom::clear() {
+    root_ = nlohmann::json();
+    stack_.clear();
+    key_.clear();
+    done_ = false;
+}
+
+void SaxDom::null() {
+    add_(nlohmann::json());
+}
+
+void SaxDom::boolean(const bool value) {
+    add_(nlohmann::json(value));
+}
+
+void SaxDom::number(const std::string& value) {
+    add_(toNumber(value));
+}
+
+void SaxDom::string(const std::string& value) {
+    add_(nlohmann::json(value));
+}
+
+void SaxDom::key(const std::string& key) {
+    key_ = key;
+}
+
+void SaxDom::startObject() {
+    stack_.push_back(add_(nlohmann::json::object()));
+    done_ = false;
+}
+
+void SaxDom::endObject() {
+    stack_.pop_back();
+    done_ = stack_.empty();
+}
+
+void SaxDom::startArray() {
+    stack_.push_back(add_(nlohmann::json::array()));
+    done_ = false;
+}
+
+void SaxDom::endArray() {
+    stack_.pop_back();
+    done_ = stack_.empty();
+}
+
+nlohmann::json SaxDom::toNumber(const std::string& str) {
+    if (str.find_first_of(".eE") == std::string::npos) {
+        errno = 0;
+        if (str[0] == '-') {
+            const long long value = std::strtoll(str.c_str(), nullptr, 10);
+            if (errno != ERANGE) {
+                return nlohmann::json(
+                        static_cast<nlohmann::json::number_integer_t>(value));
+            }
+        } else {
+            const unsigned long long value =
+                    std::strtoull(str.c_str(), nullptr, 10);
+            if (errno != ERANGE) {
+                return nlohmann::json(
+                        static_cast<nlohmann::json::number_unsigned_t>(value));
+            }
+        }
+    }
+    // Scanner reads reals regardless of the global locale.
+    Math::Real value;
+    if (!Scanner(str).read(value)) {
+        throw std::logic_error("JSON number out of range: " + str);
+    }
+    return nlohmann::json(value);
+}
+
+// Only the last container of each level is kept in the stack, so pointers
+// are never invalidated by later insertions in a parent array.
+nlohmann::json* SaxDom::add_(nlohmann::json&& value) {
+    if (stack_.empty()) {
+        root_ = std::move(value);
+        done_ = true;
+        return &root_;
+    }
+    nlohmann::json& parent = *stack_.back();
+    if (parent.is_array()) {
+        parent.push_back(std::move(value));
+        return &parent.back();
+    }
+    nlohmann::json& res = parent[key_];
+    res = std::move(value);
+    return &res;
+}
+
+Sax::Sax(std::istream& stream)
+:   stream_(stream),
+    buffer_(BufferSize),
+    pos_(0),
+    size_(0),
+    line_(1) {
+
+}
+
+Sax::~Sax() {
+
+}
+
+void Sax::parse(SaxHandler& handler) {
+    std::vector<char> stack;
+    bool readKey = false;
+    skipSpaces_();
+    while (true) {
+        bool closed = false;
+        if (readKey) {
+            skipSpaces_();
+            if (peek_() != '"') {
+                error_("expected object key");
+            }
+            get_();
+            readString_();
+            handler.key(token_);
+            skipSpaces_();
+            if (get_() != ':') {
+                error_("expected ':' after object key");
+            }
+            skipSpaces_();
+            readKey = false;
+            if (handler.skipValue()) {
+                skipValue_();
+                closed = true;
+            }
+        }
+
+        if (!closed) {
+            switch (peek_()) {
+            case '{':
+                get_();
+                handler.startObject();
+                skipSpaces_();
+                if (peek_() == '}') {
+                    get_();
+                    handler.endObject();
+                    closed = true;
+                } else {
+                    stack.push_back('{');
+                    readKey = true;
+                }
+                break;
+            case '[':
+                get_();
+                handler.startArray();
+                skipSpaces_();
+                if (peek_() == ']') {
+                    get_();
+                    handler.endArray();
+                    closed = true;
+                } else {
+                    stack.push_back('[');
+                }
+                break;
+            case '"':
+                get_();
+                readString_();
+                handler.string(token_);
+                closed = true;
+                break;
+            case 't':
+                expect_("true");
+                handler.boolean(true);
+                closed = true;
+                break;
+            case 'f':
+                expect_("false");
+                handler.boolean(false);
+                closed = true;
+                break;
+            case 'n':
+                expect_("null");
+                handler.null();
+                closed = true;
+                break;
+            default:
+                readNumber_();
+                handler.number(token_);
+                closed = true;
+                break;
+            }
+        }
+        if (readKey) {
+            continue;
+        }
+
+        // After a complete value, closes every container that ends here.
+        while (closed) {
+            skipSpaces_();
+            if (stack.empty()) {
+                if (peek_() != -1) {
+                    error_("unexpected content after the document");
+                }
+                return;
+            }
+            const int c = get_();
+            if (c == ',') {
+                readKey = (stack.back() == '{');
+                closed = false;
+            } else if (c == '}' && stack.back() == '{') {
+                stack.pop_back();
+                handler.endObject();
+            } else if (c == ']' && stack.back() == '[') {
+                stack.pop_back();
+                handler.endArray();
+            } else {
+                error_("expected ',' or the end of the container");
+            }
+        }
+        skipSpaces_();
+    }
+}
+
+bool Sax::fill_() {
+    if (pos_ < size_) {
+        return true;
+    }
+    stream_.read(buffer_.data(), buffer_.size());
+    size_ = stream_.gcount();
+    pos_ = 0;
+    return size_ > 0;
+}
+
+int Sax::peek_() {
+    if (!fill_()) {
+        return -1;
+    }
+    return static_cast<unsigned char>(buffer_[pos_]);
+}
+
+int Sax::get_() {
+    if (!fill_()) {
+        return -1;
+    }
+    const char c = buffer_[pos_++];
+    if (c == '\n') {
+        line_++;
+    }
+    return static_cast<unsigned char>(c);
+}
+
+void Sax::skipSpaces_() {
+    while (true) {
+        const int c = peek_();
+        if (c != ' ' && c != '\t' && c != '\n' && c != '\r') {
+            return;
+        }
+        get_();
+    }
+}
+
+void Sax::expect_(const char* literal) {
+    for (const char* c = literal; *c != '\0'; c++) {
+        if (get_() != *c) {
+            error_(std::string("expected ") + literal);
+        }
+    }
+}
+
+void Sax::readString_() {
+    token_.clear();
+    while (true) {
+        if (!fill_()) {
+            error_("unterminated string");
+        }
+        // Copies the run of plain characters at once.
+        std::size_t end = pos_;
+        while (end < size_ && buffer_[end] != '"' &&
+               buffer_[end] != '\\' &&
+               static_cast<unsigned char>(buffer_[end]) >= 0x20) {
+            end++;
+        }
+        token_.append(&buffer_[pos_], end - pos_);
+        pos_ = end;
+        if (pos_ == size_) {
+            continue;
+        }
+        const int c = get_();
+        if (c == '"') {
+            return;
+        } else if (c == '\\') {
+            const int e = get_();
+            switch (e) {
+            case '"':  token_.push_back('"');  break;
+            case '\\': token_.push_back('\\'); break;
+            case '/':  token_.push_back('/');  break;
+            case 'b':  token_.push_back('\b'); break;
+            case 'f':  token_.push_back('\f'); break;
+            case 'n':  token_.push_back('\n'); break;
+            case 'r':  token_.push_back('\r'); break;
+            case 't':  token_.push_back('\t'); break;
+            case 'u': {
+                unsigned long code = 0;
+                for (std::size_t n = 0; n < 2; n++) {
+                    unsigned long unit = 0;
+                    for (std::size_t i = 0; i < 4; i++) {
+                        const int h = get_();
+                        unit <<= 4;
+                        if (h >= '0' && h <= '9') {
+                            unit += h - '0';
+                        } else if (h >= 'a' && h <= 'f') {
+                            unit += h - 'a' + 10;
+                        } else if (h >= 'A' && h <= 'F') {
+                            unit += h - 'A' + 10;
+                        } else {
+                            error_("invalid unicode escape");
+                        }
+                    }
+                    if (n == 0) {
+                        code = unit;
+                        if (code < 0xD800 || code > 0xDBFF) {
+                            break;
+                        }
+                        if (get_() != '\\' || get_() != 'u') {
+                            error_("expected low surrogate");
+                        }
+                    } else {
+                        if (unit < 0xDC00 || unit > 0xDFFF) {
+                            error_("invalid low surrogate");
+                        }
+                        code = 0x10000 +
+                               ((code - 0xD800) << 10) + (unit - 0xDC00);
+                    }
+                }
+                appendUTF8(token_, code);
+                break;
+            }
+            default:
+                error_("invalid escape in string");
+            }
+        } else {
+            error_("control character in string");
+        }
+    }
+}
+
+void Sax::readNumber_() {
+    token_.clear();
+    while (true) {
+        const int c = peek_();
+        if ((c >= '0' && c <= '9') ||
+            c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E') {
+            token_.push_back(static_cast<char>(get_()));
+        } else {
+            break;
+        }
+    }
+    if (token_.empty() || !(token_[0] == '-' || isDigit(token_[0]))) {
+        error_("unexpected character");
+    }
+    if (!isNumber(token_)) {
+        error_("invalid number");
+    }
+}
+
+// Brackets are counted regardless of their kind, so mismatched brackets
+// inside a skipped value are not noticed.
+void Sax::skipValue_() {
+    const int first = peek_();
+    if (first == '"') {
+        get_();
+        skipString_();
+        return;
+    } else if (first == 't') {
+        expect_("true");
+        return;
+    } else if (first == 'f') {
+        expect_("false");
+        return;
+    } else if (first == 'n') {
+        expect_("null");
+        return;
+    } else if (first != '{' && first != '[') {
+        readNumber_();
+        return;
+    }
+    std::size_t depth = 0;
+    while (true) {
+        const int c = get_();
+        if (c == '"') {
+            skipString_();
+        } else if (c == '{' || c == '[') {
+            depth++;
+        } else if (c == '}' || c == ']') {
+            if (--depth == 0) {
+                return;
+            }
+        } else if (c == -1) {
+            error_("unterminated container");
+        }
+    }
+}
+
+void Sax::skipString_() {
+    while (true) {
+        const int c = get_();
+        if (c == '"') {
+            return;
+        } else if (c == '\\') {
+            get_();
+        } else if (c == -1) {
+            error_("unterminated string");
+        }
+    }
+}
+
+void Sax::error_(const std::string& msg) const {
+    throw std::logic_error(
+            "JSON parse error at line " + std::to_string(line_) + ": " + msg);
+}
+
+} /* namespace JSON */
+} /* namespace Parser */
+} /* namespace SEMBA */
@@ -0,0 +1,122 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SEMBA_PARSER_JSON_SAX_H_
+#define SEMBA_PARSER_JSON_SAX_H_
+
+#include <istream>
+#include <string>
+#include <vector>
+
+#include "json.hpp"
+
+namespace SEMBA {
+namespace Parser {
+namespace JSON {
+
+// Receives the events of a Sax parse in document order. Numbers are passed
+// with their text so that each handler decides how to convert them.
+class SaxHandler {
+public:
+    virtual ~SaxHandler() {}
+
+    virtual void null() = 0;
+    virtual void boolean(const bool) = 0;
+    virtual void number(const std::string&) = 0;
+    virtual void string(const std::string&) = 0;
+    virtual void key(const std::string&) = 0;
+    virtual void startObject() = 0;
+    virtual void endObject() = 0;
+    virtual void startArray() = 0;
+    virtual void endArray() = 0;
+
+    // Queried after each key. When true the value of the key is skipped,
+    // scanning it only for the end of its strings and brackets, and no
+    // events are reported for it.
+    virtual bool skipValue() const { return false; }
+};
+
+// Builds a nlohmann::json value from the events it receives.
+class SaxDom : public SaxHandler {
+public:
+    SaxDom();
+    virtual ~SaxDom();
+
+    void clear();
+    bool isDone() const { return done_; }
+    nlohmann::json& get() { return root_; }
+
+    void null();
+    void boolean(const bool);
+    void number(const std::string&);
+    void string(const std::string&);
+    void key(const std::string&);
+    void startObject();
+    void endObject();
+    void startArray();
+    void endArray();
+
+    static nlohmann::json toNumber(const std::string&);
+
+private:
+    nlohmann::json root_;
+    std::vector<nlohmann::json*> stack_;
+    std::string key_;
+    bool done_;
+
+    nlohmann::json* add_(nlohmann::json&& value);
+};
+
+// Streaming JSON tokenizer. The stream is read in blocks and every token is
+// reported as soon as it is complete, so memory does not grow with the size
+// of the document. Malformed input throws std::logic_error with the line of
+// the offending token.
+class Sax {
+public:
+    Sax(std::istream& stream);
+    virtual ~Sax();
+
+    void parse(SaxHandler& handler);
+
+private:
+    std::istream& stream_;
+    std::vector<char> buffer_;
+    std::size_t pos_, size_;
+    std::size_t line_;
+    std::string token_;
+
+    bool fill_();
+    int  peek_();
+    int  get_();
+    void skipSpaces_();
+    void expect_(const char* literal);
+    void readString_();
+    void readNumber_();
+    void skipValue_();
+    void skipString_();
+    void error_(const std::string& msg) const;
+};
+
+} /* namespace JSON */
+} /* namespace Parser */
+} /* namespace SEMBA */
+
+#endif /* SEMBA_PARSER_JSON_SAX_H_ */
@@ -0,0 +1,246 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#include "Snapshot.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include "filesystem/Hash.h"
+#include "parser/binary/MeshReader.h"
+#include "parser/binary/MeshWriter.h"
+
+namespace SEMBA {
+namespace Parser {
+namespace JSON {
+
+namespace {
+
+enum Flag {
+    hasMeshFlag = 1
+};
+
+const char          Magic[8] = {'S','M','B','S','N','A','P',0};
+const std::uint32_t Version  = 1;
+
+struct Section {
+    std::uint64_t offset;
+    std::uint64_t bytes;
+};
+
+struct Header {
+    char          magic[8];
+    std::uint32_t version;
+    std::uint32_t flags;
+    std::uint64_t key;
+    Section       meta;
+    Section       mesh;
+};
+
+// Files which can not be read are given a hash of zero, so that creating
+// them later is also noticed.
+std::uint64_t hashDependency(const std::string& filename) {
+    try {
+        return FileSystem::hashFile(filename);
+    }
+    catch (const std::exception&) {
+        return 0;
+    }
+}
+
+void addReferencedFiles(std::vector<std::string>& res,
+                        const nlohmann::json& j) {
+    if (j.is_object()) {
+        for (nlohmann::json::const_iterator it = j.begin();
+             it != j.end(); ++it) {
+            if (it.value().is_string() &&
+                (it.key() == "filename" ||
+                 it.key() == "transferFunctionFile")) {
+                res.push_back(it.value().get<std::string>());
+            } else {
+                addReferencedFiles(res, it.value());
+            }
+        }
+    } else if (j.is_array()) {
+        for (nlohmann::json::const_iterator it = j.begin();
+             it != j.end(); ++it) {
+            addReferencedFiles(res, *it);
+        }
+    }
+}
+
+}
+
+Snapshot::Snapshot(const std::string& filename)
+:   file_(filename) {
+    if (file_.size() < sizeof(Header)) {
+        throw std::logic_error("File is not a project snapshot.");
+    }
+    const Header& header = *reinterpret_cast<const Header*>(file_.data());
+    if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0 ||
+        header.version != Version) {
+        throw std::logic_error("File is not a supported project snapshot.");
+    }
+    const Section* sections[2] = {&header.meta, &header.mesh};
+    for (std::size_t s = 0; s < 2; s++) {
+        if (sections[s]->offset > file_.size() ||
+            sections[s]->bytes > file_.size() - sections[s]->offset) {
+            throw std::logic_error("Project snapshot is truncated.");
+        }
+    }
+    if (header.mesh.offset % Binary::MeshAlignment != 0) {
+        throw std::logic_error("Project snapshot mesh is not aligned.");
+    }
+    key_ = header.key;
+
+    const char* meta = file_.data() + header.meta.offset;
+    nlohmann::json j;
+    try {
+        j = nlohmann::json::from_cbor(
+                std::vector<std::uint8_t>(meta, meta + header.meta.bytes));
+    }
+    catch (const std::exception& e) {
+        throw std::logic_error(
+                std::string("Project snapshot is corrupt: ") + e.what());
+    }
+    const nlohmann::json& deps = j.at("dependencies");
+    for (nlohmann::json::const_iterator it = deps.begin();
+         it != deps.end(); ++it) {
+        Dependency dep;
+        dep.filename = it->at(0).get<std::string>();
+        dep.hash = it->at(1).get<std::uint64_t>();
+        dependencies_.push_back(dep);
+    }
+    project_ = j.at("project");
+}
+
+bool Snapshot::isUpToDate() const {
+    for (std::size_t i = 0; i < dependencies_.size(); i++) {
+        if (hashDependency(dependencies_[i].filename) !=
+                dependencies_[i].hash) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Snapshot::hasMesh() const {
+    const Header& header = *reinterpret_cast<const Header*>(file_.data());
+    return (header.flags & hasMeshFlag) != 0;
+}
+
+Geometry::Mesh::Unstructured* Snapshot::getMesh(
+        const PhysicalModel::Group<>& mG,
+        const LoadOptions& options) const {
+    if (!hasMesh() || !options.readsMesh()) {
+        return nullptr;
+    }
+    const Header& header = *reinterpret_cast<const Header*>(file_.data());
+    return Binary::MeshReader(file_.data() + header.mesh.offset,
+                              header.mesh.bytes).read(mG, options);
+}
+
+void Snapshot::write(const std::string& filename,
+                     const std::uint64_t key,
+                     const std::vector<Dependency>& dependencies,
+                     const nlohmann::json& project,
+                     const Geometry::Mesh::Unstructured* mesh) {
+    nlohmann::json meta;
+    meta["dependencies"] = nlohmann::json::array();
+    for (std::size_t i = 0; i < dependencies.size(); i++) {
+        meta["dependencies"].push_back(nlohmann::json::array(
+                {dependencies[i].filename, dependencies[i].hash}));
+    }
+    meta["project"] = project;
+    const std::vector<std::uint8_t> cbor = nlohmann::json::to_cbor(meta);
+
+    Header header;
+    std::memset(&header, 0, sizeof(Header));
+    std::memcpy(header.magic, Magic, sizeof(Magic));
+    header.version = Version;
+    header.key = key;
+    header.meta.offset = sizeof(Header);
+    header.meta.bytes = cbor.size();
+
+    const std::string tmpName = filename + ".tmp";
+    {
+        std::ofstream file(tmpName.c_str(),
+                           std::ios::out | std::ios::binary);
+        if (!file.is_open()) {
+            throw std::logic_error("Can not open file: " + tmpName);
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+        file.write(reinterpret_cast<const char*>(cbor.data()), cbor.size());
+        if (mesh != nullptr) {
+            const std::size_t end = sizeof(Header) + cbor.size();
+            const std::size_t padding =
+                    (Binary::MeshAlignment - end % Binary::MeshAlignment) %
+                    Binary::MeshAlignment;
+            file.write(std::string(padding, '\0').data(), padding);
+            header.flags |= hasMeshFlag;
+            header.mesh.offset = end + padding;
+            try {
+                Binary::MeshWriter::write(*mesh, file);
+            }
+            catch (...) {
+                file.close();
+                std::remove(tmpName.c_str());
+                throw;
+            }
+            header.mesh.bytes =
+                    static_cast<std::uint64_t>(file.tellp()) -
+                    header.mesh.offset;
+            file.seekp(0);
+            file.write(reinterpret_cast<const char*>(&header),
+                       sizeof(Header));
+        }
+        if (!file) {
+            file.close();
+            std::remove(tmpName.c_str());
+            throw std::logic_error("Error writing file: " + tmpName);
+        }
+    }
+#ifdef _WIN32
+    std::remove(filename.c_str());
+#endif
+    if (std::rename(tmpName.c_str(), filename.c_str()) != 0) {
+        std::remove(tmpName.c_str());
+        throw std::logic_error("Can not write file: " + filename);
+    }
+}
+
+std::vector<Snapshot::Dependency> Snapshot::findDependencies(
+        const nlohmann::json& project) {
+    std::vector<std::string> filenames;
+    addReferencedFiles(filenames, project);
+    std::vector<Dependency> res(filenames.size());
+    for (std::size_t i = 0; i < filenames.size(); i++) {
+        res[i].filename = filenames[i];
+        res[i].hash = hashDependency(filenames[i]);
+    }
+    return res;
+}
+
+} /* namespace JSON */
+} /* namespace Parser */
+} /* namespace SEMBA */
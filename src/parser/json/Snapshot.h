@@ -0,0 +1,97 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SEMBA_PARSER_JSON_SNAPSHOT_H_
+#define SEMBA_PARSER_JSON_SNAPSHOT_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "filesystem/MappedFile.h"
+#include "geometry/mesh/Unstructured.h"
+#include "parser/LoadOptions.h"
+#include "physicalModel/Group.h"
+
+#include "json.hpp"
+
+namespace SEMBA {
+namespace Parser {
+namespace JSON {
+
+// Binary image of a parsed project. It holds the key of the project file,
+// the files the project refers to with the hash of their contents, the
+// sections of the project which are not part of the mesh, stored as CBOR,
+// and the mesh as built from the project, with the layout of
+// Binary::MeshFormat. The file is mapped and the mesh built from it
+// without parsing text.
+class Snapshot {
+public:
+    struct Dependency {
+        std::string   filename;
+        std::uint64_t hash;
+    };
+
+    // Throws std::logic_error if the file is not a valid snapshot.
+    Snapshot(const std::string& filename);
+
+    std::uint64_t getKey() const { return key_; }
+    const std::vector<Dependency>& getDependencies() const {
+        return dependencies_;
+    }
+    const nlohmann::json& getProject() const { return project_; }
+
+    // True if every dependency still has the contents it was stored with.
+    bool isUpToDate() const;
+
+    bool hasMesh() const;
+    // Returns nullptr for snapshots without mesh or when options skips
+    // every mesh section. The mesh is a Geometry::Mesh::Geometric if it was
+    // stored with a grid.
+    Geometry::Mesh::Unstructured* getMesh(
+            const PhysicalModel::Group<>& mG,
+            const LoadOptions& options = LoadOptions()) const;
+
+    // The file is written under a temporary name and renamed once
+    // complete, so readers never see a partial snapshot.
+    static void write(const std::string& filename,
+                      const std::uint64_t key,
+                      const std::vector<Dependency>& dependencies,
+                      const nlohmann::json& project,
+                      const Geometry::Mesh::Unstructured* mesh);
+
+    // Files named in the project, such as material, grid and excitation
+    // files, with the hash of their current contents.
+    static std::vector<Dependency> findDependencies(
+            const nlohmann::json& project);
+
+private:
+    FileSystem::MappedFile file_;
+    std::uint64_t key_;
+    std::vector<Dependency> dependencies_;
+    nlohmann::json project_;
+};
+
+} /* namespace JSON */
+} /* namespace Parser */
+} /* namespace SEMBA */
+
+#endif /* SEMBA_PARSER_JSON_SNAPSHOT_H_ */
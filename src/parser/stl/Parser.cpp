@@ -21,94 +21,414 @@
 
 #include "Parser.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "filesystem/InputStream.h"
+#include "filesystem/MappedFile.h"
+#include "math/util/Real.h"
+#include "parser/Scanner.h"
+
 namespace SEMBA {
 namespace Parser {
 namespace STL {
 
-Parser::Parser() {
+namespace {
+
+const std::size_t ChunkSize = 1 << 20;
+// Text read from a stream at once, split in chunks as a mapped file.
+const std::size_t BatchSize = 4*ChunkSize;
+
+// Facets read from a chunk of the file.
+struct Chunk {
+    // Vertex positions, nine per facet.
+    std::vector<Math::Real> pos;
+    // Names of the solids started in the chunk, after the given number of
+    // facets of the chunk.
+    std::vector<std::pair<std::size_t, std::string>> solids;
+    // Largest absolute value of the positions.
+    Math::Real size;
+
+    Chunk() : size(0.0) {}
+};
+
+// Vertex position rounded to a multiple of the welding tolerance.
+struct QuantizedPos {
+    long long v[3];
+
+    bool operator==(const QuantizedPos& rhs) const {
+        return v[0] == rhs.v[0] && v[1] == rhs.v[1] && v[2] == rhs.v[2];
+    }
+};
+
+struct QuantizedPosHash {
+    std::size_t operator()(const QuantizedPos& p) const {
+        std::uint64_t h = 0xcbf29ce484222325ULL;
+        for (std::size_t d = 0; d < 3; d++) {
+            h = (h ^ static_cast<std::uint64_t>(p.v[d])) *
+                0x100000001b3ULL;
+            h ^= h >> 29;
+        }
+        return static_cast<std::size_t>(h);
+    }
+};
+
+typedef std::unordered_map<QuantizedPos, std::size_t, QuantizedPosHash>
+        WeldIndex;
+
+// Returns the coordinate of the vertex at p, whose quantized position is
+// key. It is the one indexed at key or, failing that, the lowest of those
+// indexed at the neighbouring keys which lie within quantum of p along
+// every axis, so that positions rounding to different multiples are still
+// welded. Returns the number of coordinates when none matches.
+std::size_t findWeld(const WeldIndex& index,
+                     const std::vector<std::size_t>& firstVertices,
+                     const std::vector<Math::Real>& pos,
+                     const QuantizedPos& key,
+                     const Math::Real* p,
+                     const Math::Real quantum) {
+    WeldIndex::const_iterator it = index.find(key);
+    if (it != index.end()) {
+        return it->second;
+    }
+    std::size_t res = firstVertices.size();
+    for (long long n = 0; n < 27; n++) {
+        QuantizedPos neighbour = key;
+        neighbour.v[0] += n % 3 - 1;
+        neighbour.v[1] += (n / 3) % 3 - 1;
+        neighbour.v[2] += n / 9 - 1;
+        it = index.find(neighbour);
+        if (it == index.end() || it->second >= res) {
+            continue;
+        }
+        const Math::Real* q = &pos[3*firstVertices[it->second]];
+        if (std::abs(p[0] - q[0]) <= quantum &&
+            std::abs(p[1] - q[1]) <= quantum &&
+            std::abs(p[2] - q[2]) <= quantum) {
+            res = it->second;
+        }
+    }
+    return res;
 }
 
-Parser::Parser(const std::string& fn)
-:   Project(fn) {
+inline bool isBlank(const char c) {
+    return c == ' ' || c == '\t' || c == '\n' ||
+           c == '\r' || c == '\v' || c == '\f';
 }
 
-Parser::~Parser() {
+inline bool isLineBlank(const char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+inline const char* skipBlanks(const char* pos, const char* end) {
+    while (pos != end && isBlank(*pos)) {
+        ++pos;
+    }
+    return pos;
+}
 
+inline const char* skipLineBlanks(const char* pos, const char* end) {
+    while (pos != end && isLineBlank(*pos)) {
+        ++pos;
+    }
+    return pos;
 }
 
-Data Parser::read(std::istream& stl) const {
-    // Reads coordinates.
-    std::string label;
-    std::vector<Math::CVecR3> vertices;
-    std::size_t nLines = std::count(std::istreambuf_iterator<char>(stl),
-                                    std::istreambuf_iterator<char>(), '\n');
-    vertices.reserve(nLines);
-	
-    stl.seekg(0); // Rewinds.
-    while (stl.peek() != EOF) {
-        stl >> label;
-        if (label == "vertex") {
-            Math::CVecR3 vertex;
-            stl >> vertex(Math::Constants::x)
-                >> vertex(Math::Constants::y)
-                >> vertex(Math::Constants::z);
-            vertices.push_back(vertex);
+inline const char* skipWord(const char* pos, const char* end) {
+    while (pos != end && !isBlank(*pos)) {
+        ++pos;
+    }
+    return pos;
+}
+
+inline bool isWord(const char* begin, const char* end, const char* word) {
+    const std::size_t size = std::strlen(word);
+    return static_cast<std::size_t>(end - begin) == size &&
+           std::equal(begin, end, word);
+}
+
+// begin is at line firstLine.
+void throwError(const char* begin, const std::size_t firstLine,
+                const char* pos, const std::string& expected) {
+    const std::size_t line = std::count(begin, pos, '\n') + firstLine;
+    throw std::logic_error("STL: " + expected + " at line " +
+                           std::to_string(line) + ".");
+}
+
+// True if the line at pos starts with a facet or a solid keyword, which is
+// followed by more text before end.
+bool isFacetLine(const char* pos, const char* end) {
+    const char* word = skipLineBlanks(pos, end);
+    const char* wordEnd = skipWord(word, end);
+    return wordEnd != end &&
+           (isWord(word, wordEnd, "facet") ||
+            isWord(word, wordEnd, "solid") ||
+            isWord(word, wordEnd, "endsolid"));
+}
+
+// Moves pos to the beginning of the next line starting with a facet or a
+// solid, so that chunks hold whole facets.
+const char* alignToFacet(const char* pos, const char* end) {
+    while (pos != end) {
+        pos = std::find(pos, end, '\n');
+        if (pos == end) {
+            break;
+        }
+        ++pos;
+        if (isFacetLine(pos, end)) {
+            return pos;
+        }
+    }
+    return end;
+}
+
+// Beginning of the last line after begin starting with a facet or a solid,
+// begin if there is none.
+const char* alignToLastFacet(const char* begin, const char* end) {
+    const char* pos = end;
+    while (pos != begin) {
+        --pos;
+        if (*pos == '\n' && isFacetLine(pos + 1, end)) {
+            return pos + 1;
         }
     }
-    Geometry::Coordinate::Group<Geometry::CoordR3> cG;
-    cG.addPos(vertices);
-
-    // Reads Elements and Layers.
-	stl.clear();
-	stl.seekg(0); // Rewinds.
-	Geometry::Layer::Group<Geometry::Layer::Layer> lG;
-    Geometry::Element::Group<Geometry::ElemR> eG;
-    while (stl.peek() != EOF) {
-        stl >> label;
-        if (label == "solid") {
-            std::string layerName;
-            stl >> layerName;
-            Geometry::Layer::Layer* lay = 
-                lG.addId(new Geometry::Layer::Layer(layerName))(0);
-            std::string line;
-            while (stl.peek() != EOF) {
-                std::getline(stl, line);
-                if (trim(line) == "outer loop") {
-                    std::vector<const Geometry::CoordR3*> coord;
-                    coord.reserve(3);
-                    while (stl.peek() != EOF && label != "endloop") {
-                        stl >> label;
-                        if (label == "vertex") {
-                            Math::CVecR3 pos;
-                            stl >> pos(Math::Constants::x)
-                                >> pos(Math::Constants::y)
-                                >> pos(Math::Constants::z);
-                            coord.push_back(cG.getPos(pos));
-                        }
-                    }
-                    label.clear();
-                    eG.addId(new Geometry::Tri3(Geometry::ElemId(0),
-                                                &coord[0], lay));
+    return begin;
+}
+
+// Tokenizes the facets in [first, last). Keywords other than solid, vertex
+// and endloop are skipped. The name of a solid is the word following it in
+// its line, if any.
+void readChunk(const char* begin, const std::size_t firstLine,
+               const char* first, const char* last, Chunk& chunk) {
+    std::size_t vertices = 0;
+    const char* pos = skipBlanks(first, last);
+    while (pos != last) {
+        const char* wordEnd = skipWord(pos, last);
+        if (isWord(pos, wordEnd, "vertex")) {
+            Scanner scanner(wordEnd, last);
+            for (std::size_t d = 0; d < 3; d++) {
+                Math::Real value;
+                if (!scanner.read(value)) {
+                    throwError(begin, firstLine, scanner.pos(),
+                               "expected a vertex coordinate");
                 }
+                chunk.pos.push_back(value);
+                chunk.size = std::max(chunk.size, std::abs(value));
+            }
+            wordEnd = scanner.pos();
+            vertices++;
+        } else if (isWord(pos, wordEnd, "endloop")) {
+            if (vertices != 3) {
+                throwError(begin, firstLine, pos,
+                           "expected three vertices per facet");
             }
+            vertices = 0;
+        } else if (isWord(pos, wordEnd, "solid")) {
+            const char* name = skipLineBlanks(wordEnd, last);
+            wordEnd = skipWord(name, last);
+            chunk.solids.push_back(std::make_pair(
+                    chunk.pos.size() / 9, std::string(name, wordEnd)));
+        } else if (isWord(pos, wordEnd, "endsolid")) {
+            wordEnd = skipWord(skipLineBlanks(wordEnd, last), last);
         }
+        pos = skipBlanks(wordEnd, last);
     }
+    if (vertices != 0) {
+        throwError(begin, firstLine, last, "expected endloop");
+    }
+}
 
-    // Stores results and returns.
-    Data res;
-    res.mesh = new Geometry::Mesh::Geometric(Geometry::Grid3(), cG, eG, lG);
+// Tokenizes the ASCII STL in [begin, end), which starts at line firstLine,
+// into chunks of whole facets read concurrently and appended to chunks.
+void readChunks(const char* begin, const char* end,
+                const std::size_t firstLine, std::vector<Chunk>& chunks) {
+    const long long numChunks =
+            std::max<std::size_t>(1, (end - begin) / ChunkSize);
+    std::vector<const char*> bounds(numChunks + 1, end);
+    bounds[0] = begin;
+#pragma omp parallel for
+    for (long long c = 1; c < numChunks; c++) {
+        bounds[c] = alignToFacet(begin + c*ChunkSize, end);
+    }
+    for (long long c = 1; c < numChunks; c++) {
+        bounds[c] = std::max(bounds[c], bounds[c-1]);
+    }
+
+    const std::size_t offset = chunks.size();
+    chunks.resize(offset + numChunks);
+    std::vector<std::exception_ptr> errors(numChunks);
+#pragma omp parallel for schedule(dynamic)
+    for (long long c = 0; c < numChunks; c++) {
+        try {
+            readChunk(begin, firstLine, bounds[c], bounds[c+1],
+                      chunks[offset + c]);
+        }
+        catch (...) {
+            errors[c] = std::current_exception();
+        }
+    }
+    for (long long c = 0; c < numChunks; c++) {
+        if (errors[c]) {
+            std::rethrow_exception(errors[c]);
+        }
+    }
+}
+
+// Welds the vertices of the tokenized facets and then builds the triangles
+// concurrently.
+Data buildData(std::vector<Chunk>& chunks) {
+    const long long numChunks = chunks.size();
+
+    // Each solid is a layer of the facets which follow it.
+    std::vector<Geometry::Layer::Layer*> layers;
+    std::vector<const Geometry::Layer::Layer*> facetLayers;
+    std::vector<Math::Real> pos;
+    Math::Real size = 0.0;
+    for (long long c = 0; c < numChunks; c++) {
+        const std::size_t offset = facetLayers.size();
+        facetLayers.resize(offset + chunks[c].pos.size() / 9,
+                           layers.empty() ? nullptr : layers.back());
+        for (std::size_t s = 0; s < chunks[c].solids.size(); s++) {
+            layers.push_back(new Geometry::Layer::Layer(
+                    Geometry::LayerId(layers.size() + 1),
+                    chunks[c].solids[s].second));
+            std::fill(facetLayers.begin() + offset +
+                          chunks[c].solids[s].first,
+                      facetLayers.end(), layers.back());
+        }
+        pos.insert(pos.end(), chunks[c].pos.begin(), chunks[c].pos.end());
+        size = std::max(size, chunks[c].size);
+        std::vector<Math::Real>().swap(chunks[c].pos);
+    }
+
+    // Vertices are welded when they are within the tolerance, relative to
+    // the size of the model, of each other. They are found by rounding to
+    // multiples of it and probing the neighbouring multiples.
+    const long long numVertices = pos.size() / 3;
+    const Math::Real quantum =
+            size > 0.0 ? size * Math::Util::tolerance : 1.0;
+    std::vector<QuantizedPos> keys(numVertices);
+#pragma omp parallel for
+    for (long long i = 0; i < numVertices; i++) {
+        for (std::size_t d = 0; d < 3; d++) {
+            keys[i].v[d] = std::llround(pos[3*i+d] / quantum);
+        }
+    }
+    WeldIndex index;
+    index.reserve(numVertices);
+    std::vector<std::size_t> vertexIds(numVertices);
+    std::vector<std::size_t> firstVertices;
+    for (long long i = 0; i < numVertices; i++) {
+        const std::size_t id = findWeld(index, firstVertices, pos,
+                                        keys[i], &pos[3*i], quantum);
+        if (id == firstVertices.size()) {
+            index.insert(std::make_pair(keys[i], id));
+            firstVertices.push_back(i);
+        }
+        vertexIds[i] = id;
+    }
 
+    const long long numCoords = firstVertices.size();
+    std::vector<Geometry::CoordR3*> coords(numCoords);
+#pragma omp parallel for
+    for (long long i = 0; i < numCoords; i++) {
+        const Math::Real* p = &pos[3*firstVertices[i]];
+        coords[i] = new Geometry::CoordR3(Geometry::CoordId(i + 1),
+                                          Math::CVecR3(p[0], p[1], p[2]));
+    }
+
+    Data res;
     res.physicalModels = new PhysicalModel::Group<>();
     PhysicalModel::Predefined::PEC* pec =
             new PhysicalModel::Predefined::PEC(PhysicalModel::Id(1));
     res.physicalModels->add(pec);
-    res.mesh->castTo<Geometry::Mesh::Geometric>()->elems().setModel(pec);
+
+    const long long numFacets = facetLayers.size();
+    std::vector<Geometry::ElemR*> elems(numFacets);
+#pragma omp parallel for
+    for (long long f = 0; f < numFacets; f++) {
+        const Geometry::CoordR3* v[3];
+        for (std::size_t i = 0; i < 3; i++) {
+            v[i] = coords[vertexIds[3*f+i]];
+        }
+        elems[f] = new Geometry::Tri3(Geometry::ElemId(f + 1), v,
+                                      facetLayers[f], pec);
+    }
+
+    // The groups are moved into the mesh instead of being cloned.
+    Geometry::Mesh::Geometric* mesh =
+            new Geometry::Mesh::Geometric(Geometry::Grid3());
+    mesh->coords().add(coords);
+    mesh->layers().add(layers);
+    mesh->elems().add(elems);
+    res.mesh = mesh;
     res.sources = new Source::Group<>();
     res.outputRequests = new OutputRequest::Group<>();
 
     return res;
 }
 
+Data readRange(const char* begin, const char* end) {
+    std::vector<Chunk> chunks;
+    readChunks(begin, end, 1, chunks);
+    return buildData(chunks);
+}
+
+} /* namespace */
+
+Parser::Parser() {
+}
+
+Parser::Parser(const std::string& fn)
+:   Project(fn) {
+}
+
+Parser::~Parser() {
+
+}
+
+// The stream is read in batches cut before their last facet, the rest is
+// carried over to the next one. Only a batch of text is kept besides the
+// tokenized facets.
+Data Parser::read(std::istream& stl) const {
+    std::vector<Chunk> chunks;
+    std::vector<char> buffer;
+    std::size_t size = 0;
+    std::size_t line = 1;
+    bool eof = false;
+    while (!eof) {
+        buffer.resize(size + BatchSize);
+        stl.read(&buffer[size], BatchSize);
+        size += stl.gcount();
+        eof = !stl;
+        const char* begin = buffer.data();
+        const char* end = begin + size;
+        const char* last = eof ? end : alignToLastFacet(begin, end);
+        if (last == begin) {
+            continue;
+        }
+        readChunks(begin, last, line, chunks);
+        line += std::count(begin, last, '\n');
+        size = std::copy(last, end, buffer.begin()) - buffer.begin();
+    }
+    return buildData(chunks);
+}
+
+Data Parser::readFile(const std::string& filename) const {
+    if (FileSystem::InputStream::isCompressed(filename)) {
+        return SEMBA::Parser::Parser::readFile(filename);
+    }
+    const FileSystem::MappedFile file(filename);
+    return readRange(file.data(), file.data() + file.size());
+}
+
 void Parser::printInfo() const {
     std::cout << " --- Parser STL info --- " << std::endl;
     std::cout << " --- End of Parser STL info --- " << std::endl;
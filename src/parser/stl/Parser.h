@@ -45,7 +45,12 @@ public:
     Parser(const std::string& fn);
     virtual ~Parser();
 
+    // Reads ASCII STL in a single pass. Each solid is a layer of PEC
+    // triangles, vertices at the same position are welded. The stream is
+    // read in batches, never as a whole.
     Data read(std::istream& inputStream) const;
+    // Uncompressed files are memory mapped instead of being read.
+    Data readFile(const std::string& filename) const;
 
     void printInfo() const;
 };
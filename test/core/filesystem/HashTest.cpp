@@ -0,0 +1,56 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+#include "gtest/gtest.h"
+#include "filesystem/Hash.h"
+
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+using namespace SEMBA;
+using namespace FileSystem;
+
+TEST(HashTest, Contents) {
+    std::vector<char> buf(3*(1 << 20) + 5);
+    for (std::size_t i = 0; i < buf.size(); i++) {
+        buf[i] = static_cast<char>(i*31 % 251);
+    }
+    const std::uint64_t h = hash(buf.data(), buf.size());
+    EXPECT_EQ(h, hash(buf.data(), buf.size()));
+    EXPECT_NE(h, hash(buf.data(), buf.size() - 1));
+    buf[2*(1 << 20) + 7]++;
+    EXPECT_NE(h, hash(buf.data(), buf.size()));
+
+    const char zeros[2] = {0, 0};
+    EXPECT_NE(hash(zeros, 1), hash(zeros, 2));
+    EXPECT_NE(hash(zeros, 0), hash(zeros, 1));
+}
+
+TEST(HashTest, File) {
+    const std::string contents = "{ \"_version\": \"0.14\" }";
+    std::ofstream("hashTestFile.json") << contents;
+    EXPECT_EQ(hash(contents.data(), contents.size()),
+              hashFile("hashTestFile.json"));
+    std::remove("hashTestFile.json");
+    EXPECT_THROW(hashFile("hashTestFile.json"), std::logic_error);
+
+    EXPECT_EQ("00000000000000ff", hashToStr(255));
+}
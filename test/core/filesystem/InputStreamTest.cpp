@@ -0,0 +1,148 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+#include "gtest/gtest.h"
+#include "filesystem/InputStream.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+
+#ifdef OPENSEMBA_USE_ZLIB
+#include <zlib.h>
+#endif
+
+using namespace SEMBA;
+using namespace FileSystem;
+
+namespace {
+
+std::string getContents(const std::size_t size) {
+    std::stringstream ss;
+    for (std::size_t i = 0; ss.tellp() < std::streamoff(size); i++) {
+        ss << i << " " << 0.5*i << "\n";
+    }
+    return ss.str();
+}
+
+#ifdef OPENSEMBA_USE_ZLIB
+void writeGzip(const std::string& filename, const std::string& contents,
+               const char* mode = "wb") {
+    gzFile file = gzopen(filename.c_str(), mode);
+    gzwrite(file, contents.data(), static_cast<unsigned>(contents.size()));
+    gzclose(file);
+}
+#endif
+
+std::string readAll(std::istream& stream) {
+    return std::string(std::istreambuf_iterator<char>(stream),
+                       std::istreambuf_iterator<char>());
+}
+
+}
+
+TEST(InputStreamTest, Plain) {
+    const std::string contents = getContents(1000);
+    std::ofstream("inputStreamPlain.txt") << contents;
+    {
+        InputStream stream("inputStreamPlain.txt");
+        EXPECT_TRUE(stream.is_open());
+        EXPECT_EQ(InputStream::Compression::none, stream.getCompression());
+        EXPECT_EQ(contents, readAll(stream));
+        EXPECT_FALSE(InputStream::isCompressed("inputStreamPlain.txt"));
+    }
+    std::remove("inputStreamPlain.txt");
+
+    InputStream missing("inputStreamPlain.txt");
+    EXPECT_FALSE(missing.is_open());
+    EXPECT_TRUE(missing.fail());
+}
+
+TEST(InputStreamTest, Magic) {
+    const char gzip[] = {'\x1f', '\x8b', '\x08', '\x00'};
+    const char zstd[] = {'\x28', '\xb5', '\x2f', '\xfd'};
+    EXPECT_EQ(InputStream::Compression::gzip,
+              InputStream::getCompression(gzip, 4));
+    EXPECT_EQ(InputStream::Compression::zstd,
+              InputStream::getCompression(zstd, 4));
+    EXPECT_EQ(InputStream::Compression::none,
+              InputStream::getCompression(zstd, 3));
+    EXPECT_EQ(InputStream::Compression::none,
+              InputStream::getCompression("{}", 2));
+}
+
+#ifdef OPENSEMBA_USE_ZLIB
+TEST(InputStreamTest, Gzip) {
+    // Larger than the blocks queued by the decompressing thread.
+    const std::string contents = getContents(3 << 20);
+    writeGzip("inputStreamGzip.txt.gz", contents);
+    {
+        InputStream stream("inputStreamGzip.txt.gz");
+        EXPECT_TRUE(stream.is_open());
+        EXPECT_EQ(InputStream::Compression::gzip, stream.getCompression());
+        EXPECT_EQ(contents, readAll(stream));
+
+        stream.clear();
+        stream.seekg(0);
+        std::size_t first;
+        double second;
+        stream >> first >> second;
+        EXPECT_EQ(0, first);
+        EXPECT_EQ(0.0, second);
+        EXPECT_EQ(3, stream.tellg());
+    }
+    {
+        // Reader stopping early.
+        InputStream stream("inputStreamGzip.txt.gz");
+        std::string line;
+        std::getline(stream, line);
+        EXPECT_EQ("0 0", line);
+    }
+    std::remove("inputStreamGzip.txt.gz");
+}
+
+TEST(InputStreamTest, GzipMembers) {
+    writeGzip("inputStreamMembers.gz", "first ");
+    writeGzip("inputStreamMembers.gz", "second", "ab");
+    {
+        InputStream stream("inputStreamMembers.gz");
+        EXPECT_EQ("first second", readAll(stream));
+    }
+    std::remove("inputStreamMembers.gz");
+}
+
+TEST(InputStreamTest, Truncated) {
+    writeGzip("inputStreamTruncated.gz", getContents(1 << 16));
+    std::string compressed;
+    {
+        std::ifstream file("inputStreamTruncated.gz", std::ios::binary);
+        compressed = readAll(file);
+    }
+    std::ofstream("inputStreamTruncated.gz", std::ios::binary) <<
+            compressed.substr(0, compressed.size() / 2);
+    {
+        InputStream stream("inputStreamTruncated.gz");
+        EXPECT_THROW(readAll(stream), std::logic_error);
+    }
+    std::remove("inputStreamTruncated.gz");
+}
+#endif
@@ -81,3 +81,70 @@ TEST_F(GeometryGridTest, GetSteps) {
     EXPECT_NEAR(0.05, grid_.getStep(1,5), Math::Util::tolerance);
     EXPECT_NEAR(0.05, grid_.getStep(2,5), Math::Util::tolerance);
 }
+
+TEST_F(GeometryGridTest, CellPairRegular) {
+    EXPECT_TRUE(grid_.isRegular());
+
+    std::pair<Int, Real> res = grid_.getCellPair(x, 0.26);
+    EXPECT_EQ(5, res.first);
+    EXPECT_NEAR(0.2, res.second, Math::Util::tolerance);
+
+    res = grid_.getCellPair(y, 0.25);
+    EXPECT_EQ(5, res.first);
+    EXPECT_EQ(0.0, res.second);
+
+    bool err = false;
+    res = grid_.getCellPair(z, -0.1, true, Grid3::tolerance, &err);
+    EXPECT_TRUE(err);
+    EXPECT_EQ(0, res.first);
+
+    res = grid_.getCellPair(z, 1.1, true, Grid3::tolerance, &err);
+    EXPECT_TRUE(err);
+    EXPECT_EQ(20, res.first);
+}
+
+TEST_F(GeometryGridTest, CellPairGraded) {
+    std::vector<Real> pos[3];
+    for (std::size_t d = 0; d < 3; d++) {
+        pos[d] = {0.0, 0.1, 0.3, 0.7, 1.5};
+    }
+    Grid3 grid(pos);
+    EXPECT_FALSE(grid.isRegular());
+
+    std::pair<Int, Real> res = grid.getCellPair(x, 0.4);
+    EXPECT_EQ(2, res.first);
+    EXPECT_NEAR(0.25, res.second, Math::Util::tolerance);
+
+    res = grid.getCellPair(x, 0.3);
+    EXPECT_EQ(2, res.first);
+    EXPECT_EQ(0.0, res.second);
+
+    res = grid.getCellPair(x, 0.699999);
+    EXPECT_EQ(3, res.first);
+    EXPECT_EQ(0.0, res.second);
+
+    bool isInto;
+    CVecI3Fractional frac = grid.getCVecI3Fractional(CVecR3(1.1), isInto);
+    EXPECT_TRUE(isInto);
+    EXPECT_EQ(CVecI3(3), static_cast<const CVecI3&>(frac));
+}
+
+TEST_F(GeometryGridTest, CellPairsBatched) {
+    std::vector<CVecR3> points;
+    for (std::size_t i = 0; i < 100; i++) {
+        points.push_back(CVecR3(0.013*i, 1.0 - 0.007*i, 0.01*i - 0.2));
+    }
+    std::vector<bool> err;
+    std::vector<std::pair<CVecI3, CVecR3>> res =
+        grid_.getCellPairs(points, true, Grid3::tolerance, &err);
+    ASSERT_EQ(points.size(), res.size());
+    ASSERT_EQ(points.size(), err.size());
+    for (std::size_t i = 0; i < points.size(); i++) {
+        bool pointErr;
+        std::pair<CVecI3, CVecR3> single =
+            grid_.getCellPair(points[i], true, Grid3::tolerance, &pointErr);
+        EXPECT_EQ(single.first, res[i].first);
+        EXPECT_EQ(single.second, res[i].second);
+        EXPECT_EQ(pointErr, err[i]);
+    }
+}
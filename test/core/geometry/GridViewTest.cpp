@@ -0,0 +1,85 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#include "GridTest.h"
+#include "geometry/GridView.h"
+
+using namespace SEMBA;
+using namespace Geometry;
+using namespace Math;
+
+TEST_F(GeometryGridTest, ViewNodes) {
+    GridView3 view = GridView3::nodes(grid_);
+    std::vector<CVecR3> pos = grid_.getPos();
+    ASSERT_EQ(pos.size(), view.size());
+    std::size_t n = 0;
+    for (GridView3::Iterator it = view.begin(); it != view.end(); ++it, ++n) {
+        EXPECT_EQ(pos[n], view.getPos(*it));
+        EXPECT_EQ(n, view.getIndex(*it));
+    }
+    EXPECT_EQ(CVecI3(20,20,20), *(view.end()-1));
+    EXPECT_EQ(CVecI3(0,1,2), view.getIJK(view.getIndex(CVecI3(0,1,2))));
+}
+
+TEST_F(GeometryGridTest, ViewCellsInside) {
+    BoxR3 bound(CVecR3(0.1, 0.0, 0.52), CVecR3(0.3, 0.5, 1.0));
+    GridView3 view = GridView3::cellsInside(grid_, bound);
+    std::vector<CVecR3> centers = grid_.getCenterOfCellsInside(bound);
+    ASSERT_EQ(centers.size(), view.size());
+    for (std::size_t n = 0; n < view.size(); n++) {
+        EXPECT_EQ(centers[n], view.getCenter(view.getIJK(n)));
+    }
+    EXPECT_TRUE(GridView3::cellsInside(grid_,
+            BoxR3(CVecR3(0.51), CVecR3(0.52))).empty());
+}
+
+TEST_F(GeometryGridTest, ViewCellsOverlapping) {
+    BoxR3 bound(CVecR3(0.12, 0.0, 0.0), CVecR3(0.2, 0.05, 0.05));
+    GridView3 view = GridView3::cellsOverlapping(grid_, bound);
+    ASSERT_EQ(2, view.size());
+    EXPECT_EQ(CVecI3(2,0,0), view.getMin());
+    EXPECT_EQ(BoxR3(CVecR3(0.12, 0.0, 0.0), CVecR3(0.15, 0.05, 0.05)),
+              view.getBox(view.getIJK(0)));
+    EXPECT_EQ(BoxR3(CVecR3(0.15, 0.0, 0.0), CVecR3(0.2, 0.05, 0.05)),
+              view.getBox(view.getIJK(1)));
+}
+
+TEST_F(GeometryGridTest, ViewChunks) {
+    GridView3 view = GridView3::cells(grid_);
+    const std::size_t nChunks = 7;
+    std::size_t total = 0;
+    for (std::size_t c = 0; c < nChunks; c++) {
+        std::pair<GridView3::Iterator, GridView3::Iterator> chunk =
+            view.getChunk(c, nChunks);
+        if (c > 0) {
+            EXPECT_EQ(view.getChunk(c-1, nChunks).second, chunk.first);
+        }
+        total += chunk.second - chunk.first;
+    }
+    EXPECT_EQ(view.size(), total);
+
+    std::size_t visited = 0;
+    view.forEach([&](const CVecI3& ijk) {
+        EXPECT_EQ(visited, view.getIndex(ijk));
+        visited++;
+    });
+    EXPECT_EQ(view.size(), visited);
+}
@@ -0,0 +1,163 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+#include "gtest/gtest.h"
+
+#include <sstream>
+
+#include "geometry/mesh/Checker.h"
+#include "geometry/element/Line2.h"
+#include "geometry/element/Triangle3.h"
+#include "geometry/element/Tetrahedron4.h"
+
+using namespace SEMBA;
+using namespace Geometry;
+using namespace Math;
+
+class GeometryMeshCheckerTest : public ::testing::Test {
+protected:
+    virtual void SetUp() {
+        std::vector<CVecR3> pos;
+        pos.push_back(CVecR3(0.0, 0.0, 0.0));
+        pos.push_back(CVecR3(1.0, 0.0, 0.0));
+        pos.push_back(CVecR3(0.0, 1.0, 0.0));
+        pos.push_back(CVecR3(0.0, 0.0, 1.0));
+        pos.push_back(CVecR3(1.0, 1.0, 0.0));
+        pos.push_back(CVecR3(5.0, 5.0, 5.0));
+        pos.push_back(CVecR3(6.0, 6.0, 6.0));
+        pos.push_back(CVecR3(0.0, 0.0,-1.0));
+        mesh_.coords().addPos(pos);
+        stray_ = new CoordR3(CoordId(100), CVecR3(2.0));
+
+        mat_ = new Element::Model(MatId(3));
+        other_ = new Element::Model(MatId(7));
+        models_.add(mat_);
+        lay_ = new Layer::Layer(LayerId(1), "Layer");
+        unknown_ = new Layer::Layer(LayerId(5), "Unknown");
+        mesh_.layers().add(lay_);
+    }
+
+    virtual void TearDown() {
+        delete stray_;
+        delete unknown_;
+        delete other_;
+    }
+
+    const CoordR3* v(const std::size_t id) const {
+        return mesh_.coords().getId(CoordId(id));
+    }
+
+    // Tetrahedra are valid when d lies below the right handed normal of abc.
+    void addTet(const std::size_t id,
+                const std::size_t a, const std::size_t b,
+                const std::size_t c, const std::size_t d) {
+        const CoordR3* vs[4] = {v(a), v(b), v(c), v(d)};
+        mesh_.elems().add(new Tet4(ElemId(id), vs, lay_, mat_));
+    }
+
+    Mesh::Unstructured mesh_;
+    CoordR3* stray_;
+    Element::Model* mat_;
+    Element::Model* other_;
+    SEMBA::Group::Identifiable<Element::Model, MatId> models_;
+    Layer::Layer* lay_;
+    Layer::Layer* unknown_;
+};
+
+TEST_F(GeometryMeshCheckerTest, Valid) {
+    addTet(1, 1, 3, 2, 4);
+    const CoordR3* vs[3] = {v(2), v(5), v(3)};
+    mesh_.elems().add(new Tri3(ElemId(2), vs, lay_, mat_));
+    const CoordR3* ls[2] = {v(4), v(6)};
+    mesh_.elems().add(new LinR2(ElemId(3), ls, lay_, mat_));
+    const CoordR3* ms[3] = {v(6), v(7), v(8)};
+    mesh_.elems().add(new Tri3(ElemId(4), ms, lay_, mat_));
+
+    Mesh::Checker::Report report = Mesh::Checker(models_).check(mesh_);
+    EXPECT_TRUE(report.isValid());
+}
+
+TEST_F(GeometryMeshCheckerTest, Problems) {
+    addTet(1, 1, 3, 2, 4);
+    addTet(2, 1, 3, 2, 8);
+    addTet(3, 1, 3, 2, 6);
+    // Flattened after construction, which checks the volume.
+    mesh_.coords().setPos(5, CVecR3(3.0, 3.0, 0.0));
+    const CoordR3* vs[3] = {v(2), v(5), v(3)};
+    mesh_.elems().add(new Tri3(ElemId(4), vs, lay_, other_));
+    const CoordR3* ws[3] = {v(3), v(2), v(5)};
+    mesh_.elems().add(new Tri3(ElemId(5), ws, unknown_, mat_));
+    const CoordR3* ls[2] = {v(4), stray_};
+    mesh_.elems().add(new LinR2(ElemId(6), ls, lay_, mat_));
+
+    Mesh::Checker::Report report = Mesh::Checker(models_).check(mesh_);
+    EXPECT_FALSE(report.isValid());
+    EXPECT_EQ(1, report.count(Mesh::Checker::danglingCoordinate));
+    EXPECT_EQ(0, report.count(Mesh::Checker::duplicatedId));
+    EXPECT_EQ(1, report.count(Mesh::Checker::duplicatedConnectivity));
+    EXPECT_EQ(1, report.count(Mesh::Checker::degenerate));
+    EXPECT_EQ(1, report.count(Mesh::Checker::inverted));
+    EXPECT_EQ(1, report.count(Mesh::Checker::unusedCoordinate));
+    EXPECT_EQ(1, report.count(Mesh::Checker::missingModel));
+    EXPECT_EQ(1, report.count(Mesh::Checker::missingLayer));
+
+    const std::vector<Mesh::Checker::Issue>& issues = report.issues();
+    ASSERT_EQ(7, issues.size());
+    EXPECT_EQ(Mesh::Checker::danglingCoordinate, issues[0].problem);
+    EXPECT_EQ(6, issues[0].id);
+    EXPECT_EQ(100, issues[0].related);
+    EXPECT_EQ(Mesh::Checker::duplicatedConnectivity, issues[1].problem);
+    EXPECT_EQ(5, issues[1].id);
+    EXPECT_EQ(4, issues[1].related);
+    EXPECT_EQ(3, issues[2].id);
+    EXPECT_EQ(2, issues[3].id);
+    EXPECT_EQ(7, issues[4].id);
+    EXPECT_EQ(4, issues[5].id);
+    EXPECT_EQ(7, issues[5].related);
+    EXPECT_EQ(5, issues[6].id);
+    EXPECT_EQ(5, issues[6].related);
+
+    // Models are not checked when not given.
+    EXPECT_EQ(0, Mesh::Checker().check(mesh_).count(
+                     Mesh::Checker::missingModel));
+
+    std::stringstream json;
+    report.writeJSON(json);
+    EXPECT_NE(std::string::npos, json.str().find("\"valid\": false"));
+    EXPECT_NE(std::string::npos, json.str().find(
+        "{\"problem\": \"inverted\", \"id\": 2, \"related\": 0}"));
+}
+
+TEST_F(GeometryMeshCheckerTest, Structured) {
+    Grid3 grid(BoxR3(CVecR3(0.0), CVecR3(4.0)), CVecR3(1.0));
+    CoordI3Group cG;
+    std::vector<ElemI*> elems;
+    elems.push_back(new HexI8(cG, ElemId(1),
+            BoxI3(CVecI3(0,0,0), CVecI3(2,2,1)), lay_, mat_));
+    elems.push_back(new HexI8(cG, ElemId(2),
+            BoxI3(CVecI3(0,0,0), CVecI3(2,2,1)), lay_, mat_));
+    Layer::Group<> layers;
+    layers.add(new Layer::Layer(LayerId(1), "Layer"));
+    Mesh::Structured mesh(grid, cG, ElemIGroup(elems), layers);
+
+    Mesh::Checker::Report report = Mesh::Checker(models_).check(mesh);
+    EXPECT_EQ(1, report.count(Mesh::Checker::duplicatedConnectivity));
+    EXPECT_EQ(1, report.issues().size());
+}
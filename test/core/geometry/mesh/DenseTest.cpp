@@ -0,0 +1,115 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#include "gtest/gtest.h"
+
+#include "geometry/mesh/Dense.h"
+#include "geometry/element/Line2.h"
+#include "geometry/element/Quadrilateral4.h"
+
+using namespace SEMBA;
+using namespace Geometry;
+using namespace Math;
+using namespace Constants;
+
+class GeometryMeshDenseTest : public ::testing::Test {
+protected:
+    virtual void SetUp() {
+        grid_ = Grid3(BoxR3(CVecR3(0.0), CVecR3(4.0)), CVecR3(1.0));
+        mat_ = new Element::Model(MatId(3));
+        lay_ = new Layer::Layer(LayerId(1), "Layer");
+        layers_.add(lay_);
+
+        CoordI3Group cG;
+        std::vector<ElemI*> elems;
+        elems.push_back(new HexI8(cG, ElemId(1),
+                BoxI3(CVecI3(0,0,0), CVecI3(2,2,1)), lay_, mat_));
+        elems.push_back(new QuaI4(cG, ElemId(2),
+                BoxI3(CVecI3(1,1,3), CVecI3(3,2,3)), lay_));
+        elems.push_back(new LinI2(cG, ElemId(3),
+                BoxI3(CVecI3(4,0,4), CVecI3(4,4,4))));
+        mesh_ = new Mesh::Structured(grid_, cG, ElemIGroup(elems), layers_);
+    }
+
+    virtual void TearDown() {
+        delete mesh_;
+        delete mat_;
+    }
+
+    Grid3 grid_;
+    Element::Model* mat_;
+    Layer::Layer* lay_;
+    Layer::Group<> layers_;
+    Mesh::Structured* mesh_;
+};
+
+TEST_F(GeometryMeshDenseTest, FromStructured) {
+    Mesh::Dense dense(*mesh_);
+    EXPECT_EQ(3, dense.materials().size());
+
+    const Mesh::Dense::Index hex = dense.getCell(CVecI3(1,1,0));
+    EXPECT_NE(0, hex);
+    EXPECT_EQ(mat_, dense.materials().getModel(hex));
+    EXPECT_EQ(LayerId(1), dense.materials().getLayer(hex)->getId());
+    EXPECT_EQ(0, dense.getCell(CVecI3(2,0,0)));
+    EXPECT_EQ(0, dense.getCell(CVecI3(0,0,1)));
+
+    EXPECT_NE(0, dense.getFace(z, CVecI3(2,1,3)));
+    EXPECT_EQ(0, dense.getFace(z, CVecI3(1,2,3)));
+    EXPECT_EQ(0, dense.getFace(x, CVecI3(2,1,3)));
+
+    const Mesh::Dense::Index edge = dense.getEdge(y, CVecI3(4,3,4));
+    EXPECT_NE(0, edge);
+    EXPECT_EQ(nullptr, dense.materials().getModel(edge));
+    EXPECT_EQ(0, dense.getEdge(x, CVecI3(3,3,4)));
+
+    EXPECT_THROW(dense.setCell(CVecI3(4,0,0), hex), std::out_of_range);
+}
+
+TEST_F(GeometryMeshDenseTest, ToStructured) {
+    Mesh::Dense dense(*mesh_);
+    Mesh::Structured* res = dense.getMeshStructured();
+
+    EXPECT_EQ(4, res->elems().getOf<HexI8>().size());
+    EXPECT_EQ(2, res->elems().getOf<QuaI4>().size());
+    EXPECT_EQ(4, res->elems().getOf<LinI2>().size());
+    for (std::size_t e = 0; e < res->elems().size(); e++) {
+        const ElemI* elem = res->elems()(e);
+        if (elem->is<HexI8>()) {
+            EXPECT_EQ(mat_, elem->getModel());
+            EXPECT_EQ(res->layers().getId(LayerId(1)), elem->getLayer());
+        }
+    }
+    // Shared nodes are not repeated.
+    EXPECT_EQ(18 + 6 + 5, res->coords().size());
+
+    Mesh::Dense back(*res);
+    Mesh::Dense copy(back);
+    for (Int i = 0; i < 4; i++) {
+        for (Int j = 0; j < 4; j++) {
+            EXPECT_EQ(dense.getCell(CVecI3(i,j,0)) != 0,
+                      copy.getCell(CVecI3(i,j,0)) != 0);
+        }
+    }
+    EXPECT_EQ(copy.materials().layers().getId(LayerId(1)),
+              copy.materials().getLayer(copy.getCell(CVecI3(0,0,0))));
+    delete res;
+}
@@ -20,6 +20,9 @@
 // along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
 #include "GeometricTest.h"
 
+#include "geometry/element/Line2.h"
+#include "geometry/mesh/Structured.h"
+
 TEST_F(GeometryMeshGeometricTest, ctor) {
     EXPECT_EQ(cG_.size(), mesh_.coords().size());
 
@@ -29,3 +32,50 @@ TEST_F(GeometryMeshGeometricTest, ctor) {
 
     EXPECT_EQ(lG_.size(), mesh_.layers().size());
 }
+
+TEST_F(GeometryMeshGeometricTest, getMeshStructured) {
+    Grid3 grid(BoxR3(CVecR3(0.0), CVecR3(10.0)), CVecR3(1.0));
+    CoordR3Group cG;
+    vector<CoordR3*> coords;
+    CoordId coordId(1);
+    for (size_t i = 0; i < 10; i++) {
+        for (size_t j = 0; j < 10; j++) {
+            coords.push_back(new CoordR3(coordId++, CVecR3(i, j, 3.0)));
+        }
+    }
+    coords.push_back(new CoordR3(coordId++, CVecR3(0.5, 0.0, 3.0)));
+    cG.add(coords);
+
+    vector<ElemR*> elems;
+    ElemId elemId(1);
+    for (size_t c = 1; c < cG.size(); c++) {
+        const CoordR3* v[2] = {cG(0), cG(c)};
+        elems.push_back(new LinR2(elemId++, v));
+    }
+    ElemRGroup eG(elems);
+    Mesh::Geometric mesh(grid, cG, eG);
+
+    Mesh::Structured* res = mesh.getMeshStructured();
+    ASSERT_EQ(cG.size(), res->coords().size());
+    for (size_t i = 0; i < cG.size(); i++) {
+        CoordI3* serial = cG(i)->toStructured(grid);
+        EXPECT_EQ(serial->getId(), res->coords()(i)->getId());
+        EXPECT_EQ(serial->pos(), res->coords()(i)->pos());
+        delete serial;
+    }
+    // Only lines between two nodes on the same grid line are structured.
+    vector<ElemId> expected;
+    for (size_t e = 0; e < eG.size(); e++) {
+        ElemI* serial = eG(e)->toStructured(res->coords(), grid);
+        if (serial != nullptr) {
+            expected.push_back(serial->getId());
+            delete serial;
+        }
+    }
+    EXPECT_EQ(18, expected.size());
+    ASSERT_EQ(expected.size(), res->elems().size());
+    for (size_t e = 0; e < expected.size(); e++) {
+        EXPECT_EQ(expected[e], res->elems()(e)->getId());
+    }
+    delete res;
+}
@@ -0,0 +1,127 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+
+#include "geometry/mesh/Dense.h"
+#include "geometry/mesh/Sparse.h"
+
+using namespace SEMBA;
+using namespace Geometry;
+using namespace Math;
+
+class GeometryMeshSparseTest : public ::testing::Test {
+protected:
+    virtual void SetUp() {
+        grid_ = Grid3(BoxR3(CVecR3(0.0), CVecR3(50.0, 40.0, 20.0)),
+                      CVecR3(1.0));
+        mat1_ = new Element::Model(MatId(1));
+        mat2_ = new Element::Model(MatId(2));
+
+        CoordI3Group cG;
+        std::vector<ElemI*> elems;
+        elems.push_back(new HexI8(cG, ElemId(1),
+                BoxI3(CVecI3(0,0,0), CVecI3(32,40,16)), nullptr, mat1_));
+        elems.push_back(new HexI8(cG, ElemId(2),
+                BoxI3(CVecI3(20,5,3), CVecI3(23,9,20)), nullptr, mat2_));
+        elems.push_back(new HexI8(cG, ElemId(3),
+                BoxI3(CVecI3(48,32,16), CVecI3(50,40,20)), nullptr, mat1_));
+        mesh_ = new Mesh::Structured(grid_, cG, ElemIGroup(elems));
+    }
+
+    virtual void TearDown() {
+        delete mesh_;
+        delete mat1_;
+        delete mat2_;
+    }
+
+    void expectSameCells(const Mesh::Dense& dense,
+                         const Mesh::Sparse& sparse) const {
+        const CVecI3 n = grid_.getNumCells();
+        for (Int i = 0; i < n(0); i++) {
+            for (Int j = 0; j < n(1); j++) {
+                for (Int k = 0; k < n(2); k++) {
+                    const CVecI3 ijk(i,j,k);
+                    ASSERT_EQ(dense.materials().getModel(dense.getCell(ijk)),
+                        sparse.materials().getModel(sparse.getCell(ijk)));
+                }
+            }
+        }
+    }
+
+    Grid3 grid_;
+    Element::Model *mat1_, *mat2_;
+    Mesh::Structured* mesh_;
+};
+
+TEST_F(GeometryMeshSparseTest, FromStructured) {
+    Mesh::Sparse sparse(*mesh_, 8);
+    EXPECT_EQ(CVecI3(7,5,3), sparse.getNumBricks());
+    EXPECT_TRUE(sparse.isUniform(CVecI3(0,0,0)));
+    EXPECT_TRUE(sparse.isUniform(CVecI3(6,4,2)));
+    EXPECT_FALSE(sparse.isUniform(CVecI3(2,0,0)));
+    EXPECT_EQ(6, sparse.numberOfDetailedBricks());
+    expectSameCells(Mesh::Dense(*mesh_), sparse);
+    EXPECT_LT(sparse.getMemory(), Mesh::Dense(*mesh_).getMemory());
+
+    EXPECT_THROW(sparse.getCell(CVecI3(50,0,0)), std::out_of_range);
+}
+
+TEST_F(GeometryMeshSparseTest, SetAndCompress) {
+    Mesh::Sparse sparse(grid_, 8);
+    const Mesh::Sparse::Index i = sparse.materials().add(mat1_);
+    sparse.setCells(BoxI3(CVecI3(0), CVecI3(8,8,8)), i);
+    EXPECT_EQ(0, sparse.numberOfDetailedBricks());
+    sparse.setCell(CVecI3(3,3,3), 0);
+    EXPECT_EQ(1, sparse.numberOfDetailedBricks());
+    EXPECT_EQ(0, sparse.getCell(CVecI3(3,3,3)));
+    sparse.compress();
+    EXPECT_EQ(0, sparse.getCell(CVecI3(3,3,3)));
+    EXPECT_EQ(i, sparse.getCell(CVecI3(4,3,3)));
+    sparse.setCell(CVecI3(3,3,3), i);
+    sparse.compress();
+    EXPECT_EQ(0, sparse.numberOfDetailedBricks());
+    EXPECT_EQ(i, sparse.getCell(CVecI3(3,3,3)));
+}
+
+TEST_F(GeometryMeshSparseTest, ForEachDetailed) {
+    Mesh::Sparse sparse(*mesh_, 8);
+    std::atomic<std::size_t> visited(0), wrong(0);
+    sparse.forEachDetailed([&](const CVecI3& ijk, Mesh::Sparse::Index i) {
+        visited++;
+        if (sparse.getCell(ijk) != i) {
+            wrong++;
+        }
+    });
+    EXPECT_EQ(0, wrong.load());
+    EXPECT_EQ(4*8*8*8 + 2*8*8*4, visited.load());
+}
+
+TEST_F(GeometryMeshSparseTest, ToStructured) {
+    Mesh::Sparse sparse(*mesh_, 8);
+    Mesh::Structured* res = sparse.getMeshStructured();
+    // Much less than one hexahedron per non empty cell.
+    EXPECT_LT(res->elems().size(), 500);
+    expectSameCells(Mesh::Dense(*res), sparse);
+    delete res;
+}
@@ -0,0 +1,174 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+#include "gtest/gtest.h"
+
+#include "geometry/mesh/Structured.h"
+#include "geometry/mesh/Unstructured.h"
+#include "geometry/element/Line2.h"
+#include "geometry/element/Quadrilateral4.h"
+
+using namespace SEMBA;
+using namespace Geometry;
+using namespace Math;
+
+class GeometryMeshStructuredTest : public ::testing::Test {
+protected:
+    virtual void SetUp() {
+        std::vector<Real> pos[3];
+        for (std::size_t d = 0; d < 3; d++) {
+            Real p = 0.0;
+            for (std::size_t i = 0; i <= 20; i++) {
+                pos[d].push_back(p);
+                p += 1.0 + 0.1*i*(d+1);
+            }
+        }
+        grid_ = Grid3(pos);
+        mat_ = new Element::Model(MatId(3));
+        layers_.add(new Layer::Layer(LayerId(1), "Volumes"));
+        layers_.add(new Layer::Layer(LayerId(2), "Surfaces"));
+
+        // Enough hexahedra to be converted by several chunks.
+        CoordI3Group cG;
+        std::vector<ElemI*> elems;
+        std::size_t id = 1;
+        for (Int i = 0; i < 20; i++) {
+            for (Int j = 0; j < 20; j++) {
+                for (Int k = 0; k < 5; k++) {
+                    elems.push_back(new HexI8(cG, ElemId(id++),
+                            BoxI3(CVecI3(i,j,k), CVecI3(i+1,j+1,k+1)),
+                            layers_(0), (k < 2)? mat_ : nullptr));
+                }
+            }
+        }
+        elems.push_back(new QuaI4(cG, ElemId(id++),
+                BoxI3(CVecI3(0,0,10), CVecI3(3,2,10)), layers_(1), mat_));
+        elems.push_back(new LinI2(cG, ElemId(id++),
+                BoxI3(CVecI3(0,20,20), CVecI3(20,20,20))));
+        mesh_ = new Mesh::Structured(grid_, cG, ElemIGroup(elems), layers_);
+    }
+
+    virtual void TearDown() {
+        delete mesh_;
+        delete mat_;
+    }
+
+    Grid3 grid_;
+    Element::Model* mat_;
+    Layer::Group<> layers_;
+    Mesh::Structured* mesh_;
+};
+
+TEST_F(GeometryMeshStructuredTest, ToUnstructured) {
+    Mesh::Unstructured* res = mesh_->getMeshUnstructured();
+
+    ASSERT_EQ(mesh_->coords().size(), res->coords().size());
+    for (std::size_t i = 0; i < mesh_->coords().size(); i++) {
+        const CoordI3* coord = mesh_->coords()(i);
+        EXPECT_EQ(coord->getId(), res->coords()(i)->getId());
+        EXPECT_EQ(grid_.getPos(coord->pos()), res->coords()(i)->pos());
+    }
+    ASSERT_EQ(mesh_->elems().size(), res->elems().size());
+    for (std::size_t i = 0; i < mesh_->elems().size(); i++) {
+        EXPECT_EQ(mesh_->elems()(i)->getId(), res->elems()(i)->getId());
+    }
+    EXPECT_EQ(2000, res->elems().getOf<HexR8>().size());
+    EXPECT_EQ(1, res->elems().getOf<QuaR4>().size());
+    EXPECT_EQ(1, res->elems().getOf<LinR2>().size());
+    EXPECT_EQ(2, res->layers().size());
+
+    delete res;
+}
+
+TEST_F(GeometryMeshStructuredTest, ToUnstructuredFiltered) {
+    Mesh::Structured::Filter byMat;
+    byMat.addMatId(MatId(3));
+    Mesh::Unstructured* res = mesh_->getMeshUnstructured(byMat);
+    EXPECT_EQ(801, res->elems().size());
+    EXPECT_EQ(1, res->elems().getOf<QuaR4>().size());
+    EXPECT_EQ(21*21*3 + 4, res->coords().size());
+    delete res;
+
+    Mesh::Structured::Filter byLayerAndType;
+    byLayerAndType.addLayerId(LayerId(1)).addLayerId(LayerId(2));
+    byLayerAndType.addType(Mesh::Structured::Filter::surface);
+    res = mesh_->getMeshUnstructured(byLayerAndType);
+    ASSERT_EQ(1, res->elems().size());
+    EXPECT_EQ(4, res->coords().size());
+    const QuaR4* qua = res->elems()(0)->castTo<QuaR4>();
+    EXPECT_EQ(MatId(3), qua->getMatId());
+    EXPECT_EQ(grid_.getPos(CVecI3(3,2,10)), qua->getMaxV()->pos());
+    delete res;
+
+    Mesh::Structured::Filter byType;
+    byType.addType(Mesh::Structured::Filter::line);
+    res = mesh_->getMeshUnstructured(byType);
+    EXPECT_EQ(1, res->elems().getOf<LinR2>().size());
+    EXPECT_EQ(1, res->elems().size());
+    EXPECT_EQ(2, res->coords().size());
+    delete res;
+}
+
+TEST_F(GeometryMeshStructuredTest, IncrementalFromUnstructured) {
+    Mesh::Unstructured* uns = mesh_->getMeshUnstructured();
+    uns->coords().startTracking();
+    uns->elems().startTracking();
+    Mesh::Structured* str = uns->getMeshStructured(grid_);
+    const ElemI* untouched = str->elems().getId(ElemId(100));
+    const Group::Generation generation = Group::getCurrentGeneration();
+
+    const LinR2* lin = uns->elems().getOf<LinR2>()(0);
+    for (std::size_t i = 0; i < uns->coords().size(); i++) {
+        if (uns->coords()(i)->getId() == lin->getV(0)->getId()) {
+            uns->coords().setPos(i, grid_.getPos(CVecI3(5,20,20)));
+        }
+    }
+    uns->elems().setModel(ElemId(1), nullptr);
+    uns->elems().removeId(ElemId(2));
+
+    uns->updateMeshStructured(*str, generation);
+    Mesh::Structured* full = uns->getMeshStructured(grid_);
+
+    EXPECT_EQ(untouched, str->elems().getId(ElemId(100)));
+    ASSERT_EQ(full->coords().size(), str->coords().size());
+    for (std::size_t i = 0; i < full->coords().size(); i++) {
+        EXPECT_EQ(full->coords()(i)->getId(), str->coords()(i)->getId());
+        EXPECT_EQ(full->coords()(i)->pos(), str->coords()(i)->pos());
+    }
+    ASSERT_EQ(full->elems().size(), str->elems().size());
+    for (std::size_t i = 0; i < full->elems().size(); i++) {
+        const ElemI* lhs = full->elems()(i);
+        const ElemI* rhs = str->elems()(i);
+        EXPECT_EQ(lhs->getId(), rhs->getId());
+        EXPECT_EQ(lhs->getMatId(), rhs->getMatId());
+        ASSERT_EQ(lhs->numberOfCoordinates(), rhs->numberOfCoordinates());
+        for (std::size_t j = 0; j < lhs->numberOfCoordinates(); j++) {
+            EXPECT_EQ(lhs->getV(j)->pos(), rhs->getV(j)->pos());
+        }
+    }
+    EXPECT_FALSE(str->elems().existId(ElemId(2)));
+    EXPECT_EQ(MatId(0), str->elems().getId(ElemId(1))->getMatId());
+    EXPECT_EQ(CVecI3(5,20,20),
+              str->elems().getId(lin->getId())->getV(0)->pos());
+
+    delete full;
+    delete str;
+    delete uns;
+}
@@ -0,0 +1,126 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#include "gtest/gtest.h"
+#include "geometry/layer/Group.h"
+
+using namespace SEMBA;
+using namespace Geometry;
+
+class TrackerTest : public ::testing::Test {
+protected:
+    virtual void SetUp() {
+        layers_.add(new Layer::Layer(LayerId(1), "Patata"));
+        layers_.add(new Layer::Layer(LayerId(2), "Cebolla"));
+        layers_.add(new Layer::Layer(LayerId(3), "Huevos"));
+    }
+
+    Layer::Group<> layers_;
+};
+
+TEST_F(TrackerTest, disabled) {
+    const Group::Generation start = Group::getCurrentGeneration();
+    layers_.add(new Layer::Layer(LayerId(4), "Aceite"));
+    layers_.touchId(LayerId(1));
+    EXPECT_FALSE(layers_.tracker().isTracking());
+    EXPECT_EQ(start, Group::getCurrentGeneration());
+    EXPECT_TRUE(layers_.tracker().getChanged(0).empty());
+}
+
+TEST_F(TrackerTest, journal) {
+    layers_.startTracking();
+    const Group::Generation start = Group::getCurrentGeneration();
+
+    layers_.add(new Layer::Layer(LayerId(4), "Aceite"));
+    const Group::Generation added = layers_.tracker().getGeneration();
+    EXPECT_GT(added, start);
+    EXPECT_EQ(added, layers_.tracker().getRangeGeneration(LayerId(4)));
+    EXPECT_EQ(added, layers_.tracker().getRangeGeneration(LayerId(1)));
+    EXPECT_EQ(0, layers_.tracker().getRangeGeneration(
+                     LayerId(Group::Tracker<LayerId>::rangeSize)));
+
+    layers_.touchId(LayerId(2));
+    layers_.removeId(LayerId(3));
+    EXPECT_EQ(3, layers_.size());
+    EXPECT_TRUE(layers_.existId(LayerId(4)));
+
+    std::vector<LayerId> changed = layers_.tracker().getChanged(start);
+    ASSERT_EQ(3, changed.size());
+    EXPECT_EQ(LayerId(2), changed[0]);
+    EXPECT_EQ(LayerId(3), changed[1]);
+    EXPECT_EQ(LayerId(4), changed[2]);
+
+    changed = layers_.tracker().getChanged(added);
+    ASSERT_EQ(2, changed.size());
+    EXPECT_EQ(LayerId(2), changed[0]);
+    EXPECT_EQ(LayerId(3), changed[1]);
+
+    std::vector<LayerId> removed = layers_.tracker().getRemoved(start);
+    ASSERT_EQ(1, removed.size());
+    EXPECT_EQ(LayerId(3), removed[0]);
+
+    layers_.stopTracking();
+    layers_.touchId(LayerId(1));
+    EXPECT_EQ(3, layers_.tracker().getChanged(start).size());
+}
+
+TEST_F(TrackerTest, truncate) {
+    layers_.startTracking();
+    const Group::Generation start = Group::getCurrentGeneration();
+    layers_.touchId(LayerId(1));
+    const Group::Generation touched = layers_.tracker().getGeneration();
+    layers_.removeId(LayerId(2));
+
+    layers_.truncateTracking(touched);
+    EXPECT_FALSE(layers_.tracker().hasJournalAfter(start));
+    EXPECT_TRUE(layers_.tracker().hasJournalAfter(touched));
+    EXPECT_THROW(layers_.tracker().getChanged(start), std::logic_error);
+    EXPECT_THROW(layers_.tracker().getRemoved(start), std::logic_error);
+
+    std::vector<LayerId> changed = layers_.tracker().getChanged(touched);
+    ASSERT_EQ(1, changed.size());
+    EXPECT_EQ(LayerId(2), changed[0]);
+    EXPECT_EQ(1, layers_.tracker().getRemoved(touched).size());
+}
+
+TEST_F(TrackerTest, removedAndAddedAgain) {
+    layers_.startTracking();
+    const Group::Generation start = Group::getCurrentGeneration();
+    layers_.removeId(LayerId(3));
+    layers_.add(new Layer::Layer(LayerId(3), "Huevos"));
+    EXPECT_TRUE(layers_.tracker().getRemoved(start).empty());
+    EXPECT_EQ(1, layers_.tracker().getChanged(start).size());
+}
+
+TEST_F(TrackerTest, notCopied) {
+    layers_.startTracking();
+    layers_.touchId(LayerId(1));
+
+    Layer::Group<> copy(layers_);
+    EXPECT_FALSE(copy.tracker().isTracking());
+    EXPECT_EQ(0, copy.tracker().getGeneration());
+    EXPECT_TRUE(copy.tracker().getChanged(0).empty());
+
+    copy.startTracking();
+    copy = layers_;
+    EXPECT_TRUE(copy.tracker().isTracking());
+    EXPECT_EQ(3, copy.tracker().getChanged(0).size());
+}
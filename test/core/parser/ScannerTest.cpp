@@ -0,0 +1,126 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#include "gtest/gtest.h"
+
+#include <clocale>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "parser/Scanner.h"
+
+using namespace SEMBA;
+using namespace Parser;
+
+class ParserScannerTest : public ::testing::Test {
+protected:
+    static Math::Real readReal(const std::string& str) {
+        Scanner scanner(str);
+        Math::Real res;
+        EXPECT_TRUE(scanner.read(res)) << str;
+        EXPECT_TRUE(scanner.atEnd()) << str;
+        return res;
+    }
+};
+
+TEST_F(ParserScannerTest, Reals) {
+    const char* values[] = {
+            "0", "-0.0", "1", "+5.00000000e-01", "-1.50000000e+00",
+            "3.27548347E-1", "1e22", "1e23", "123456789012345678901234",
+            "0.1", "2.2250738585072014e-308", "1.7976931348623157e308",
+            "4.9e-324", ".5", "5.", "0.000000000000000000000000001"};
+    for (std::size_t i = 0; i < sizeof(values)/sizeof(values[0]); i++) {
+        EXPECT_EQ(std::strtod(values[i], nullptr), readReal(values[i]))
+                << values[i];
+    }
+
+    std::mt19937 gen(1);
+    std::uniform_real_distribution<double> dist(-1e3, 1e3);
+    char str[64];
+    for (std::size_t i = 0; i < 10000; i++) {
+        std::snprintf(str, sizeof(str), "%+.8e", dist(gen));
+        EXPECT_EQ(std::strtod(str, nullptr), readReal(str)) << str;
+        std::snprintf(str, sizeof(str), "%.17g", dist(gen));
+        EXPECT_EQ(std::strtod(str, nullptr), readReal(str)) << str;
+    }
+}
+
+TEST_F(ParserScannerTest, CommaLocale) {
+    // Values which can not be read exactly by the fast path.
+    const char* values[] = {
+            "1.2345678901234567890123", "-2.5e+200", "4.9e-324",
+            "123456789012345678901234.5"};
+    const std::size_t n = sizeof(values)/sizeof(values[0]);
+    std::vector<Math::Real> expected;
+    for (std::size_t i = 0; i < n; i++) {
+        expected.push_back(std::strtod(values[i], nullptr));
+    }
+
+    const std::string previous = std::setlocale(LC_NUMERIC, nullptr);
+    const char* locales[] = {"de_DE.UTF-8", "de_DE.utf8", "de_DE",
+                             "es_ES.UTF-8", "fr_FR.UTF-8"};
+    bool found = false;
+    for (std::size_t i = 0; i < 5 && !found; i++) {
+        found = (std::setlocale(LC_NUMERIC, locales[i]) != nullptr);
+    }
+    if (!found) {
+        GTEST_SKIP() << "No locale with a decimal comma is installed.";
+    }
+    for (std::size_t i = 0; i < n; i++) {
+        EXPECT_EQ(expected[i], readReal(values[i])) << values[i];
+    }
+    std::setlocale(LC_NUMERIC, previous.c_str());
+}
+
+TEST_F(ParserScannerTest, Records) {
+    Scanner scanner("  12\t-1.5e+00  7 ");
+    std::size_t id, other;
+    Math::Real pos;
+    EXPECT_TRUE(scanner.read(id));
+    EXPECT_EQ(12, id);
+    EXPECT_FALSE(scanner.read(id));
+    EXPECT_TRUE(scanner.read(pos));
+    EXPECT_EQ(-1.5, pos);
+    EXPECT_TRUE(scanner.read(other));
+    EXPECT_EQ(7, other);
+    EXPECT_TRUE(scanner.atEnd());
+    EXPECT_FALSE(scanner.read(id));
+}
+
+TEST_F(ParserScannerTest, Errors) {
+    const char* reals[] = {"", "-", "e5", "1e", "1.5x", "--1", "1,5",
+                           "1e400"};
+    for (std::size_t i = 0; i < sizeof(reals)/sizeof(reals[0]); i++) {
+        Scanner scanner(reals[i]);
+        Math::Real value;
+        EXPECT_FALSE(scanner.read(value)) << reals[i];
+    }
+    const char* ids[] = {"-1", "1.0", "99999999999999999999999", "x"};
+    for (std::size_t i = 0; i < sizeof(ids)/sizeof(ids[0]); i++) {
+        Scanner scanner(ids[i]);
+        std::size_t value;
+        EXPECT_FALSE(scanner.read(value)) << ids[i];
+        EXPECT_EQ(scanner.begin(), scanner.pos());
+    }
+}
@@ -0,0 +1,137 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#include "exporter/binary/Exporter.h"
+#include "geometry/element/Quadrilateral4.h"
+
+using namespace SEMBA;
+using namespace Geometry;
+using namespace Math;
+using namespace Exporter::Binary;
+
+class ExporterBinaryExporterTest : public ::testing::Test {
+protected:
+    virtual void SetUp() {
+        mat_ = new Element::Model(MatId(3));
+        lay_ = new Layer::Layer(LayerId(2), "Layer");
+        layers_.add(lay_);
+
+        CoordI3Group cG;
+        std::vector<ElemI*> elems;
+        elems.push_back(new HexI8(cG, ElemId(1),
+                BoxI3(CVecI3(0,0,0), CVecI3(2,2,1)), lay_, mat_));
+        elems.push_back(new QuaI4(cG, ElemId(2),
+                BoxI3(CVecI3(1,1,3), CVecI3(3,2,3)), nullptr, mat_));
+        smb_.mesh = new Mesh::Structured(
+                Grid3(BoxR3(CVecR3(0.0), CVecR3(4.0)), CVecR3(1.0)),
+                cG, ElemIGroup(elems), layers_);
+    }
+
+    virtual void TearDown() {
+        delete mat_;
+    }
+
+    static std::vector<char> read(const std::string& filename) {
+        std::ifstream file(filename.c_str(), std::ios::binary);
+        std::vector<char> res((std::istreambuf_iterator<char>(file)),
+                              std::istreambuf_iterator<char>());
+        std::remove(filename.c_str());
+        return res;
+    }
+
+    Element::Model* mat_;
+    Layer::Layer* lay_;
+    Layer::Group<> layers_;
+    Data smb_;
+};
+
+TEST_F(ExporterBinaryExporterTest, Raw) {
+    Exporter::Binary::Exporter(&smb_, "binaryExporterRaw");
+    const std::vector<char> buf = read("binaryExporterRaw.bin");
+    ASSERT_GE(buf.size(), sizeof(Header));
+    const Header* header = reinterpret_cast<const Header*>(buf.data());
+    EXPECT_EQ(0, std::memcmp(header->magic, Magic, sizeof(Magic)));
+    EXPECT_EQ(2, header->indexBytes);
+    for (std::size_t s = 0; s < numSections; s++) {
+        EXPECT_EQ(0, header->sections[s].offset % Alignment);
+        EXPECT_LE(header->sections[s].offset + header->sections[s].bytes,
+                  buf.size());
+    }
+    for (std::size_t d = 0; d < 3; d++) {
+        EXPECT_EQ(5, header->numNodes[d]);
+    }
+    const double* x = reinterpret_cast<const double*>(
+            &buf[header->sections[gridX].offset]);
+    EXPECT_EQ(4.0, x[4]);
+
+    ASSERT_EQ(3, header->sections[materials].count);
+    const MaterialEntry* entries = reinterpret_cast<const MaterialEntry*>(
+            &buf[header->sections[materials].offset]);
+    EXPECT_EQ(0, entries[0].matId);
+    EXPECT_EQ(3, entries[1].matId);
+    EXPECT_EQ(2, entries[1].layerId);
+    EXPECT_EQ(0, entries[2].layerId);
+
+    ASSERT_EQ(125, header->sections[cells].count);
+    const std::uint16_t* cellValues = reinterpret_cast<const std::uint16_t*>(
+            &buf[header->sections[cells].offset]);
+    EXPECT_EQ(1, cellValues[(1*5 + 1)*5 + 0]);
+    EXPECT_EQ(0, cellValues[(1*5 + 1)*5 + 1]);
+    EXPECT_EQ(0, header->sections[facesX].count);
+    ASSERT_EQ(125, header->sections[facesZ].count);
+    const std::uint16_t* faceValues = reinterpret_cast<const std::uint16_t*>(
+            &buf[header->sections[facesZ].offset]);
+    EXPECT_EQ(2, faceValues[(2*5 + 1)*5 + 3]);
+}
+
+TEST_F(ExporterBinaryExporterTest, RLE) {
+    const Mesh::Dense dense(*smb_.mesh->castTo<Mesh::Structured>());
+    Exporter::Binary::Exporter::write(dense, "binaryExporterRLE.bin", rle);
+    const std::vector<char> buf = read("binaryExporterRLE.bin");
+    ASSERT_GE(buf.size(), sizeof(Header));
+    const Header* header = reinterpret_cast<const Header*>(buf.data());
+    EXPECT_EQ(2, header->indexBytes);
+
+    const Section& section = header->sections[cells];
+    const std::uint64_t* ends = reinterpret_cast<const std::uint64_t*>(
+            &buf[section.offset]);
+    const std::uint16_t* values = reinterpret_cast<const std::uint16_t*>(
+            &buf[section.offset + section.count*sizeof(std::uint64_t)]);
+    EXPECT_LT(section.count, 125);
+    EXPECT_EQ(125, ends[section.count-1]);
+    std::size_t n = 0;
+    for (std::size_t r = 0; r < section.count; r++) {
+        if (r > 0) {
+            EXPECT_NE(values[r-1], values[r]);
+        }
+        for (; n < ends[r]; n++) {
+            const CVecI3 ijk(n / 25, n / 5 % 5, n % 5);
+            EXPECT_EQ(dense.getCell(ijk), values[r]);
+        }
+    }
+}
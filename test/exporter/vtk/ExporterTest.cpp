@@ -0,0 +1,147 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+
+#include "exporter/vtk/Exporter.h"
+#include "geometry/mesh/Unstructured.h"
+#include "geometry/element/Triangle3.h"
+#include "physicalModel/predefined/PEC.h"
+
+using namespace SEMBA;
+using namespace Geometry;
+using namespace Math;
+
+class ExporterVTKExporterTest : public ::testing::Test {
+protected:
+    virtual void SetUp() {
+        PhysicalModel::Group<>* mats = new PhysicalModel::Group<>();
+        mats->add(new PhysicalModel::Predefined::PEC(MatId(1), "Copper"));
+        mats->add(new PhysicalModel::Predefined::PEC(MatId(2), "Gold"));
+        mats->add(new PhysicalModel::Predefined::PEC(MatId(3), "Silver"));
+        Layer::Group<> layers;
+        layers.add(new Layer::Layer(LayerId(1), "Plate"));
+
+        // A strip of triangles: four of copper, one of gold and two of
+        // silver.
+        CoordR3Group cG;
+        for (std::size_t i = 0; i < 8; i++) {
+            cG.add(new CoordR3(CoordId(i+1), CVecR3((Real) i, 0.0, 0.0)));
+            cG.add(new CoordR3(CoordId(i+9), CVecR3((Real) i, 1.0, 0.0)));
+        }
+        ElemRGroup eG;
+        for (std::size_t i = 0; i < 7; i++) {
+            const CoordR3* v[3] = {cG.getId(CoordId(i+1)),
+                                   cG.getId(CoordId(i+2)),
+                                   cG.getId(CoordId(i+9))};
+            const MatId matId((i < 4)? 1 : ((i < 5)? 2 : 3));
+            eG.add(new Tri3(ElemId(i+1), v, layers(0), mats->getId(matId)));
+        }
+        smb_.physicalModels = mats;
+        smb_.mesh = new Mesh::Unstructured(cG, eG, layers);
+    }
+
+    static std::string getPart(const std::string& fn,
+                               const std::string& name) {
+        return fn + ".vtk/" + name + "@Plate.vtu";
+    }
+
+    static bool exists(const std::string& filename) {
+        return std::ifstream(filename.c_str()).good();
+    }
+
+    static std::string read(const std::string& filename) {
+        std::ifstream file(filename.c_str());
+        return std::string((std::istreambuf_iterator<char>(file)),
+                           std::istreambuf_iterator<char>());
+    }
+
+    static void removeExport(const std::string& fn) {
+        const char* names[] = {"Copper", "Gold", "Silver"};
+        for (std::size_t i = 0; i < 3; i++) {
+            std::remove(getPart(fn, names[i]).c_str());
+        }
+        std::remove((fn + ".pvd").c_str());
+        std::remove((fn + ".vtk").c_str());
+    }
+
+    // Every part of the incremental export must be as in a full one.
+    void expectSameParts(const std::string& incremental,
+                         const std::string& full) const {
+        for (std::size_t i = 0; i < smb_.physicalModels->size(); i++) {
+            const std::string name = (*smb_.physicalModels)(i)->getName();
+            EXPECT_EQ(exists(getPart(full, name)),
+                      exists(getPart(incremental, name))) << name;
+            EXPECT_EQ(read(getPart(full, name)),
+                      read(getPart(incremental, name))) << name;
+        }
+    }
+
+    Data smb_;
+};
+
+TEST_F(ExporterVTKExporterTest, Incremental) {
+    Mesh::Unstructured* mesh = smb_.mesh->castTo<Mesh::Unstructured>();
+    mesh->coords().startTracking();
+    mesh->elems().startTracking();
+    Exporter::VTK::Exporter(&smb_, "vtkIncremental");
+    const std::string copper = read(getPart("vtkIncremental", "Copper"));
+    const std::string silver = read(getPart("vtkIncremental", "Silver"));
+    ASSERT_TRUE(exists(getPart("vtkIncremental", "Gold")));
+    const Group::Generation generation = Group::getCurrentGeneration();
+
+    // The only element of gold goes to silver.
+    mesh->elems().setModel(ElemId(5),
+                           smb_.physicalModels->getId(MatId(3)));
+    Exporter::VTK::Exporter(&smb_, "vtkIncremental", generation);
+    Exporter::VTK::Exporter(&smb_, "vtkFull");
+
+    EXPECT_FALSE(exists(getPart("vtkIncremental", "Gold")));
+    EXPECT_EQ(copper, read(getPart("vtkIncremental", "Copper")));
+    EXPECT_NE(silver, read(getPart("vtkIncremental", "Silver")));
+    expectSameParts("vtkIncremental", "vtkFull");
+
+    removeExport("vtkIncremental");
+    removeExport("vtkFull");
+}
+
+TEST_F(ExporterVTKExporterTest, IncrementalTruncated) {
+    Mesh::Unstructured* mesh = smb_.mesh->castTo<Mesh::Unstructured>();
+    mesh->coords().startTracking();
+    mesh->elems().startTracking();
+    Exporter::VTK::Exporter(&smb_, "vtkTruncated");
+    const Group::Generation generation = Group::getCurrentGeneration();
+
+    // Without the journal of the change everything is written again.
+    mesh->elems().setModel(ElemId(1),
+                           smb_.physicalModels->getId(MatId(2)));
+    mesh->elems().truncateTracking(Group::getCurrentGeneration());
+    Exporter::VTK::Exporter(&smb_, "vtkTruncated", generation);
+    Exporter::VTK::Exporter(&smb_, "vtkTruncatedFull");
+    expectSameParts("vtkTruncated", "vtkTruncatedFull");
+
+    removeExport("vtkTruncated");
+    removeExport("vtkTruncatedFull");
+}
@@ -0,0 +1,209 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#include "MesherTest.h"
+
+#include <random>
+
+#include "mesher/ConformalCutter.h"
+#include "geometry/element/Triangle3.h"
+#include "geometry/element/Quadrilateral4.h"
+
+using namespace SEMBA;
+using namespace Geometry;
+using namespace Math;
+using namespace Math::Constants;
+
+class MesherConformalCutterTest : public ::testing::Test,
+                                  public MesherTest {
+protected:
+    virtual void SetUp() {
+        MesherTest::SetUp();
+        mat_ = new Element::Model(MatId(2));
+    }
+
+    virtual void TearDown() {
+        delete mat_;
+    }
+
+    Element::Model* mat_;
+};
+
+TEST_F(MesherConformalCutterTest, FlatTriangle) {
+    CoordR3Group cG;
+    cG.add(new CoordR3(CoordId(1), CVecR3(0.5, 0.5, 1.5)));
+    cG.add(new CoordR3(CoordId(2), CVecR3(3.5, 0.5, 1.5)));
+    cG.add(new CoordR3(CoordId(3), CVecR3(0.5, 3.5, 1.5)));
+    const CoordR3* v[3] = {cG(0), cG(1), cG(2)};
+    ElemRGroup eG;
+    eG.add(new Tri3(ElemId(1), v, nullptr, mat_));
+    Mesh::Unstructured mesh(cG, eG);
+
+    std::map<MatId, Mesher::ConformalCutter::Cuts> res =
+        Mesher::ConformalCutter(grid_).cut(mesh);
+    ASSERT_EQ(1, res.size());
+    ASSERT_EQ(1, res.count(MatId(2)));
+    const Mesher::ConformalCutter::Cuts& cuts = res[MatId(2)];
+
+    // Only lines along z cross the triangle, at nodes with i+j <= 4.
+    ASSERT_EQ(6, cuts.coords.size());
+    for (std::size_t i = 0; i < cuts.coords.size(); i++) {
+        const CoordConf* coord = cuts.coords(i);
+        EXPECT_EQ(z, coord->getDir());
+        EXPECT_EQ(0.5, coord->getLength());
+        EXPECT_EQ(1, coord->pos()(z));
+        EXPECT_GE(coord->pos()(x), 1);
+        EXPECT_GE(coord->pos()(y), 1);
+        EXPECT_LE(coord->pos()(x) + coord->pos()(y), 4);
+        CoordR3* pos = coord->toUnstructured(grid_);
+        EXPECT_EQ(CVecR3(coord->pos()(x), coord->pos()(y), 1.5), pos->pos());
+        delete pos;
+    }
+
+    // Neighbouring cuts on the planes x = 1, x = 2, y = 1 and y = 2.
+    ASSERT_EQ(6, cuts.lines.size());
+    for (std::size_t i = 0; i < cuts.lines.size(); i++) {
+        const LinConf* line = cuts.lines(i);
+        EXPECT_EQ(CVecR3(0.0, 0.0, 1.0), line->getNorm());
+        EXPECT_EQ(mat_, line->getModel());
+        const CVecI3 diff = line->getV(1)->pos() - line->getV(0)->pos();
+        EXPECT_EQ(1, std::abs(diff(x)) + std::abs(diff(y)));
+    }
+}
+
+TEST_F(MesherConformalCutterTest, SharedEdgesAndVertexHits) {
+    // Plane z = 0.5 + x/4, split along a diagonal through grid nodes.
+    CoordR3Group cG;
+    cG.add(new CoordR3(CoordId(1), CVecR3(0.0, 0.0, 0.5)));
+    cG.add(new CoordR3(CoordId(2), CVecR3(4.0, 0.0, 1.5)));
+    cG.add(new CoordR3(CoordId(3), CVecR3(4.0, 4.0, 1.5)));
+    cG.add(new CoordR3(CoordId(4), CVecR3(0.0, 4.0, 0.5)));
+    const CoordR3* v[4] = {cG(0), cG(1), cG(2), cG(3)};
+    const CoordR3* v1[3] = {cG(0), cG(1), cG(2)};
+    const CoordR3* v2[3] = {cG(0), cG(2), cG(3)};
+    ElemRGroup tris, quas;
+    tris.add(new Tri3(ElemId(1), v1));
+    tris.add(new Tri3(ElemId(2), v2));
+    quas.add(new QuaR4(ElemId(1), v));
+
+    Mesher::ConformalCutter cutter(grid_);
+    std::map<MatId, Mesher::ConformalCutter::Cuts> fromTris =
+        cutter.cut(Mesh::Unstructured(cG, tris));
+    std::map<MatId, Mesher::ConformalCutter::Cuts> fromQuas =
+        cutter.cut(Mesh::Unstructured(cG, quas));
+    ASSERT_EQ(1, fromTris.count(MatId(0)));
+    ASSERT_EQ(1, fromQuas.count(MatId(0)));
+    const Mesher::ConformalCutter::Cuts& cuts = fromTris[MatId(0)];
+
+    // One cut per line along z, lines along x only add the hits at x = 2.
+    ASSERT_EQ(25, cuts.coords.size());
+    std::size_t onNodes = 0;
+    for (std::size_t i = 0; i < cuts.coords.size(); i++) {
+        const CoordConf* coord = cuts.coords(i);
+        const Int i0 = coord->pos()(x);
+        if (i0 == 2) {
+            EXPECT_EQ(0.0, coord->getLength());
+            EXPECT_EQ(1, coord->pos()(z));
+            onNodes++;
+        } else {
+            EXPECT_EQ(z, coord->getDir());
+            EXPECT_DOUBLE_EQ(0.5 + 0.25*i0,
+                             coord->pos()(z) + coord->getLength());
+        }
+    }
+    EXPECT_EQ(5, onNodes);
+    EXPECT_FALSE(cuts.lines.empty());
+
+    ASSERT_EQ(cuts.coords.size(), fromQuas[MatId(0)].coords.size());
+    ASSERT_EQ(cuts.lines.size(), fromQuas[MatId(0)].lines.size());
+    for (std::size_t i = 0; i < cuts.coords.size(); i++) {
+        EXPECT_EQ(*cuts.coords(i), *fromQuas[MatId(0)].coords(i));
+    }
+}
+
+TEST_F(MesherConformalCutterTest, SharedEdges) {
+    // Pairs of triangles with random heights whose shared edges lie on the
+    // planes x = 0, 2 and 4. Lines along z crossing them must be cut once,
+    // whichever of the triangles sharing the edge finds the hit.
+    std::mt19937 gen(1);
+    std::uniform_real_distribution<Real> dist(0.3, 3.7);
+    for (std::size_t n = 0; n < 100; n++) {
+        CoordR3Group cG;
+        for (std::size_t i = 0; i < 3; i++) {
+            for (std::size_t j = 0; j < 3; j++) {
+                const Real y = (j == 0) ? 0.0 : ((j == 1) ? dist(gen) : 4.0);
+                cG.add(new CoordR3(CoordId(1 + 3*i + j),
+                                   CVecR3(2.0*i, y, dist(gen))));
+            }
+        }
+        ElemRGroup eG;
+        for (std::size_t i = 0; i < 2; i++) {
+            for (std::size_t j = 0; j < 2; j++) {
+                const CoordR3* v1[3] = {cG(3*i + j), cG(3*(i+1) + j),
+                                        cG(3*(i+1) + j+1)};
+                const CoordR3* v2[3] = {cG(3*i + j), cG(3*(i+1) + j+1),
+                                        cG(3*i + j+1)};
+                eG.add(new Tri3(ElemId(eG.size()+1), v1, nullptr, mat_));
+                eG.add(new Tri3(ElemId(eG.size()+1), v2, nullptr, mat_));
+            }
+        }
+
+        std::map<MatId, Mesher::ConformalCutter::Cuts> res =
+            Mesher::ConformalCutter(grid_).cut(Mesh::Unstructured(cG, eG));
+        const Mesher::ConformalCutter::Cuts& cuts = res[MatId(2)];
+        std::map<std::pair<Int, Int>, std::size_t> hits;
+        for (std::size_t i = 0; i < cuts.coords.size(); i++) {
+            const CoordConf* coord = cuts.coords(i);
+            if (coord->getLength() == 0.0 || coord->getDir() == z) {
+                hits[std::make_pair(coord->pos()(x), coord->pos()(y))]++;
+            }
+        }
+        EXPECT_EQ(25, hits.size()) << n;
+        for (std::map<std::pair<Int, Int>, std::size_t>::const_iterator
+             it = hits.begin(); it != hits.end(); ++it) {
+            EXPECT_EQ(1, it->second) << n << ": " << it->first.first << " "
+                                     << it->first.second;
+        }
+    }
+}
+
+TEST_F(MesherConformalCutterTest, Snapping) {
+    CoordR3Group cG;
+    cG.add(new CoordR3(CoordId(1), CVecR3(0.5, 0.5, 2.0 - 1e-9)));
+    cG.add(new CoordR3(CoordId(2), CVecR3(1.5, 0.5, 2.0 - 1e-9)));
+    cG.add(new CoordR3(CoordId(3), CVecR3(0.5, 1.5, 2.0 - 1e-9)));
+    const CoordR3* v[3] = {cG(0), cG(1), cG(2)};
+    ElemRGroup eG;
+    eG.add(new Tri3(ElemId(1), v, nullptr, mat_));
+    Mesh::Unstructured mesh(cG, eG);
+
+    Mesher::ConformalCutter cutter(grid_);
+    std::map<MatId, Mesher::ConformalCutter::Cuts> res = cutter.cut(mesh);
+    ASSERT_EQ(1, res[MatId(2)].coords.size());
+    EXPECT_EQ(CVecI3(1, 1, 2), res[MatId(2)].coords(0)->pos());
+    EXPECT_EQ(0.0, res[MatId(2)].coords(0)->getLength());
+
+    cutter.setTolerance(0.0);
+    res = cutter.cut(mesh);
+    ASSERT_EQ(1, res[MatId(2)].coords.size());
+    EXPECT_EQ(CVecI3(1, 1, 1), res[MatId(2)].coords(0)->pos());
+    EXPECT_GT(res[MatId(2)].coords(0)->getLength(), 0.99);
+}
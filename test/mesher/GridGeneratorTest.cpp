@@ -0,0 +1,90 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#include "gtest/gtest.h"
+
+#include "mesher/GridGenerator.h"
+#include "geometry/element/Hexahedron8.h"
+#include "physicalModel/volume/Classic.h"
+
+using namespace SEMBA;
+using namespace Geometry;
+using namespace Math;
+
+class MesherGridGeneratorTest : public ::testing::Test {
+protected:
+    virtual void SetUp() {
+        // Wavelength in vacuum is 1 m, the dielectric block halves it.
+        frequency_ = Constants::c0;
+        pMG_.add(new PhysicalModel::Volume::Classic(MatId(1), "Die", 4.0));
+
+        CoordR3Group cG;
+        std::vector<ElemR*> elems;
+        elems.push_back(new HexR8(cG, ElemId(1),
+                BoxR3(CVecR3(0.0), CVecR3(2.0))));
+        elems.push_back(new HexR8(cG, ElemId(2),
+                BoxR3(CVecR3(0.83), CVecR3(1.17)),
+                nullptr, pMG_.getId(MatId(1))));
+        mesh_ = Mesh::Unstructured(cG, ElemRGroup(elems));
+    }
+
+    Real frequency_;
+    PMGroup pMG_;
+    Mesh::Unstructured mesh_;
+};
+
+TEST_F(MesherGridGeneratorTest, MaximumStep) {
+    Mesher::GridGenerator gen(frequency_);
+    EXPECT_NEAR(0.1, gen.getMaximumStep(), 1e-12);
+    EXPECT_NEAR(0.05, gen.getMaximumStep(pMG_.getId(MatId(1))), 1e-12);
+    gen.setMaximumStep(MatId(1), 0.02);
+    EXPECT_EQ(0.02, gen.getMaximumStep(pMG_.getId(MatId(1))));
+    EXPECT_THROW(Mesher::GridGenerator(0.0), std::logic_error);
+}
+
+TEST_F(MesherGridGeneratorTest, Graded) {
+    Mesher::GridGenerator gen(frequency_);
+    const Real ratio = gen.getMaximumGrowthRatio();
+    Grid3 grid = gen.generate(mesh_, pMG_);
+
+    for (std::size_t d = 0; d < 3; d++) {
+        const std::vector<Real>& pos = grid.getPos(d);
+        const std::vector<Real>& step = grid.getStep(d);
+        EXPECT_EQ(0.0, pos.front());
+        EXPECT_EQ(2.0, pos.back());
+        EXPECT_NE(pos.end(), std::find(pos.begin(), pos.end(), 0.83));
+        EXPECT_NE(pos.end(), std::find(pos.begin(), pos.end(), 1.17));
+        for (std::size_t i = 0; i < step.size(); i++) {
+            const Real center = pos[i] + step[i]/2.0;
+            if (center > 0.83 && center < 1.17) {
+                EXPECT_GE(0.05 + 1e-9, step[i]);
+            } else {
+                EXPECT_GE(0.1 + 1e-9, step[i]);
+            }
+            if (i > 0) {
+                const Real r = std::max(step[i]/step[i-1], step[i-1]/step[i]);
+                EXPECT_GE(ratio + 0.05, r);
+            }
+        }
+    }
+    // A uniform grid with the finest step needs 40 cells per direction.
+    EXPECT_LT(grid.getNumCells()(0), 40);
+}
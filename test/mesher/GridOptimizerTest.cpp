@@ -0,0 +1,143 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#include "gtest/gtest.h"
+
+#include "mesher/GridOptimizer.h"
+#include "geometry/element/Line2.h"
+
+using namespace SEMBA;
+using namespace Geometry;
+using namespace Math;
+
+class MesherGridOptimizerTest : public ::testing::Test {
+protected:
+    virtual void SetUp() {
+        std::vector<Real> pos[3];
+        pos[0] = {0.0, 1.0, 2.0, 2.05, 3.0, 4.0};
+        pos[1] = {0.0, 1.0, 2.0, 3.0, 4.0};
+        pos[2] = {0.0, 0.01, 1.0, 2.0, 3.0, 4.0};
+        grid_ = Grid3(pos);
+
+        std::vector<CoordR3*> coords;
+        coords.push_back(new CoordR3(CoordId(1), CVecR3(2.0 , 1.0, 1.0)));
+        coords.push_back(new CoordR3(CoordId(2), CVecR3(2.05, 1.0, 1.0)));
+        coords.push_back(new CoordR3(CoordId(3), CVecR3(1.0 , 1.0, 0.01)));
+        CoordR3Group cG(coords);
+        std::vector<ElemR*> elems;
+        const CoordR3* v[2] = {cG.getId(CoordId(1)), cG.getId(CoordId(2))};
+        elems.push_back(new LinR2(ElemId(1), v));
+        mesh_ = Mesh::Geometric(grid_, cG, ElemRGroup(elems));
+    }
+
+    Grid3 grid_;
+    Mesh::Geometric mesh_;
+};
+
+TEST_F(MesherGridOptimizerTest, Merge) {
+    Mesher::GridOptimizer opt(0.25);
+    Mesher::GridOptimizer::Report report = opt.optimize(mesh_);
+
+    EXPECT_EQ(2, report.mergedLines);
+    EXPECT_EQ(std::vector<Real>({0.0, 1.0, 2.025, 3.0, 4.0}),
+              mesh_.grid().getPos(0));
+    EXPECT_EQ(std::vector<Real>({0.0, 1.0, 2.0, 3.0, 4.0}),
+              mesh_.grid().getPos(2));
+    EXPECT_NEAR(0.975, report.minimumStep, 1e-12);
+    EXPECT_NEAR(Mesher::GridOptimizer::getTimeStep(mesh_.grid()) /
+                Mesher::GridOptimizer::getTimeStep(grid_),
+                report.timeStepGain, 1e-12);
+    EXPECT_GT(report.timeStepGain, 10.0);
+    EXPECT_NEAR(0.025, report.maximumDisplacement, 1e-12);
+
+    // Coordinates follow the lines and stay findable by position.
+    const CoordR3* c1 = mesh_.coords().getId(CoordId(1));
+    EXPECT_EQ(c1, mesh_.coords().getPos(CVecR3(2.025, 1.0, 1.0)));
+    EXPECT_EQ(c1, mesh_.elems()(0)->getV(0));
+    EXPECT_EQ(CVecR3(1.0, 1.0, 0.0),
+              mesh_.coords().getId(CoordId(3))->pos());
+}
+
+TEST_F(MesherGridOptimizerTest, NothingToMerge) {
+    Mesher::GridOptimizer opt(0.001);
+    Mesher::GridOptimizer::Report report = opt.optimize(mesh_);
+    EXPECT_EQ(0, report.mergedLines);
+    EXPECT_EQ(1.0, report.timeStepGain);
+    EXPECT_EQ(0.0, report.maximumDisplacement);
+    EXPECT_EQ(grid_.getPos(0), mesh_.grid().getPos(0));
+}
+
+TEST_F(MesherGridOptimizerTest, MergeConsecutive) {
+    std::vector<Real> pos[3];
+    pos[0] = {0.0, 1.0, 1.01, 1.02, 2.0, 3.0};
+    pos[1] = pos[2] = {0.0, 1.0};
+    Mesh::Geometric mesh{Grid3(pos)};
+
+    Mesher::GridOptimizer opt(0.25);
+    EXPECT_EQ(2, opt.optimize(mesh).mergedLines);
+    ASSERT_EQ(4, mesh.grid().getPos(0).size());
+    EXPECT_EQ(0.0, mesh.grid().getPos(0).front());
+    EXPECT_EQ(3.0, mesh.grid().getPos(0).back());
+    EXPECT_NEAR(1.0125, mesh.grid().getPos(0)[1], 1e-12);
+}
+
+TEST_F(MesherGridOptimizerTest, DefaultOptionsKeepUniformGrid) {
+    std::vector<Real> pos[3];
+    for (std::size_t d = 0; d < 3; d++) {
+        for (std::size_t i = 0; i <= 20; i++) {
+            pos[d].push_back(0.1*i);
+        }
+    }
+    Mesh::Geometric mesh{Grid3(pos)};
+
+    Mesher::GridOptimizer opt{Mesher::Options()};
+    EXPECT_EQ(0, opt.optimize(mesh).mergedLines);
+    for (std::size_t d = 0; d < 3; d++) {
+        EXPECT_EQ(pos[d], mesh.grid().getPos(d));
+    }
+}
+
+TEST_F(MesherGridOptimizerTest, DefaultOptionsKeepGradedGrid) {
+    std::vector<Real> pos[3];
+    for (std::size_t d = 0; d < 3; d++) {
+        Real step = 0.1;
+        pos[d].push_back(0.0);
+        for (std::size_t i = 0; i < 20; i++) {
+            pos[d].push_back(pos[d].back() + step);
+            step *= 1.2;
+        }
+    }
+    Mesh::Geometric mesh{Grid3(pos)};
+
+    Mesher::GridOptimizer opt{Mesher::Options()};
+    EXPECT_EQ(0, opt.optimize(mesh).mergedLines);
+    for (std::size_t d = 0; d < 3; d++) {
+        EXPECT_EQ(pos[d], mesh.grid().getPos(d));
+    }
+}
+
+TEST_F(MesherGridOptimizerTest, InvalidMergeRatio) {
+    EXPECT_THROW(Mesher::GridOptimizer(0.0), std::logic_error);
+    EXPECT_THROW(Mesher::GridOptimizer(1.0), std::logic_error);
+    Mesher::Options opts;
+    opts.setMergeRatio(1.5);
+    EXPECT_THROW(Mesher::GridOptimizer{opts}, std::logic_error);
+}
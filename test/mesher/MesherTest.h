@@ -0,0 +1,67 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+#ifndef SRC_APPS_TEST_MESHER_MESHERTEST_H_
+#define SRC_APPS_TEST_MESHER_MESHERTEST_H_
+
+#include "gtest/gtest.h"
+
+#include "geometry/Grid.h"
+#include "geometry/element/Quadrilateral4.h"
+
+// Grid of unit cells spanning [0, 4] along each axis, on which the mesher
+// tests place their geometry.
+class MesherTest {
+public:
+    void SetUp() {
+        grid_ = SEMBA::Geometry::Grid3(
+                SEMBA::Geometry::BoxR3(SEMBA::Math::CVecR3(0.0),
+                                       SEMBA::Math::CVecR3(4.0)),
+                SEMBA::Math::CVecR3(1.0));
+    }
+
+protected:
+    // Square [lo, hi]^2 normal to d at height h, its normal pointing along
+    // d if positive and against it otherwise.
+    static SEMBA::Geometry::QuaR4* newSquare(
+            SEMBA::Geometry::CoordR3Group& cG,
+            const SEMBA::Geometry::ElemId id,
+            const std::size_t d, const SEMBA::Math::Real h,
+            const SEMBA::Math::Real lo, const SEMBA::Math::Real hi,
+            const bool positive,
+            const SEMBA::Geometry::Element::Model* model = nullptr) {
+        const SEMBA::Math::Real corners[4][2] =
+            {{lo, lo}, {hi, lo}, {hi, hi}, {lo, hi}};
+        const SEMBA::Geometry::CoordR3* v[4];
+        for (std::size_t i = 0; i < 4; i++) {
+            const std::size_t k = positive ? i : (4-i)%4;
+            SEMBA::Math::CVecR3 pos;
+            pos(d) = h;
+            pos((d+1)%3) = corners[k][0];
+            pos((d+2)%3) = corners[k][1];
+            v[i] = cG.addPos(pos);
+        }
+        return new SEMBA::Geometry::QuaR4(id, v, nullptr, model);
+    }
+
+    SEMBA::Geometry::Grid3 grid_;
+};
+
+#endif /* SRC_APPS_TEST_MESHER_MESHERTEST_H_ */
@@ -0,0 +1,140 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#include "MesherTest.h"
+
+#include "mesher/OverlapResolver.h"
+#include "geometry/element/Quadrilateral4.h"
+#include "geometry/element/Hexahedron8.h"
+#include "physicalModel/predefined/PEC.h"
+#include "physicalModel/volume/Classic.h"
+
+using namespace SEMBA;
+using namespace Geometry;
+using namespace Math;
+
+class MesherOverlapResolverTest : public ::testing::Test,
+                                  public MesherTest {
+protected:
+    virtual void SetUp() {
+        MesherTest::SetUp();
+        pec_ = new PhysicalModel::Predefined::PEC(MatId(1));
+        die_ = new PhysicalModel::Volume::Classic(MatId(2), "Die", 4.0);
+
+        CoordI3Group cG;
+        std::vector<ElemI*> elems;
+        elems.push_back(new HexI8(cG, ElemId(1),
+                BoxI3(CVecI3(0,0,0), CVecI3(2,2,2)), nullptr, die_));
+        elems.push_back(new HexI8(cG, ElemId(2),
+                BoxI3(CVecI3(1,1,1), CVecI3(2,2,2)), nullptr, pec_));
+        elems.push_back(new QuaI4(cG, ElemId(3),
+                BoxI3(CVecI3(0,0,3), CVecI3(2,2,3))));
+        elems.push_back(new QuaI4(cG, ElemId(4),
+                BoxI3(CVecI3(1,1,3), CVecI3(2,2,3)), nullptr, pec_));
+        mesh_ = new Mesh::Structured(grid_, cG, ElemIGroup(elems));
+    }
+
+    virtual void TearDown() {
+        delete mesh_;
+        delete pec_;
+        delete die_;
+    }
+
+    // Number of elements of each kind covering each slot.
+    std::map<std::pair<std::size_t, CVecI3>, std::size_t> getSlots() const {
+        std::map<std::pair<std::size_t, CVecI3>, std::size_t> res;
+        for (std::size_t i = 0; i < mesh_->elems().size(); i++) {
+            const ElemI* elem = mesh_->elems()(i);
+            const BoxI3 box = elem->getBound();
+            EXPECT_EQ(elem->is<HexI8>() ? 1 : 0,
+                      (box.getMax() - box.getMin())(2));
+            res[std::make_pair(elem->numberOfCoordinates(),
+                               box.getMin())]++;
+        }
+        return res;
+    }
+
+    Element::Model* pec_;
+    Element::Model* die_;
+    Mesh::Structured* mesh_;
+};
+
+TEST_F(MesherOverlapResolverTest, Categories) {
+    Mesher::OverlapResolver resolver;
+    EXPECT_EQ(Mesher::OverlapResolver::Category::pec,
+              Mesher::OverlapResolver::getCategory(pec_));
+    EXPECT_EQ(Mesher::OverlapResolver::Category::volume,
+              Mesher::OverlapResolver::getCategory(die_));
+    EXPECT_EQ(Mesher::OverlapResolver::Category::other,
+              Mesher::OverlapResolver::getCategory(nullptr));
+    EXPECT_GT(resolver.getPriority(pec_), resolver.getPriority(die_));
+    resolver.setPriority(MatId(2), 10);
+    EXPECT_LT(resolver.getPriority(pec_), resolver.getPriority(die_));
+}
+
+TEST_F(MesherOverlapResolverTest, Split) {
+    Mesher::OverlapResolver::Report report =
+        Mesher::OverlapResolver().resolve(*mesh_);
+
+    EXPECT_EQ(0, report.getRemovedElements());
+    EXPECT_EQ(2, report.getSplitElements());
+    ASSERT_EQ(2, report.overlaps().size());
+    EXPECT_EQ(ElemId(1), report.overlaps()[0].dropped);
+    EXPECT_EQ(MatId(2), report.overlaps()[0].droppedMatId);
+    EXPECT_EQ(ElemId(2), report.overlaps()[0].kept);
+    EXPECT_EQ(MatId(1), report.overlaps()[0].keptMatId);
+    EXPECT_EQ(1, report.overlaps()[0].slots);
+    EXPECT_EQ(ElemId(3), report.overlaps()[1].dropped);
+    EXPECT_EQ(ElemId(4), report.overlaps()[1].kept);
+
+    // Seven unit hexahedra and three unit quadrilaterals replace the split
+    // elements, every slot is used once.
+    EXPECT_EQ(12, mesh_->elems().size());
+    const std::map<std::pair<std::size_t, CVecI3>, std::size_t> slots =
+        getSlots();
+    EXPECT_EQ(12, slots.size());
+    EXPECT_EQ(pec_, mesh_->elems().getId(ElemId(2))->getModel());
+    EXPECT_EQ(pec_, mesh_->elems().getId(ElemId(4))->getModel());
+    EXPECT_FALSE(mesh_->elems().existId(ElemId(1)));
+    EXPECT_FALSE(mesh_->elems().existId(ElemId(3)));
+    for (std::size_t i = 0; i < mesh_->elems().size(); i++) {
+        const ElemI* elem = mesh_->elems()(i);
+        if (elem->is<HexI8>() && elem->getId() != ElemId(2)) {
+            EXPECT_EQ(die_, elem->getModel());
+        }
+    }
+
+    // Nothing left to resolve.
+    EXPECT_TRUE(Mesher::OverlapResolver().resolve(*mesh_).empty());
+}
+
+TEST_F(MesherOverlapResolverTest, Priority) {
+    Mesher::OverlapResolver resolver;
+    resolver.setPriority(MatId(2), 10);
+    resolver.setPriority(Mesher::OverlapResolver::Category::other, 20);
+    Mesher::OverlapResolver::Report report = resolver.resolve(*mesh_);
+
+    EXPECT_EQ(2, report.getRemovedElements());
+    EXPECT_EQ(0, report.getSplitElements());
+    EXPECT_EQ(2, mesh_->elems().size());
+    EXPECT_TRUE(mesh_->elems().existId(ElemId(1)));
+    EXPECT_TRUE(mesh_->elems().existId(ElemId(3)));
+}
@@ -0,0 +1,159 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#include "MesherTest.h"
+
+#include "mesher/StaircaseMesher.h"
+#include "geometry/element/Line2.h"
+#include "geometry/element/Quadrilateral4.h"
+#include "geometry/element/Triangle3.h"
+
+using namespace SEMBA;
+using namespace Geometry;
+using namespace Math;
+
+class MesherStaircaseMesherTest : public ::testing::Test,
+                                  public MesherTest {
+protected:
+    virtual void SetUp() {
+        MesherTest::SetUp();
+    }
+
+    void addSquare(const std::size_t d, const Real h,
+                   const Real lo, const Real hi, const bool positive) {
+        elems_.add(newSquare(coords_, ElemId(elems_.size()+1),
+                             d, h, lo, hi, positive));
+    }
+
+    Mesh::Geometric getMesh() {
+        return Mesh::Geometric(grid_, coords_, elems_);
+    }
+
+    CoordR3Group coords_;
+    ElemRGroup elems_;
+};
+
+TEST_F(MesherStaircaseMesherTest, Box) {
+    for (std::size_t d = 0; d < 3; d++) {
+        addSquare(d, 0.6, 0.6, 3.4, false);
+        addSquare(d, 3.4, 0.6, 3.4, true);
+    }
+    Mesher::Options opts;
+    Mesh::Structured* res = Mesher::StaircaseMesher(opts).mesh(getMesh());
+
+    // The box becomes [1,3]^3, four faces per side.
+    EXPECT_EQ(26, res->coords().size());
+    ASSERT_EQ(24, res->elems().size());
+    for (std::size_t i = 0; i < res->elems().size(); i++) {
+        ASSERT_TRUE(res->elems()(i)->is<QuaI4>());
+        CVecR3 v[4];
+        for (std::size_t j = 0; j < 4; j++) {
+            const CVecI3 pos = res->elems()(i)->getVertex(j)->pos();
+            v[j] = CVecR3(pos(0), pos(1), pos(2));
+            for (std::size_t d = 0; d < 3; d++) {
+                EXPECT_GE(pos(d), 1);
+                EXPECT_LE(pos(d), 3);
+            }
+        }
+        const CVecR3 normal = (v[1] - v[0]) ^ (v[3] - v[0]);
+        const CVecR3 centre = (v[0] + v[2]) / 2.0;
+        EXPECT_GT(normal.dot(centre - CVecR3(2.0)), 0.0);
+    }
+    delete res;
+}
+
+TEST_F(MesherStaircaseMesherTest, Line) {
+    const CoordR3* v[2] = {coords_.addPos(CVecR3(0.1, 0.2, 0.1)),
+                           coords_.addPos(CVecR3(2.9, 1.1, 0.2))};
+    elems_.add(new LinR2(ElemId(1), v));
+    Mesher::Options opts;
+    Mesh::Structured* res = Mesher::StaircaseMesher(opts).mesh(getMesh());
+
+    ASSERT_EQ(4, res->elems().size());
+    std::size_t alongX = 0;
+    for (std::size_t i = 0; i < res->elems().size(); i++) {
+        ASSERT_TRUE(res->elems()(i)->is<LinI2>());
+        const CVecI3 diff = res->elems()(i)->getVertex(1)->pos() -
+                            res->elems()(i)->getVertex(0)->pos();
+        EXPECT_EQ(1, diff(0) + diff(1) + diff(2));
+        alongX += diff(0);
+    }
+    EXPECT_EQ(3, alongX);
+    EXPECT_NE(nullptr, res->coords().getPos(CVecI3(0, 0, 0)));
+    EXPECT_NE(nullptr, res->coords().getPos(CVecI3(3, 1, 0)));
+    delete res;
+}
+
+TEST_F(MesherStaircaseMesherTest, Snap) {
+    addSquare(2, -0.01, 0.0, 4.0, true);
+    Mesher::Options opts;
+    opts.setForbiddenLength(0.1);
+    Mesh::Structured* res = Mesher::StaircaseMesher(opts).mesh(getMesh());
+    EXPECT_EQ(0, res->elems().size());
+    delete res;
+
+    opts.setSnap(true);
+    res = Mesher::StaircaseMesher(opts).mesh(getMesh());
+    EXPECT_EQ(16, res->elems().size());
+    EXPECT_EQ(25, res->coords().size());
+    delete res;
+}
+
+TEST_F(MesherStaircaseMesherTest, SnapDefaultOptions) {
+    // A slanted triangle whose coordinates are all far from grid planes.
+    const CoordR3* v[3] = {coords_.addPos(CVecR3(0.6, 0.6, 1.4)),
+                           coords_.addPos(CVecR3(3.4, 0.7, 1.6)),
+                           coords_.addPos(CVecR3(0.7, 3.4, 2.6))};
+    elems_.add(new Tri3(ElemId(1), v));
+    Mesher::Options opts;
+    Mesh::Structured* expected =
+        Mesher::StaircaseMesher(opts).mesh(getMesh());
+
+    // The default forbidden length must not move them.
+    opts.setSnap(true);
+    const Mesher::StaircaseMesher mesher(opts);
+    EXPECT_EQ(0.25, mesher.getForbiddenLength());
+    Mesh::Structured* res = mesher.mesh(getMesh());
+    ASSERT_FALSE(expected->elems().empty());
+    ASSERT_EQ(expected->elems().size(), res->elems().size());
+    for (std::size_t i = 0; i < res->elems().size(); i++) {
+        for (std::size_t j = 0; j < 4; j++) {
+            EXPECT_EQ(expected->elems()(i)->getVertex(j)->pos(),
+                      res->elems()(i)->getVertex(j)->pos());
+        }
+    }
+    delete expected;
+    delete res;
+}
+
+TEST_F(MesherStaircaseMesherTest, UnsupportedMode) {
+    Mesher::Options opts;
+    opts.setMode(Mesher::Options::Mode::conformal);
+    EXPECT_THROW(Mesher::StaircaseMesher mesher(opts), std::logic_error);
+}
+
+TEST_F(MesherStaircaseMesherTest, InvalidForbiddenLength) {
+    Mesher::Options opts;
+    opts.setForbiddenLength(0.5);
+    EXPECT_THROW(Mesher::StaircaseMesher mesher(opts), std::logic_error);
+    opts.setForbiddenLength(-0.1);
+    EXPECT_THROW(Mesher::StaircaseMesher mesher(opts), std::logic_error);
+}
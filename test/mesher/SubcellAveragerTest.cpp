@@ -0,0 +1,126 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#include "MesherTest.h"
+
+#include "mesher/SubcellAverager.h"
+#include "geometry/element/Quadrilateral4.h"
+#include "geometry/element/Hexahedron8.h"
+#include "physicalModel/volume/Classic.h"
+#include "physicalModel/volume/AnisotropicTensor.h"
+
+using namespace SEMBA;
+using namespace Geometry;
+using namespace Math;
+
+class MesherSubcellAveragerTest : public ::testing::Test,
+                                  public MesherTest {
+protected:
+    virtual void SetUp() {
+        MesherTest::SetUp();
+        models_.add(new PhysicalModel::Volume::Classic(MatId(1), "Die", 4.0));
+
+        // Closed surface of the box [0.5,2.5]^3, oriented outwards.
+        CoordR3Group cG;
+        std::vector<ElemR*> elems;
+        for (std::size_t d = 0; d < 3; d++) {
+            elems.push_back(newSquare(cG, ElemId(elems.size()+1),
+                                      d, 0.5, 0.5, 2.5, false, models_(0)));
+            elems.push_back(newSquare(cG, ElemId(elems.size()+1),
+                                      d, 2.5, 0.5, 2.5, true, models_(0)));
+        }
+        mesh_ = Mesh::Geometric(grid_, cG, ElemRGroup(elems));
+    }
+
+    PhysicalModel::Group<> models_;
+    Mesh::Geometric mesh_;
+};
+
+TEST_F(MesherSubcellAveragerTest, Fills) {
+    const std::vector<Mesher::SubcellAverager::Fill> fills =
+        Mesher::SubcellAverager().getFills(mesh_);
+
+    // Every cell touched by the box but the central one is cut.
+    ASSERT_EQ(26, fills.size());
+    for (std::size_t f = 0; f < fills.size(); f++) {
+        const CVecI3& cell = fills[f].cell;
+        Real expected = 1.0;
+        CVecR3 normal;
+        for (std::size_t d = 0; d < 3; d++) {
+            EXPECT_LE(cell(d), 2);
+            if (cell(d) != 1) {
+                expected *= 0.5;
+                normal(d) = (cell(d) == 0) ? -1.0 : 1.0;
+            }
+        }
+        ASSERT_EQ(1, fills[f].fractions.size());
+        EXPECT_EQ(MatId(1), fills[f].fractions[0].first);
+        EXPECT_NEAR(expected, fills[f].fractions[0].second, 1e-12);
+        normal.normalize();
+        for (std::size_t d = 0; d < 3; d++) {
+            EXPECT_NEAR(normal(d), fills[f].normal(d), 1e-12);
+        }
+        if (f > 0) {
+            EXPECT_LT(fills[f-1].cell, cell);
+        }
+    }
+}
+
+TEST_F(MesherSubcellAveragerTest, Average) {
+    Mesher::Options opts;
+    opts.setSubgridPoints(8);
+    Mesher::SubcellAverager averager(opts);
+    EXPECT_EQ(8, averager.getSamples());
+    Mesh::Structured* res = averager.average(mesh_, models_);
+
+    ASSERT_EQ(26, res->elems().size());
+    // Media differ by the axes of the interfaces: 3 faces, 6 edges and 4
+    // corners.
+    EXPECT_EQ(1 + 13, models_.size());
+    for (std::size_t i = 0; i < res->elems().size(); i++) {
+        const ElemI* elem = res->elems()(i);
+        ASSERT_TRUE(elem->is<HexI8>());
+        ASSERT_NE(nullptr, elem->getModel());
+        EXPECT_NE(MatId(1), elem->getMatId());
+        EXPECT_TRUE(models_.existId(elem->getMatId()));
+    }
+
+    // Half filled cell below the x = 0.5 face.
+    const ElemI* face = nullptr;
+    for (std::size_t i = 0; i < res->elems().size(); i++) {
+        if (res->elems()(i)->getBound().getMin() == CVecI3(0, 1, 1)) {
+            face = res->elems()(i);
+        }
+    }
+    ASSERT_NE(nullptr, face);
+    const PhysicalModel::Volume::AnisotropicTensor* medium =
+        dynamic_cast<const PhysicalModel::Volume::AnisotropicTensor*>(
+                face->getModel());
+    ASSERT_NE(nullptr, medium);
+    const MatR33 eps = medium->getRelPermittivityMatR();
+    EXPECT_NEAR(1.0/(0.5/4.0 + 0.5/1.0), eps(0,0), 1e-12);
+    EXPECT_NEAR(0.5*4.0 + 0.5*1.0, eps(1,1), 1e-12);
+    EXPECT_NEAR(0.5*4.0 + 0.5*1.0, eps(2,2), 1e-12);
+    EXPECT_NEAR(0.0, eps(0,1), 1e-12);
+    EXPECT_NEAR(1.0, medium->getRelPermeabilityMatR()(0,0), 1e-12);
+    EXPECT_NEAR(0.0, medium->getElectricConductivityMat()(1,1), 1e-12);
+    delete res;
+}
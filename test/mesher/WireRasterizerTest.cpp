@@ -0,0 +1,153 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#include "gtest/gtest.h"
+
+#include "mesher/WireRasterizer.h"
+#include "geometry/element/Line2.h"
+#include "physicalModel/wire/Wire.h"
+
+using namespace SEMBA;
+using namespace Geometry;
+using namespace Math;
+
+class MesherWireRasterizerTest : public ::testing::Test {
+protected:
+    virtual void SetUp() {
+        std::vector<Real> pos[3];
+        pos[0] = {0.0, 1.0, 2.0, 4.0, 8.0};
+        pos[1] = {0.0, 1.0, 2.0, 3.0, 4.0};
+        pos[2] = {0.0, 1.0, 2.0, 3.0, 4.0};
+        grid_ = Grid3(pos);
+        wire_ = new PhysicalModel::Wire::Wire(MatId(1), "Wire",
+                                              1e-3, 0.0, 0.0);
+    }
+
+    virtual void TearDown() {
+        delete wire_;
+    }
+
+    void addLine(const CVecR3& a, const CVecR3& b,
+                 const Element::Model* model) {
+        const CoordR3* v[2] = {coords_.addPos(a), coords_.addPos(b)};
+        elems_.add(new LinR2(ElemId(elems_.size()+1), v, nullptr, model));
+    }
+
+    Mesh::Geometric getMesh() const {
+        return Mesh::Geometric(grid_, coords_, elems_);
+    }
+
+    static void expectContiguous(const Mesher::WireRasterizer::Wire& wire) {
+        ASSERT_EQ(wire.nodes.size(), wire.lengths.size() + 1);
+        Real sum = 0.0;
+        for (std::size_t i = 0; i < wire.lengths.size(); i++) {
+            const CVecI3 diff = wire.nodes[i+1] - wire.nodes[i];
+            EXPECT_EQ(1, std::abs(diff(0)) + std::abs(diff(1)) +
+                         std::abs(diff(2)));
+            EXPECT_GE(wire.lengths[i], 0.0);
+            sum += wire.lengths[i];
+        }
+        EXPECT_NEAR(wire.length, sum, 1e-12);
+    }
+
+    Grid3 grid_;
+    Element::Model* wire_;
+    CoordR3Group coords_;
+    ElemRGroup elems_;
+};
+
+TEST_F(MesherWireRasterizerTest, Junction) {
+    const CVecR3 junction(3.9, 2.2, 0.1);
+    addLine(CVecR3(0.1, 0.1, 0.1), junction, wire_);
+    addLine(junction, CVecR3(3.9, 2.2, 3.2), wire_);
+    addLine(CVecR3(7.5, 2.2, 0.1), junction, wire_);
+    addLine(CVecR3(0.0, 4.0, 4.0), CVecR3(8.0, 4.0, 4.0), nullptr);
+
+    const std::vector<Mesher::WireRasterizer::Wire> wires =
+        Mesher::WireRasterizer().getWires(getMesh());
+    ASSERT_EQ(3, wires.size());
+    Real total = 0.0;
+    for (std::size_t w = 0; w < wires.size(); w++) {
+        EXPECT_EQ(wire_, wires[w].model);
+        EXPECT_FALSE(wires[w].closed);
+        ASSERT_EQ(1, wires[w].elems.size());
+        expectContiguous(wires[w]);
+        total += wires[w].length;
+    }
+    // Orientation of the elements is kept, extremes and the junction map
+    // to their nearest nodes.
+    EXPECT_EQ(ElemId(1), wires[0].elems[0]);
+    EXPECT_EQ(CVecI3(0, 0, 0), wires[0].nodes.front());
+    EXPECT_EQ(CVecI3(3, 2, 0), wires[0].nodes.back());
+    EXPECT_EQ(CVecI3(3, 2, 0), wires[1].nodes.front());
+    EXPECT_EQ(CVecI3(3, 2, 3), wires[1].nodes.back());
+    EXPECT_EQ(ElemId(3), wires[2].elems[0]);
+    EXPECT_EQ(CVecI3(4, 2, 0), wires[2].nodes.front());
+    EXPECT_EQ(CVecI3(3, 2, 0), wires[2].nodes.back());
+
+    Mesh::Structured* res =
+        Mesher::WireRasterizer::getMeshStructured(grid_, wires);
+    std::size_t edges = 0;
+    for (std::size_t w = 0; w < wires.size(); w++) {
+        edges += wires[w].lengths.size();
+    }
+    EXPECT_EQ(edges, res->elems().size());
+    for (std::size_t i = 0; i < res->elems().size(); i++) {
+        EXPECT_TRUE(res->elems()(i)->is<LinI2>());
+        EXPECT_EQ(wire_, res->elems()(i)->getModel());
+    }
+    EXPECT_EQ(1, res->coords().getAllInPos(CVecI3(3, 2, 0)).size());
+    delete res;
+}
+
+TEST_F(MesherWireRasterizerTest, Polyline) {
+    const CVecR3 p[4] = {CVecR3(0.2, 0.2, 1.0), CVecR3(5.0, 0.2, 1.0),
+                         CVecR3(5.0, 3.4, 1.0), CVecR3(0.2, 3.4, 1.0)};
+    for (std::size_t i = 0; i < 4; i++) {
+        addLine(p[i], p[(i+1)%4], wire_);
+    }
+    std::vector<Mesher::WireRasterizer::Wire> wires =
+        Mesher::WireRasterizer().getWires(getMesh());
+    ASSERT_EQ(1, wires.size());
+    EXPECT_TRUE(wires[0].closed);
+    EXPECT_EQ(4, wires[0].elems.size());
+    EXPECT_NEAR(2*(4.8 + 3.2), wires[0].length, 1e-12);
+    expectContiguous(wires[0]);
+    EXPECT_EQ(wires[0].nodes.front(), wires[0].nodes.back());
+
+    // Open polyline broken where the model changes.
+    elems_.clear();
+    coords_.clear();
+    Element::Model* other =
+        new PhysicalModel::Wire::Wire(MatId(2), "Other", 1e-3, 0.0, 0.0);
+    addLine(p[0], p[1], wire_);
+    addLine(p[1], p[2], wire_);
+    addLine(p[2], p[3], other);
+    wires = Mesher::WireRasterizer().getWires(getMesh());
+    ASSERT_EQ(2, wires.size());
+    EXPECT_EQ(2, wires[0].elems.size());
+    EXPECT_EQ(CVecI3(0, 0, 1), wires[0].nodes.front());
+    EXPECT_EQ(wires[0].nodes.back(), wires[1].nodes.front());
+    EXPECT_EQ(other, wires[1].model);
+    expectContiguous(wires[0]);
+    expectContiguous(wires[1]);
+    delete other;
+}
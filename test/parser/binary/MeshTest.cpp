@@ -0,0 +1,252 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#include "parser/binary/MeshReader.h"
+#include "parser/binary/MeshWriter.h"
+#include "geometry/mesh/Geometric.h"
+#include "geometry/element/Node.h"
+#include "geometry/element/Line2.h"
+#include "geometry/element/Triangle3.h"
+#include "geometry/element/Tetrahedron4.h"
+#include "physicalModel/predefined/PEC.h"
+#include "physicalModel/volume/Classic.h"
+
+using namespace SEMBA;
+using namespace Geometry;
+using namespace Math;
+using namespace Parser::Binary;
+using SEMBA::Parser::LoadOptions;
+
+class ParserBinaryMeshTest : public ::testing::Test {
+protected:
+    virtual void SetUp() {
+        models_.add(new PhysicalModel::Predefined::PEC(MatId(1)));
+        models_.add(new PhysicalModel::Volume::Classic(MatId(2), "Die", 4.0));
+
+        std::vector<Real> pos[3];
+        for (std::size_t d = 0; d < 3; d++) {
+            pos[d] = {0.0, 0.5, 1.0};
+        }
+        mesh_ = new Mesh::Geometric(Grid3(pos));
+        std::vector<CoordR3*> coords;
+        coords.push_back(new CoordR3(CoordId(10), CVecR3(0.0, 0.0, 0.0)));
+        coords.push_back(new CoordR3(CoordId(11), CVecR3(1.0, 0.0, 0.0)));
+        coords.push_back(new CoordR3(CoordId(12), CVecR3(0.0, 1.0, 0.0)));
+        coords.push_back(new CoordR3(CoordId(13), CVecR3(0.0, 0.0, 1.5)));
+        mesh_->coords().add(coords);
+        std::vector<Layer::Layer*> layers;
+        layers.push_back(new Layer::Layer(LayerId(1), "Body"));
+        layers.push_back(new Layer::Layer(LayerId(4), "Port"));
+        mesh_->layers().add(layers);
+
+        const CoordR3* v[4] = {coords[0], coords[1], coords[2], coords[3]};
+        std::vector<ElemR*> elems;
+        elems.push_back(new Tet4(ElemId(1), v, layers[0],
+                                 models_.getId(MatId(2))));
+        elems.push_back(new Tri3(ElemId(2), v, layers[0],
+                                 models_.getId(MatId(1))));
+        elems.push_back(new NodR(ElemId(3), &v[3], layers[1]));
+        elems.push_back(new LinR2(ElemId(4), &v[2]));
+        elems.push_back(new Tri3(ElemId(5), &v[1], layers[1],
+                                 models_.getId(MatId(1))));
+        mesh_->elems().add(elems);
+    }
+
+    virtual void TearDown() {
+        delete mesh_;
+    }
+
+    PhysicalModel::Group<> models_;
+    Mesh::Geometric* mesh_;
+};
+
+TEST_F(ParserBinaryMeshTest, RoundTrip) {
+    MeshWriter::write(*mesh_, "binaryMeshRoundTrip.smbmesh");
+    const MeshReader reader("binaryMeshRoundTrip.smbmesh");
+    EXPECT_EQ(4, reader.count(coordIds));
+    EXPECT_EQ(1.5, reader.get<double>(coordPos)[11]);
+    EXPECT_EQ(2, reader.count(getMeshSection(triangle3, elemIds)));
+    EXPECT_EQ(5, reader.get<std::uint64_t>(
+            getMeshSection(triangle3, elemIds))[1]);
+
+    Mesh::Unstructured* read = reader.read(models_);
+    std::remove("binaryMeshRoundTrip.smbmesh");
+    ASSERT_TRUE(read->is<Mesh::Geometric>());
+    EXPECT_EQ(mesh_->grid().getPos(), read->castTo<Mesh::Geometric>()->
+                                          grid().getPos());
+    ASSERT_EQ(mesh_->coords().size(), read->coords().size());
+    for (std::size_t i = 0; i < mesh_->coords().size(); i++) {
+        EXPECT_EQ(mesh_->coords()(i)->getId(), read->coords()(i)->getId());
+        EXPECT_EQ(mesh_->coords()(i)->pos(), read->coords()(i)->pos());
+    }
+    ASSERT_EQ(mesh_->layers().size(), read->layers().size());
+    EXPECT_EQ("Port", read->layers()(1)->getName());
+    ASSERT_EQ(mesh_->elems().size(), read->elems().size());
+    for (std::size_t e = 0; e < mesh_->elems().size(); e++) {
+        const ElemR* expected = mesh_->elems()(e);
+        const ElemR* actual = read->elems()(e);
+        EXPECT_EQ(typeid(*expected), typeid(*actual));
+        EXPECT_EQ(expected->getId(), actual->getId());
+        EXPECT_EQ(expected->getMatId(), actual->getMatId());
+        EXPECT_EQ(expected->getLayerId(), actual->getLayerId());
+        ASSERT_EQ(expected->numberOfCoordinates(),
+                  actual->numberOfCoordinates());
+        for (std::size_t v = 0; v < expected->numberOfCoordinates(); v++) {
+            EXPECT_EQ(expected->getV(v)->getId(), actual->getV(v)->getId());
+            EXPECT_EQ(read->coords().getId(actual->getV(v)->getId()),
+                      actual->getV(v));
+        }
+    }
+    delete read;
+}
+
+TEST_F(ParserBinaryMeshTest, Corrupt) {
+    MeshWriter::write(*mesh_, "binaryMeshCorrupt.smbmesh");
+    std::vector<char> buf;
+    {
+        std::ifstream file("binaryMeshCorrupt.smbmesh", std::ios::binary);
+        buf.assign(std::istreambuf_iterator<char>(file),
+                   std::istreambuf_iterator<char>());
+    }
+    {
+        std::ofstream file("binaryMeshCorrupt.smbmesh", std::ios::binary);
+        file.write(buf.data(), buf.size() - 8);
+    }
+    EXPECT_THROW(MeshReader("binaryMeshCorrupt.smbmesh"), std::logic_error);
+
+    const MeshHeader* header = reinterpret_cast<const MeshHeader*>(&buf[0]);
+    std::uint32_t* vertices = reinterpret_cast<std::uint32_t*>(&buf[
+            header->sections[getMeshSection(tetrahedron4, elemVertices)].
+                offset]);
+    vertices[2] = 7;
+    {
+        std::ofstream file("binaryMeshCorrupt.smbmesh", std::ios::binary);
+        file.write(buf.data(), buf.size());
+    }
+    {
+        const MeshReader reader("binaryMeshCorrupt.smbmesh");
+        EXPECT_THROW(reader.read(models_), std::logic_error);
+    }
+
+    buf[0] = 'X';
+    {
+        std::ofstream file("binaryMeshCorrupt.smbmesh", std::ios::binary);
+        file.write(buf.data(), buf.size());
+    }
+    EXPECT_THROW(MeshReader("binaryMeshCorrupt.smbmesh"), std::logic_error);
+    std::remove("binaryMeshCorrupt.smbmesh");
+}
+
+TEST_F(ParserBinaryMeshTest, CorruptTypes) {
+    MeshWriter::write(*mesh_, "binaryMeshCorruptTypes.smbmesh");
+    std::vector<char> buf;
+    {
+        std::ifstream file("binaryMeshCorruptTypes.smbmesh",
+                           std::ios::binary);
+        buf.assign(std::istreambuf_iterator<char>(file),
+                   std::istreambuf_iterator<char>());
+    }
+    const MeshHeader* header = reinterpret_cast<const MeshHeader*>(&buf[0]);
+    buf[header->sections[elemTypes].offset] = (char) numElementTypes;
+    {
+        std::ofstream file("binaryMeshCorruptTypes.smbmesh",
+                           std::ios::binary);
+        file.write(buf.data(), buf.size());
+    }
+    // Element types are only checked when elements are read.
+    const MeshReader reader("binaryMeshCorruptTypes.smbmesh");
+    EXPECT_THROW(reader.read(models_), std::logic_error);
+    Mesh::Unstructured* read = nullptr;
+    EXPECT_NO_THROW(read = reader.read(models_,
+            LoadOptions(LoadOptions::coordinates | LoadOptions::layers)));
+    delete read;
+    std::remove("binaryMeshCorruptTypes.smbmesh");
+}
+
+TEST_F(ParserBinaryMeshTest, LargeIds) {
+    const std::size_t largeId = 0x100000001ULL;
+    models_.add(new PhysicalModel::Volume::Classic(MatId(largeId), "Far",
+                                                   2.0));
+    const CoordR3* v[3] = {mesh_->coords()(0), mesh_->coords()(1),
+                           mesh_->coords()(2)};
+    mesh_->elems().add(new Tri3(ElemId(6), v, mesh_->layers()(0),
+                                models_.getId(MatId(largeId))));
+    std::stringstream stream;
+    EXPECT_THROW(MeshWriter::write(*mesh_, stream), std::logic_error);
+}
+
+TEST_F(ParserBinaryMeshTest, FirstError) {
+    MeshWriter::write(*mesh_, "binaryMeshFirstError.smbmesh");
+    std::vector<char> buf;
+    {
+        std::ifstream file("binaryMeshFirstError.smbmesh", std::ios::binary);
+        buf.assign(std::istreambuf_iterator<char>(file),
+                   std::istreambuf_iterator<char>());
+    }
+    const MeshHeader* header = reinterpret_cast<const MeshHeader*>(&buf[0]);
+    std::uint32_t* vertices = reinterpret_cast<std::uint32_t*>(&buf[
+            header->sections[getMeshSection(triangle3, elemVertices)].
+                offset]);
+    vertices[0] = 7;
+    vertices[3] = 7;
+    {
+        std::ofstream file("binaryMeshFirstError.smbmesh", std::ios::binary);
+        file.write(buf.data(), buf.size());
+    }
+    const MeshReader reader("binaryMeshFirstError.smbmesh");
+    try {
+        delete reader.read(models_);
+        ADD_FAILURE() << "Wrong vertices were not detected.";
+    } catch (const std::logic_error& e) {
+        EXPECT_STREQ("Binary mesh element 2 has a wrong vertex.", e.what());
+    }
+    std::remove("binaryMeshFirstError.smbmesh");
+}
+
+TEST_F(ParserBinaryMeshTest, Selective) {
+    MeshWriter::write(*mesh_, "binaryMeshSelective.smbmesh");
+    const MeshReader reader("binaryMeshSelective.smbmesh");
+
+    LoadOptions port;
+    port.setLayers({4});
+    Mesh::Unstructured* read = reader.read(models_, port);
+    ASSERT_EQ(2, read->elems().size());
+    EXPECT_EQ(ElemId(3), read->elems()(0)->getId());
+    EXPECT_EQ(ElemId(5), read->elems()(1)->getId());
+    EXPECT_EQ(4, read->coords().size());
+    delete read;
+
+    read = reader.read(models_, LoadOptions(LoadOptions::grids));
+    EXPECT_EQ(0, read->coords().size());
+    EXPECT_EQ(0, read->layers().size());
+    EXPECT_EQ(0, read->elems().size());
+    EXPECT_EQ(mesh_->grid().getPos(),
+              read->castTo<Mesh::Geometric>()->grid().getPos());
+    delete read;
+    std::remove("binaryMeshSelective.smbmesh");
+}
@@ -21,15 +21,105 @@
 #include "gtest/gtest.h"
 
 #include "parser/json/Parser.h"
+#include "parser/json/Snapshot.h"
+#include "filesystem/Hash.h"
+#include "geometry/mesh/Checker.h"
 
 #include "geometry/element/Line2.h"
 #include "geometry/element/Triangle3.h"
 #include "geometry/element/Tetrahedron4.h"
 
+#include <cstdio>
+
+#ifdef OPENSEMBA_USE_ZLIB
+#include <zlib.h>
+#endif
+
 using namespace SEMBA;
 using namespace Parser::JSON;
 
 class ParserJSONParserTest : public ::testing::Test {
+protected:
+    // The grid and sources of the sphere project are replaced by ones in the
+    // current schema, so that a mesh is built.
+    static json getSphere() {
+        std::ifstream stream("testData/sphere.gid/sphere.dat");
+        EXPECT_TRUE(stream.is_open());
+        json j;
+        stream >> j;
+        j["grids"][0] = {
+                {"gridType", "gridCondition"},
+                {"type", "Number_of_cells"},
+                {"layerBox", "{1.8 1.8 1.8 -1.8 -1.8 -1.8}"},
+                {"numberOfCells", "{20 20 20}"}};
+        j["connectorOnPoint"] = json::array();
+        j["sources"] = json::array();
+        j["outputRequests"] = json::array();
+        return j;
+    }
+
+    static void expectEqual(const Data& lhs, const Data& rhs) {
+        ASSERT_EQ(lhs.mesh == nullptr, rhs.mesh == nullptr);
+        EXPECT_EQ(lhs.physicalModels->size(), rhs.physicalModels->size());
+        EXPECT_EQ(lhs.sources->size(), rhs.sources->size());
+        EXPECT_EQ(lhs.outputRequests->size(), rhs.outputRequests->size());
+        if (lhs.mesh == nullptr) {
+            return;
+        }
+        const Geometry::Mesh::Geometric* lMesh =
+                lhs.mesh->castTo<Geometry::Mesh::Geometric>();
+        const Geometry::Mesh::Geometric* rMesh =
+                rhs.mesh->castTo<Geometry::Mesh::Geometric>();
+        ASSERT_EQ(lMesh->coords().size(), rMesh->coords().size());
+        for (std::size_t i = 0; i < lMesh->coords().size(); i++) {
+            EXPECT_EQ(lMesh->coords()(i)->getId(),
+                      rMesh->coords()(i)->getId());
+            EXPECT_EQ(lMesh->coords()(i)->pos(), rMesh->coords()(i)->pos());
+        }
+        ASSERT_EQ(lMesh->elems().size(), rMesh->elems().size());
+        for (std::size_t i = 0; i < lMesh->elems().size(); i++) {
+            const Geometry::ElemR* lElem = lMesh->elems()(i);
+            const Geometry::ElemR* rElem = rMesh->elems()(i);
+            EXPECT_EQ(lElem->getId(), rElem->getId());
+            EXPECT_EQ(lElem->getMatId(), rElem->getMatId());
+            EXPECT_EQ(lElem->getLayerId(), rElem->getLayerId());
+            ASSERT_EQ(lElem->numberOfVertices(), rElem->numberOfVertices());
+            for (std::size_t v = 0; v < lElem->numberOfVertices(); v++) {
+                EXPECT_EQ(lElem->getVertex(v)->getId(),
+                          rElem->getVertex(v)->getId());
+            }
+        }
+    }
+
+    // Values as the GiD template prints them: perLine values to a line,
+    // separated by commas, with a comma after all lines but the last.
+    static std::string printArray(const std::vector<std::string>& values,
+                                  const std::size_t perLine,
+                                  const std::string& indent) {
+        std::string res = "[\n";
+        for (std::size_t i = 0; i < values.size(); i++) {
+            if (i % perLine == 0) {
+                res += indent;
+            }
+            res += values[i];
+            if (i + 1 < values.size()) {
+                res += (i % perLine == perLine - 1) ? ",\n" : ", ";
+            }
+        }
+        return res + "\n" + indent.substr(4) + "]";
+    }
+
+    static std::string format(const char* fmt, const double value) {
+        char res[32];
+        std::snprintf(res, sizeof(res), fmt, value);
+        return res;
+    }
+
+    static std::string format(const char* fmt, const std::size_t value) {
+        char res[32];
+        std::snprintf(res, sizeof(res), fmt, static_cast<int>(value));
+        return res;
+    }
 };
 
 TEST_F(ParserJSONParserTest, Basic) {
@@ -84,3 +174,378 @@ TEST_F(ParserJSONParserTest, Wires) {
     EXPECT_NO_THROW(jsonParser.read(stream));
 }
 
+
+TEST_F(ParserJSONParserTest, Streaming) {
+    const std::string projects[] = {
+            "testData/cartesian.gid/cartesian.dat",
+            "testData/dmcwf.gid/dmcwf.dat",
+            "testData/planewave.gid/planewave.dat",
+            "testData/sphere.gid/sphere.dat",
+            "testData/wires.gid/wires.dat"};
+
+    SEMBA::Parser::JSON::Parser jsonParser;
+    for (std::size_t p = 0; p < 5; p++) {
+        std::ifstream domStream(projects[p].c_str());
+        std::ifstream saxStream(projects[p].c_str());
+        ASSERT_TRUE(saxStream.is_open());
+        Data dom = jsonParser.read(domStream);
+        Data sax = jsonParser.readStreaming(saxStream);
+        expectEqual(dom, sax);
+    }
+}
+
+TEST_F(ParserJSONParserTest, StreamingMesh) {
+    // Dumping the whole object sorts its keys, which places the elements
+    // before the layers and materials they refer to.
+    const json j = getSphere();
+    const char* keys[] = {"_version", "solverOptions", "materials", "grids",
+            "layers", "coordinates", "elements", "connectorOnPoint",
+            "sources", "outputRequests"};
+    std::string inFileOrder = "{";
+    for (std::size_t k = 0; k < 10; k++) {
+        inFileOrder += (k > 0 ? ",\n\"" : "\"") + std::string(keys[k]) +
+                       "\": " + j.at(keys[k]).dump(4);
+    }
+    inFileOrder += "}";
+
+    SEMBA::Parser::JSON::Parser jsonParser;
+    std::istringstream domStream(j.dump());
+    Data dom = jsonParser.read(domStream);
+    ASSERT_NE(nullptr, dom.mesh);
+    EXPECT_LT(0, dom.mesh->castTo<Geometry::Mesh::Geometric>()->elems().size());
+
+    std::istringstream sortedStream(j.dump());
+    expectEqual(dom, jsonParser.readStreaming(sortedStream));
+    std::istringstream fileOrderStream(inFileOrder);
+    expectEqual(dom, jsonParser.readStreaming(fileOrderStream));
+}
+
+TEST_F(ParserJSONParserTest, SphereOrientation) {
+    std::istringstream stream(getSphere().dump());
+    SEMBA::Parser::JSON::Parser jsonParser;
+    Data data = jsonParser.read(stream);
+    ASSERT_NE(nullptr, data.mesh);
+    const Geometry::Mesh::Geometric* mesh =
+            data.mesh->castTo<Geometry::Mesh::Geometric>();
+    ASSERT_EQ(234, mesh->elems().getOf<Geometry::Tet4>().size());
+
+    Geometry::Mesh::Checker::Report report =
+            Geometry::Mesh::Checker().check(*mesh);
+    EXPECT_EQ(0, report.count(Geometry::Mesh::Checker::inverted));
+    EXPECT_EQ(0, report.count(Geometry::Mesh::Checker::degenerate));
+}
+
+TEST_F(ParserJSONParserTest, StreamingSyntaxError) {
+    std::istringstream stream(
+            "{\n"
+            "   \"_version\": \"" OPENSEMBA_VERSION "\",\n"
+            "   \"coordinates\": [ \"1 0 0 0\" \"2 0 0 1\" ]\n"
+            "}"
+    );
+
+    SEMBA::Parser::JSON::Parser jsonParser;
+    try {
+        jsonParser.readStreaming(stream);
+        FAIL();
+    } catch (const std::logic_error& e) {
+        EXPECT_NE(std::string::npos, std::string(e.what()).find("line 3"));
+    }
+}
+
+TEST_F(ParserJSONParserTest, Cached) {
+    // The grid is read from a file so that changing it invalidates the
+    // snapshot of an unchanged project.
+    json j = getSphere();
+    j["grids"][0] = {
+            {"gridType", "positionsFromFile"},
+            {"filename", "parserCachedGrid.json"}};
+    std::ofstream("parserCachedGrid.json") <<
+            "\"xs\": [-2, 0, 2], \"ys\": [-2, 2], \"zs\": [-2, 2]";
+    std::ofstream("parserCached.dat") << j.dump();
+    const std::string snapshotName = "parserCache/" +
+            FileSystem::hashToStr(FileSystem::hashFile("parserCached.dat")) +
+            ".smbsnap";
+
+    SEMBA::Parser::JSON::Parser jsonParser;
+    std::istringstream domStream(j.dump());
+    Data dom = jsonParser.read(domStream);
+    ASSERT_NE(nullptr, dom.mesh);
+    expectEqual(dom, jsonParser.readCached("parserCached.dat",
+                                           "parserCache"));
+    {
+        const SEMBA::Parser::JSON::Snapshot snapshot(snapshotName);
+        EXPECT_EQ(FileSystem::hashFile("parserCached.dat"),
+                  snapshot.getKey());
+        EXPECT_TRUE(snapshot.hasMesh());
+        ASSERT_EQ(1, snapshot.getDependencies().size());
+        EXPECT_TRUE(snapshot.isUpToDate());
+    }
+    Data cached = jsonParser.readCached("parserCached.dat", "parserCache");
+    expectEqual(dom, cached);
+    EXPECT_EQ(3, cached.mesh->castTo<Geometry::Mesh::Geometric>()->
+                     grid().getPos(0).size());
+
+    std::ofstream("parserCachedGrid.json") <<
+            "\"xs\": [-2, -1, 0, 2], \"ys\": [-2, 2], \"zs\": [-2, 2]";
+    EXPECT_FALSE(SEMBA::Parser::JSON::Snapshot(snapshotName).isUpToDate());
+    Data changed = jsonParser.readCached("parserCached.dat", "parserCache");
+    EXPECT_EQ(4, changed.mesh->castTo<Geometry::Mesh::Geometric>()->
+                     grid().getPos(0).size());
+    EXPECT_TRUE(SEMBA::Parser::JSON::Snapshot(snapshotName).isUpToDate());
+
+    std::remove(snapshotName.c_str());
+    std::remove("parserCache");
+    std::remove("parserCached.dat");
+    std::remove("parserCachedGrid.json");
+}
+
+TEST_F(ParserJSONParserTest, Selective) {
+    const std::string project = getSphere().dump();
+    SEMBA::Parser::JSON::Parser fullParser;
+    std::istringstream fullStream(project);
+    Data full = fullParser.read(fullStream);
+    ASSERT_NE(nullptr, full.mesh);
+    const Geometry::Mesh::Geometric* fullMesh =
+            full.mesh->castTo<Geometry::Mesh::Geometric>();
+
+    SEMBA::Parser::LoadOptions noElems(
+            SEMBA::Parser::LoadOptions::allSections &
+            ~SEMBA::Parser::LoadOptions::elements);
+    std::istringstream noElemsStream(project);
+    Data setup = SEMBA::Parser::JSON::Parser(noElems).read(noElemsStream);
+    ASSERT_NE(nullptr, setup.mesh);
+    const Geometry::Mesh::Geometric* setupMesh =
+            setup.mesh->castTo<Geometry::Mesh::Geometric>();
+    EXPECT_EQ(fullMesh->grid().getPos(), setupMesh->grid().getPos());
+    EXPECT_EQ(fullMesh->coords().size(), setupMesh->coords().size());
+    EXPECT_EQ(fullMesh->layers().size(), setupMesh->layers().size());
+    EXPECT_EQ(0, setupMesh->elems().size());
+    EXPECT_EQ(full.physicalModels->size(), setup.physicalModels->size());
+    EXPECT_NE(nullptr, setup.solver);
+
+    SEMBA::Parser::LoadOptions models(
+            SEMBA::Parser::LoadOptions::materials |
+            SEMBA::Parser::LoadOptions::outputRequests);
+    std::istringstream modelsStream(project);
+    Data modelsOnly = SEMBA::Parser::JSON::Parser(models).read(modelsStream);
+    EXPECT_EQ(nullptr, modelsOnly.mesh);
+    EXPECT_EQ(nullptr, modelsOnly.solver);
+    EXPECT_EQ(full.physicalModels->size(), modelsOnly.physicalModels->size());
+    EXPECT_EQ(0, modelsOnly.outputRequests->size());
+
+    SEMBA::Parser::LoadOptions layer;
+    layer.setLayers({5});
+    std::istringstream layerStream(project);
+    Data surface = SEMBA::Parser::JSON::Parser(layer).read(layerStream);
+    ASSERT_NE(nullptr, surface.mesh);
+    const Geometry::Mesh::Geometric* surfaceMesh =
+            surface.mesh->castTo<Geometry::Mesh::Geometric>();
+    ASSERT_EQ(2, surfaceMesh->elems().size());
+    EXPECT_EQ(Geometry::ElemId(235), surfaceMesh->elems()(0)->getId());
+    EXPECT_EQ(Geometry::LayerId(5), surfaceMesh->elems()(1)->getLayerId());
+
+    std::ofstream("parserSelective.dat") << project;
+    fullParser.readCached("parserSelective.dat", "parserSelectiveCache");
+    Data cached = SEMBA::Parser::JSON::Parser(layer).readCached(
+            "parserSelective.dat", "parserSelectiveCache");
+    expectEqual(surface, cached);
+    std::remove(("parserSelectiveCache/" +
+            FileSystem::hashToStr(FileSystem::hashFile("parserSelective.dat")) +
+            ".smbsnap").c_str());
+    std::remove("parserSelectiveCache");
+    std::remove("parserSelective.dat");
+}
+
+TEST_F(ParserJSONParserTest, FlatSchema) {
+    // The records of the sphere are rewritten as parallel arrays of numbers.
+    json j = getSphere();
+    json coords = {{"ids", json::array()}, {"positions", json::array()}};
+    for (const json& record : j.at("coordinates")) {
+        std::istringstream values(record.get<std::string>());
+        std::size_t id;
+        double pos[3];
+        values >> id >> pos[0] >> pos[1] >> pos[2];
+        coords["ids"].push_back(id);
+        for (std::size_t d = 0; d < 3; d++) {
+            coords["positions"].push_back(pos[d]);
+        }
+    }
+    const std::size_t numVertices[] = {8, 4, 4, 3, 2};
+    const char* types[] = {
+            "hexahedra", "tetrahedra", "quadrilateral", "triangle", "line"};
+    json elems;
+    for (std::size_t t = 0; t < 5; t++) {
+        json& flat = elems[types[t]];
+        flat = {{"ids", json::array()}, {"materials", json::array()},
+                {"layers", json::array()}, {"vertices", json::array()}};
+        for (const json& record : j.at("elements").at(types[t])) {
+            std::istringstream values(record.get<std::string>());
+            std::size_t value;
+            values >> value;
+            flat["ids"].push_back(value);
+            values >> value;
+            flat["materials"].push_back(value);
+            values >> value;
+            flat["layers"].push_back(value);
+            for (std::size_t v = 0; v < numVertices[t]; v++) {
+                values >> value;
+                flat["vertices"].push_back(value);
+            }
+        }
+    }
+    json flat = j;
+    flat["coordinates"] = coords;
+    flat["elements"] = elems;
+    EXPECT_LT(flat.dump().size(), j.dump().size());
+
+    SEMBA::Parser::JSON::Parser jsonParser;
+    std::istringstream stringsStream(j.dump());
+    Data strings = jsonParser.read(stringsStream);
+    ASSERT_NE(nullptr, strings.mesh);
+    std::istringstream flatStream(flat.dump());
+    expectEqual(strings, jsonParser.read(flatStream));
+    std::istringstream streamingStream(flat.dump());
+    expectEqual(strings, jsonParser.readStreaming(streamingStream));
+
+    // Values of other kinds fail as in the DOM, even when no number is left.
+    json wrongKinds = flat;
+    for (json& value : wrongKinds["coordinates"]["ids"]) {
+        value = value.dump();
+    }
+    for (json& value : wrongKinds["coordinates"]["positions"]) {
+        value = nullptr;
+    }
+    for (std::size_t t = 0; t < 5; t++) {
+        for (json::iterator it = wrongKinds["elements"][types[t]].begin();
+             it != wrongKinds["elements"][types[t]].end(); ++it) {
+            for (json& value : it.value()) {
+                value = true;
+            }
+        }
+    }
+    std::istringstream wrongKindsDom(wrongKinds.dump());
+    EXPECT_EQ(nullptr, jsonParser.read(wrongKindsDom).mesh);
+    std::istringstream wrongKindsStream(wrongKinds.dump());
+    EXPECT_EQ(nullptr, jsonParser.readStreaming(wrongKindsStream).mesh);
+    flat["elements"]["line"]["ids"].push_back("1");
+    std::istringstream wrongStringStream(flat.dump());
+    EXPECT_EQ(nullptr, jsonParser.readStreaming(wrongStringStream).mesh);
+    flat["elements"]["line"]["ids"].erase(
+            flat["elements"]["line"]["ids"].size() - 1);
+
+    flat["elements"]["triangle"]["layers"].push_back(5);
+    std::istringstream wrongStream(flat.dump());
+    EXPECT_EQ(nullptr, jsonParser.readStreaming(wrongStream).mesh);
+}
+
+TEST_F(ParserJSONParserTest, FlatTemplate) {
+    // The sphere printed with the number formats of semba.bas.
+    json j = getSphere();
+    std::vector<std::string> ids, positions;
+    bool positive = false;
+    for (const json& record : j.at("coordinates")) {
+        std::istringstream values(record.get<std::string>());
+        std::size_t id;
+        double pos[3];
+        values >> id >> pos[0] >> pos[1] >> pos[2];
+        ids.push_back(format("%7i", id));
+        for (std::size_t d = 0; d < 3; d++) {
+            positions.push_back(format("%14.8e", pos[d]));
+            positive |= pos[d] > 0.0;
+        }
+    }
+    EXPECT_TRUE(positive);
+    std::string coords =
+            "{\n        \"ids\": " + printArray(ids, 1, "            ") +
+            ",\n        \"positions\": " +
+            printArray(positions, 3, "            ") + "\n    }";
+
+    const std::size_t numVertices[] = {8, 4, 4, 3, 2};
+    const char* types[] = {
+            "hexahedra", "tetrahedra", "quadrilateral", "triangle", "line"};
+    std::string elems = "{\n";
+    for (std::size_t t = 0; t < 5; t++) {
+        std::vector<std::string> elemIds, mats, layers, vertices;
+        for (const json& record : j.at("elements").at(types[t])) {
+            std::istringstream values(record.get<std::string>());
+            std::size_t value;
+            values >> value;
+            elemIds.push_back(format("%8i", value));
+            values >> value;
+            mats.push_back(format("%3i", value));
+            values >> value;
+            layers.push_back(format("%3i", value));
+            for (std::size_t v = 0; v < numVertices[t]; v++) {
+                values >> value;
+                vertices.push_back(format("%7i", value));
+            }
+        }
+        const std::string indent = "                ";
+        elems += std::string("        \"") + types[t] + "\": {\n" +
+                "            \"ids\": " + printArray(elemIds, 1, indent) +
+                ",\n            \"materials\": " +
+                printArray(mats, 1, indent) +
+                ",\n            \"layers\": " +
+                printArray(layers, 1, indent) +
+                ",\n            \"vertices\": " +
+                printArray(vertices, numVertices[t], indent) +
+                "\n        }" + (t < 4 ? ",\n" : "\n");
+    }
+    elems += "    }";
+
+    json rest = j;
+    rest.erase("coordinates");
+    rest.erase("elements");
+    std::string project = rest.dump(4);
+    project.erase(project.rfind('}'));
+    project += ",\n    \"coordinates\": " + coords +
+               ",\n    \"elements\": " + elems + "\n}\n";
+
+    SEMBA::Parser::JSON::Parser jsonParser;
+    std::istringstream stringsStream(j.dump());
+    Data strings = jsonParser.read(stringsStream);
+    ASSERT_NE(nullptr, strings.mesh);
+    std::istringstream domStream(project);
+    expectEqual(strings, jsonParser.read(domStream));
+    std::istringstream streamingStream(project);
+    expectEqual(strings, jsonParser.readStreaming(streamingStream));
+}
+
+#ifdef OPENSEMBA_USE_ZLIB
+TEST_F(ParserJSONParserTest, Compressed) {
+    // Both the project and the grid it refers to are gzip compressed.
+    json j = getSphere();
+    j["grids"][0] = {
+            {"gridType", "positionsFromFile"},
+            {"filename", "parserCompressedGrid.json.gz"}};
+    const std::string grid =
+            "\"xs\": [-2, 0, 2], \"ys\": [-2, 2], \"zs\": [-2, 2]";
+    const std::string project = j.dump();
+    gzFile file = gzopen("parserCompressedGrid.json.gz", "wb");
+    gzwrite(file, grid.data(), static_cast<unsigned>(grid.size()));
+    gzclose(file);
+    file = gzopen("parserCompressed.dat.gz", "wb");
+    gzwrite(file, project.data(), static_cast<unsigned>(project.size()));
+    gzclose(file);
+
+    SEMBA::Parser::JSON::Parser jsonParser;
+    std::istringstream domStream(project);
+    Data dom = jsonParser.read(domStream);
+    ASSERT_NE(nullptr, dom.mesh);
+    EXPECT_EQ(3, dom.mesh->castTo<Geometry::Mesh::Geometric>()->
+                     grid().getPos(0).size());
+    expectEqual(dom, jsonParser.readFile("parserCompressed.dat.gz"));
+    expectEqual(dom, jsonParser.readCached("parserCompressed.dat.gz",
+                                           "parserCompressedCache"));
+    expectEqual(dom, jsonParser.readCached("parserCompressed.dat.gz",
+                                           "parserCompressedCache"));
+
+    std::remove(("parserCompressedCache/" +
+            FileSystem::hashToStr(
+                    FileSystem::hashFile("parserCompressed.dat.gz")) +
+            ".smbsnap").c_str());
+    std::remove("parserCompressedCache");
+    std::remove("parserCompressed.dat.gz");
+    std::remove("parserCompressedGrid.json.gz");
+}
+#endif
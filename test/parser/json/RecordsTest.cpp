@@ -0,0 +1,157 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+
+#include "gtest/gtest.h"
+
+#include "parser/json/Records.h"
+
+using namespace SEMBA;
+using namespace Parser::JSON;
+
+class ParserJSONRecordsTest : public ::testing::Test {
+protected:
+    static std::string getError(const nlohmann::json& records,
+                                const std::size_t numVertices) {
+        try {
+            ElementRecords elems(numVertices, records);
+        } catch (const std::logic_error& e) {
+            return e.what();
+        }
+        return std::string();
+    }
+};
+
+TEST_F(ParserJSONRecordsTest, Coordinates) {
+    const CoordinateRecords coords(nlohmann::json::array({
+            "      1  -1.50000000e+00  +5.00000000e-01  -1.50000000e+00",
+            "7 0 0.25 1e3"}));
+    ASSERT_EQ(2, coords.size());
+    EXPECT_EQ(1, coords.ids[0]);
+    EXPECT_EQ(7, coords.ids[1]);
+    ASSERT_EQ(6, coords.pos.size());
+    EXPECT_EQ(-1.5, coords.pos[0]);
+    EXPECT_EQ(0.5, coords.pos[1]);
+    EXPECT_EQ(0.25, coords.pos[4]);
+    EXPECT_EQ(1000.0, coords.pos[5]);
+
+    EXPECT_THROW(CoordinateRecords(nlohmann::json::array({"1 0 0"})),
+                 std::logic_error);
+    EXPECT_THROW(CoordinateRecords(nlohmann::json::array({"1 0 0 0 0"})),
+                 std::logic_error);
+}
+
+TEST_F(ParserJSONRecordsTest, Elements) {
+    const ElementRecords elems(3, nlohmann::json::array({
+            "    1880    1    5      245      250      254",
+            "2 0 0 1 2 3"}));
+    ASSERT_EQ(2, elems.size());
+    EXPECT_EQ(1880, elems.ids[0]);
+    EXPECT_EQ(1, elems.mats[0]);
+    EXPECT_EQ(5, elems.layers[0]);
+    ASSERT_EQ(6, elems.vertices.size());
+    EXPECT_EQ(254, elems.vertices[2]);
+    EXPECT_EQ(3, elems.vertices[5]);
+}
+
+TEST_F(ParserJSONRecordsTest, ErrorContext) {
+    const std::string error =
+            getError(nlohmann::json::array({"1 0 0 1 2", "2 0 0 1 x"}), 2);
+    EXPECT_NE(std::string::npos, error.find("record 1"));
+    EXPECT_NE(std::string::npos, error.find("\"2 0 0 1 x\""));
+    EXPECT_NE(std::string::npos, error.find("coordinate id at column 9"));
+
+    EXPECT_NE(std::string::npos,
+              getError(nlohmann::json::array({"1 a 0 1 2"}), 2).find(
+                      "material id at column 3"));
+}
+
+TEST_F(ParserJSONRecordsTest, Chunks) {
+    nlohmann::json json = nlohmann::json::array();
+    std::vector<std::string> strs;
+    for (std::size_t i = 0; i < 10000; i++) {
+        strs.push_back(std::to_string(i+1) + " 0 " + std::to_string(i % 7) +
+                       " " + std::to_string(2*i) + " " + std::to_string(i));
+        json.push_back(strs.back());
+    }
+
+    ElementRecords serial(2);
+    for (std::size_t i = 0; i < strs.size(); i++) {
+        serial.add(strs[i]);
+    }
+    const ElementRecords fromJson(2, json);
+    ElementRecords fromBatches(2);
+    fromBatches.add(std::vector<std::string>(strs.begin(),
+                                             strs.begin() + 4500));
+    fromBatches.add(std::vector<std::string>(strs.begin() + 4500,
+                                             strs.end()));
+    EXPECT_EQ(serial.ids, fromJson.ids);
+    EXPECT_EQ(serial.layers, fromJson.layers);
+    EXPECT_EQ(serial.vertices, fromJson.vertices);
+    EXPECT_EQ(serial.ids, fromBatches.ids);
+    EXPECT_EQ(serial.vertices, fromBatches.vertices);
+
+    json[9000] = "9001 0 0 x 1";
+    json[5000] = "5001 0 0 1 y";
+    EXPECT_NE(std::string::npos, getError(json, 2).find("record 5000 "));
+
+    strs[9000] = "9001 0 0 x 1";
+    ElementRecords secondBatch(2);
+    secondBatch.add(std::vector<std::string>(strs.begin(),
+                                             strs.begin() + 4500));
+    try {
+        secondBatch.add(std::vector<std::string>(strs.begin() + 4500,
+                                                 strs.end()));
+        FAIL();
+    } catch (const std::logic_error& e) {
+        EXPECT_NE(std::string::npos,
+                  std::string(e.what()).find("record 9000 "));
+    }
+    EXPECT_EQ(4500, secondBatch.size());
+}
+
+TEST_F(ParserJSONRecordsTest, Flat) {
+    const CoordinateRecords coords(nlohmann::json::parse(
+            "{\"ids\": [1, 7], \"positions\": [-1.5, 0.5, -1.5, 0, 0.25, 1e3]}"));
+    ASSERT_EQ(2, coords.size());
+    EXPECT_EQ(7, coords.ids[1]);
+    EXPECT_EQ(0.0, coords.pos[3]);
+    EXPECT_EQ(1000.0, coords.pos[5]);
+
+    const ElementRecords elems(2, nlohmann::json::parse(
+            "{\"ids\": [4, 5], \"materials\": [1, 0], \"layers\": [2, 2],"
+            " \"vertices\": [1, 7, 7, 1]}"));
+    ASSERT_EQ(2, elems.size());
+    EXPECT_EQ(5, elems.ids[1]);
+    EXPECT_EQ(0, elems.mats[1]);
+    EXPECT_EQ(7, elems.vertices[2]);
+
+    EXPECT_THROW(CoordinateRecords(nlohmann::json::parse(
+            "{\"ids\": [1], \"positions\": [0, 0]}")), std::logic_error);
+    EXPECT_THROW(CoordinateRecords(nlohmann::json::parse(
+            "{\"ids\": [1]}")), std::exception);
+    EXPECT_EQ("Element ids value 1 -5 is not an unsigned integer.",
+              getError(nlohmann::json::parse(
+                      "{\"ids\": [4, -5], \"materials\": [1, 0],"
+                      " \"layers\": [2, 2], \"vertices\": [1, 7]}"), 1));
+    EXPECT_NE(std::string(), getError(nlohmann::json::parse(
+            "{\"ids\": [4], \"materials\": [1], \"layers\": [2],"
+            " \"vertices\": [1, 7, 8]}"), 2));
+}
@@ -0,0 +1,118 @@
+// OpenSEMBA
+// Copyright (C) 2015 Salvador Gonzalez Garcia        (salva@ugr.es)
+//                    Luis Manuel Diaz Angulo         (lmdiazangulo@semba.guru)
+//                    Miguel David Ruiz-Cabello Nuñez (miguel@semba.guru)
+//                    Daniel Mateos Romero            (damarro@semba.guru)
+//
+// This file is part of OpenSEMBA.
+//
+// OpenSEMBA is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// OpenSEMBA is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with OpenSEMBA. If not, see <http://www.gnu.org/licenses/>.
+#include "gtest/gtest.h"
+
+#include <clocale>
+#include <sstream>
+
+#include "parser/json/Sax.h"
+
+using namespace SEMBA;
+using namespace Parser::JSON;
+
+class ParserJSONSaxTest : public ::testing::Test {
+protected:
+    static nlohmann::json parse(const std::string& str) {
+        std::istringstream stream(str);
+        SaxDom dom;
+        Sax(stream).parse(dom);
+        EXPECT_TRUE(dom.isDone());
+        return dom.get();
+    }
+
+    // Skips the values of the keys starting with "skip".
+    class SkippingDom : public SaxDom {
+    public:
+        void key(const std::string& key) {
+            skip_ = (key.compare(0, 4, "skip") == 0);
+            SaxDom::key(key);
+        }
+        bool skipValue() const { return skip_; }
+    private:
+        bool skip_ = false;
+    };
+};
+
+TEST_F(ParserJSONSaxTest, SameAsDom) {
+    const std::string str =
+            "{ \"a\": [1, -2, 3.5e2, true, false, null, {}, []],\n"
+            "  \"b\": { \"c\": \"x\\\"y\\\\z\\u00e9\\ud83d\\ude00\" },\n"
+            "  \"d\": [[[\"e\"]], {\"f\": {\"g\": 18446744073709551615}}] }";
+    EXPECT_EQ(nlohmann::json::parse(str), parse(str));
+    EXPECT_EQ(nlohmann::json::parse("[]"), parse(" [ ] "));
+    EXPECT_EQ(nlohmann::json::parse("\"s\""), parse("\"s\""));
+}
+
+TEST_F(ParserJSONSaxTest, Errors) {
+    EXPECT_THROW(parse(""), std::logic_error);
+    EXPECT_THROW(parse("{\"a\" 1}"), std::logic_error);
+    EXPECT_THROW(parse("[1,]"), std::logic_error);
+    EXPECT_THROW(parse("[1 2]"), std::logic_error);
+    EXPECT_THROW(parse("{\"a\": [1}"), std::logic_error);
+    EXPECT_THROW(parse("[\"unterminated]"), std::logic_error);
+    EXPECT_THROW(parse("[tru]"), std::logic_error);
+    EXPECT_THROW(parse("[1] 2"), std::logic_error);
+    EXPECT_THROW(parse("[-]"), std::logic_error);
+    const char* numbers[] = {"01", "1.", ".5", "+1", "1e", "1e+", "-.5",
+                             "1.5.2", "1e5e5", "1-2", "--1", "0x10"};
+    for (std::size_t i = 0; i < sizeof(numbers)/sizeof(numbers[0]); i++) {
+        EXPECT_THROW(parse(std::string("[") + numbers[i] + "]"),
+                     std::logic_error) << numbers[i];
+    }
+}
+
+TEST_F(ParserJSONSaxTest, CommaLocale) {
+    const std::string str =
+            "[0.5, -1.25e-3, 3.141592653589793238, 1E+200, -0.0, 7]";
+    const nlohmann::json expected = nlohmann::json::parse(str);
+
+    const std::string previous = std::setlocale(LC_NUMERIC, nullptr);
+    const char* locales[] = {"de_DE.UTF-8", "de_DE.utf8", "de_DE",
+                             "es_ES.UTF-8", "fr_FR.UTF-8"};
+    bool found = false;
+    for (std::size_t i = 0; i < 5 && !found; i++) {
+        found = (std::setlocale(LC_NUMERIC, locales[i]) != nullptr);
+    }
+    if (!found) {
+        GTEST_SKIP() << "No locale with a decimal comma is installed.";
+    }
+    EXPECT_EQ(expected, parse(str));
+    EXPECT_EQ(expected[0], SaxDom::toNumber("0.5"));
+    std::setlocale(LC_NUMERIC, previous.c_str());
+}
+
+TEST_F(ParserJSONSaxTest, Skip) {
+    std::istringstream stream(
+            "{ \"a\": 1,\n"
+            "  \"skipA\": [\"]}\\\"[\", {\"b\": [[], {}]}, 2],\n"
+            "  \"c\": { \"skipB\": \"x\", \"skipC\": -1.5e3,\n"
+            "           \"skipD\": null, \"d\": true },\n"
+            "  \"skipE\": {} }");
+    SkippingDom dom;
+    Sax(stream).parse(dom);
+    EXPECT_TRUE(dom.isDone());
+    EXPECT_EQ(nlohmann::json::parse("{\"a\": 1, \"c\": {\"d\": true}}"),
+              dom.get());
+
+    std::istringstream unterminated("{ \"skip\": [1, [2] }");
+    SkippingDom other;
+    EXPECT_THROW(Sax(unterminated).parse(other), std::logic_error);
+}
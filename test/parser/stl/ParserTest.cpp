@@ -24,6 +24,15 @@
 #include "parser/stl/Parser.h"
 #include "exporter/vtk/Exporter.h"
 
+#include <algorithm>
+#include <cstdio>
+#include <iterator>
+#include <sstream>
+
+#ifdef OPENSEMBA_USE_ZLIB
+#include <zlib.h>
+#endif
+
 using namespace std;
 using namespace SEMBA;
 
@@ -72,7 +81,134 @@ TEST_F(ParserSTLParserTest, case_B2) {
     Geometry::Mesh::Geometric* mesh =
             smb.mesh->castTo<Geometry::Mesh::Geometric>();
     if (smb.mesh != nullptr) {
-        EXPECT_EQ(1956, mesh->coords().size());
+        EXPECT_EQ(345, mesh->coords().size());
         EXPECT_EQ(652, mesh->elems().getOf<Geometry::Tri3>().size());
     }
 }
+
+TEST_F(ParserSTLParserTest, case_chunks) {
+    // A square grid of n x n cells split in two solids, large enough to be
+    // read in several chunks, and in several batches when streamed.
+    const size_t n = 150;
+    ostringstream stl;
+    for (size_t s = 0; s < 2; s++) {
+        stl << "solid half" << s << "\n";
+        for (size_t i = s*n/2; i < (s+1)*n/2; i++) {
+            for (size_t j = 0; j < n; j++) {
+                const size_t x[4][2] =
+                        {{i, j}, {i+1, j}, {i+1, j+1}, {i, j+1}};
+                for (size_t t = 0; t < 2; t++) {
+                    stl << "  facet normal 0 0 1\n    outer loop\n";
+                    for (size_t v = 0; v < 3; v++) {
+                        const size_t* p = x[(2*t + v) % 4];
+                        stl << "      vertex " << 0.1*p[0] << " "
+                            << 0.1*p[1] << " 1.0e-1\n";
+                    }
+                    stl << "    endloop\n  endfacet\n";
+                }
+            }
+        }
+        stl << "endsolid half" << s << "\n";
+    }
+    ASSERT_GT(stl.str().size(), 5u << 20);
+    ofstream("parserSTLChunks.stl") << stl.str();
+
+    Parser::STL::Parser parser;
+    Data smb = parser.readFile("parserSTLChunks.stl");
+    remove("parserSTLChunks.stl");
+    Geometry::Mesh::Geometric* mesh =
+            smb.mesh->castTo<Geometry::Mesh::Geometric>();
+    EXPECT_EQ((n+1)*(n+1), mesh->coords().size());
+    ASSERT_EQ(2*n*n, mesh->elems().getOf<Geometry::Tri3>().size());
+    ASSERT_EQ(2, mesh->layers().size());
+    EXPECT_EQ("half0", mesh->layers()(0)->getName());
+    EXPECT_EQ("half1", mesh->layers()(1)->getName());
+    for (size_t e = 0; e < mesh->elems().size(); e++) {
+        EXPECT_EQ(mesh->layers()(e < n*n ? 0 : 1),
+                  mesh->elems()(e)->getLayer());
+    }
+
+    istringstream input(stl.str());
+    Data streamed = parser.read(input);
+    Geometry::Mesh::Geometric* streamedMesh =
+            streamed.mesh->castTo<Geometry::Mesh::Geometric>();
+    EXPECT_EQ(mesh->coords().size(), streamedMesh->coords().size());
+    ASSERT_EQ(mesh->elems().size(), streamedMesh->elems().size());
+    ASSERT_EQ(2, streamedMesh->layers().size());
+    EXPECT_EQ("half1", streamedMesh->layers()(1)->getName());
+    for (size_t e = 0; e < mesh->elems().size(); e++) {
+        for (size_t v = 0; v < 3; v++) {
+            EXPECT_EQ(mesh->elems()(e)->getVertex(v)->pos(),
+                      streamedMesh->elems()(e)->getVertex(v)->pos());
+        }
+        EXPECT_EQ(streamedMesh->layers()(e < n*n ? 0 : 1),
+                  streamedMesh->elems()(e)->getLayer());
+    }
+
+    // Lines are counted across batches.
+    const string text = stl.str();
+    const size_t lines = count(text.begin(), text.end(), '\n');
+    istringstream wrong(text + "solid c\nfacet normal 0 0 1\nouter loop\n"
+                        "vertex 0 x 0\n");
+    try {
+        parser.read(wrong);
+        ADD_FAILURE() << "Wrong vertex was not detected.";
+    } catch (const logic_error& e) {
+        EXPECT_NE(string::npos, string(e.what()).find(
+                "at line " + to_string(lines + 4) + "."));
+    }
+}
+
+TEST_F(ParserSTLParserTest, case_weld) {
+    // The shared vertex is given twice, a tenth of the tolerance apart but
+    // on both sides of half a tolerance.
+    Parser::STL::Parser parser;
+    istringstream input("solid a\n"
+            "facet normal 0 0 1\nouter loop\n"
+            "vertex 0 0 0\nvertex 1 0 0\nvertex 0.500000000045 1 0\n"
+            "endloop\nendfacet\n"
+            "facet normal 0 0 1\nouter loop\n"
+            "vertex 1 0 0\nvertex 1 1 0\nvertex 0.500000000055 1 0\n"
+            "endloop\nendfacet\n"
+            "endsolid a\n");
+    Data smb = parser.read(input);
+    Geometry::Mesh::Geometric* mesh =
+            smb.mesh->castTo<Geometry::Mesh::Geometric>();
+    EXPECT_EQ(4, mesh->coords().size());
+    ASSERT_EQ(2, mesh->elems().size());
+    EXPECT_EQ(mesh->elems()(0)->getVertex(2),
+              mesh->elems()(1)->getVertex(2));
+}
+
+TEST_F(ParserSTLParserTest, case_malformed) {
+    Parser::STL::Parser parser;
+    istringstream missing("solid a\nfacet normal 0 0 1\nouter loop\n"
+                          "vertex 0 0 0\nvertex 1 0 0\nendloop\n");
+    EXPECT_THROW(parser.read(missing), logic_error);
+    istringstream wrong("solid a\nfacet normal 0 0 1\nouter loop\n"
+                        "vertex 0 0 0\nvertex 1 0 0\nvertex 0 x 0\n");
+    EXPECT_THROW(parser.read(wrong), logic_error);
+    EXPECT_THROW(parser.readFile("nofile.stl"), logic_error);
+}
+
+#ifdef OPENSEMBA_USE_ZLIB
+TEST_F(ParserSTLParserTest, case_B2_gzip) {
+    ifstream input(getCaseName("B2"));
+    const string contents((istreambuf_iterator<char>(input)),
+                          istreambuf_iterator<char>());
+    gzFile file = gzopen("parserSTLB2.stl.gz", "wb");
+    gzwrite(file, contents.data(), static_cast<unsigned>(contents.size()));
+    gzclose(file);
+
+    Parser::STL::Parser parser;
+    Data smb = parser.readFile("parserSTLB2.stl.gz");
+    std::remove("parserSTLB2.stl.gz");
+    ASSERT_TRUE(smb.mesh != nullptr);
+    Geometry::Mesh::Geometric* mesh =
+            smb.mesh->castTo<Geometry::Mesh::Geometric>();
+    EXPECT_EQ(345, mesh->coords().size());
+    EXPECT_EQ(652, mesh->elems().getOf<Geometry::Tri3>().size());
+
+    EXPECT_THROW(parser.readFile("parserSTLB2.stl.gz"), std::logic_error);
+}
+#endif